@@ -18,8 +18,9 @@ struct BenchmarkResults {
 BenchmarkResults run_benchmark(size_t num_orders, bool quick_mode = false) {
     EngineConfig config;
     config.max_orders = num_orders * 2;
-    config.ring_size = num_orders * 10;
+    config.ring_size = 4096;  // Cache-resident ring; bursts spill over
     config.tick_size = 0.01;
+    config.overflow_policy = OverflowPolicy::Spill;
     
     auto time_source = std::make_shared<SimulatedTimeSource>(1000000000);
     MatchingEngine engine(config, time_source);
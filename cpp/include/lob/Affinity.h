@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+namespace lob {
+
+// Thread/memory placement helpers. All functions are no-ops returning false
+// on platforms without affinity or NUMA support.
+
+// Number of CPUs configured on this machine
+[[nodiscard]] size_t cpu_count() noexcept;
+
+// NUMA node owning the given CPU, or -1 if unknown
+[[nodiscard]] int numa_node_of_cpu(int cpu) noexcept;
+
+// True if the CPU is listed in the kernel's isolated set (isolcpus=)
+[[nodiscard]] bool is_isolated_cpu(int cpu) noexcept;
+
+// Pin the calling thread to a single CPU. With require_isolated the call
+// fails unless the CPU is isolated from the general scheduler.
+[[nodiscard]] bool pin_current_thread(int cpu, bool require_isolated = false) noexcept;
+
+// Prefer allocations from the given NUMA node for the calling thread while
+// in scope; restores the thread's previous policy on destruction. Pages are placed
+// on first touch, so anything initialised inside the scope lands on node.
+class ScopedNumaPolicy {
+public:
+    explicit ScopedNumaPolicy(int node) noexcept;
+    ~ScopedNumaPolicy();
+
+    ScopedNumaPolicy(const ScopedNumaPolicy&) = delete;
+    ScopedNumaPolicy& operator=(const ScopedNumaPolicy&) = delete;
+
+    // Restore the previous policy early
+    void release() noexcept;
+
+    [[nodiscard]] bool active() const noexcept {
+        return active_;
+    }
+
+private:
+    bool active_;
+    int saved_mode_ = 0;
+    unsigned long saved_nodes_[16] = {};    // Up to 1024 nodes, the kernel's largest MAX_NUMNODES
+};
+
+} // namespace lob
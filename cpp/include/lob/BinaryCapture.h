@@ -0,0 +1,158 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Order.h"
+#include "Price.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lob {
+
+// Recorded message action
+enum class MDAction : uint8_t {
+    Add = 0,       // "ADD" / "SUBMIT"
+    Cancel = 1,    // "CANCEL"
+    Replace = 2,   // "REPLACE"
+    Trade = 3,     // "TRADE" (informational, not replayed)
+    Unknown = 255
+};
+
+[[nodiscard]] inline MDAction parse_md_action(std::string_view text) noexcept {
+    if (text == "ADD" || text == "SUBMIT") return MDAction::Add;
+    if (text == "CANCEL") return MDAction::Cancel;
+    if (text == "REPLACE") return MDAction::Replace;
+    if (text == "TRADE") return MDAction::Trade;
+    return MDAction::Unknown;
+}
+
+// Binary capture format (native little-endian, all sections 64-byte aligned):
+//   CaptureHeader | CaptureRecord[record_count] | symbol table
+// The symbol table is a sequence of (uint16 length, bytes) entries written
+// after the records so captures can be produced in one streaming pass.
+
+// Fixed-width on-disk message
+struct CaptureRecord {
+    uint64_t timestamp;     // Nanoseconds
+    uint64_t order_id;
+    int64_t price;          // Ticks at the header's tick scale
+    uint64_t qty;
+    uint32_t symbol;        // Index into the symbol table
+    MDAction action;
+    Side side;
+    OrderType order_type;
+    uint8_t reserved;
+};
+static_assert(sizeof(CaptureRecord) == 40, "CaptureRecord layout is part of the file format");
+
+struct CaptureHeader {
+    char magic[8];              // "LOBCAP01"
+    uint32_t byte_order;        // CAPTURE_BYTE_ORDER as written by the producer
+    uint32_t version;
+    uint32_t record_size;       // sizeof(CaptureRecord)
+    uint32_t symbol_count;
+    int64_t tick_units;         // TickScale::units
+    uint8_t tick_decimals;      // TickScale::decimals
+    uint8_t reserved[7];
+    uint64_t record_count;
+    uint64_t records_offset;
+    uint64_t symbols_offset;
+};
+static_assert(sizeof(CaptureHeader) == 64, "CaptureHeader layout is part of the file format");
+
+constexpr uint32_t CAPTURE_VERSION = 1;
+constexpr uint32_t CAPTURE_BYTE_ORDER = 0x01020304;
+
+// Streaming writer; symbols are interned as they are first seen
+class CaptureWriter {
+public:
+    CaptureWriter() = default;
+    ~CaptureWriter() { (void)close(); }
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    [[nodiscard]] bool open(const std::string& filename, const TickScale& scale);
+
+    // Id of a symbol, adding it to the table if new
+    [[nodiscard]] uint32_t symbol_id(std::string_view symbol);
+
+    [[nodiscard]] bool append(const CaptureRecord& record);
+
+    // Write the symbol table and finalize the header
+    [[nodiscard]] bool close();
+
+    [[nodiscard]] uint64_t record_count() const noexcept {
+        return header_.record_count;
+    }
+
+private:
+    static constexpr size_t kBufferRecords = 4096;
+
+    bool flush();
+
+    std::FILE* file_ = nullptr;
+    CaptureHeader header_{};
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, uint32_t> symbol_index_;
+    std::vector<CaptureRecord> buffer_;
+    bool ok_ = false;
+};
+
+// Zero-copy reader over a mapped capture
+class CaptureReader {
+public:
+    [[nodiscard]] bool open(const std::string& filename);
+
+    [[nodiscard]] const CaptureRecord* records() const noexcept {
+        return records_;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return count_;
+    }
+
+    [[nodiscard]] const CaptureRecord* begin() const noexcept {
+        return records_;
+    }
+
+    [[nodiscard]] const CaptureRecord* end() const noexcept {
+        return records_ + count_;
+    }
+
+    [[nodiscard]] const std::vector<std::string>& symbols() const noexcept {
+        return symbols_;
+    }
+
+    [[nodiscard]] TickScale tick_scale() const noexcept {
+        return scale_;
+    }
+
+private:
+    MappedFile file_;
+    const CaptureRecord* records_ = nullptr;
+    size_t count_ = 0;
+    std::vector<std::string> symbols_;
+    TickScale scale_;
+};
+
+struct CaptureConvertStats {
+    size_t rows = 0;        // Records written
+    size_t bad_rows = 0;    // Rows that failed to parse
+    size_t symbols = 0;
+};
+
+// Convert a replay CSV to a binary capture. Accepts the single-symbol layout
+// (timestamp,action,order_id,side,price,qty,order_type), whose records are
+// filed under default_symbol, and the multi-symbol layout with a symbol
+// column after the timestamp, detected from the header.
+[[nodiscard]] bool convert_csv_to_capture(const std::string& csv_file,
+                                          const std::string& capture_file,
+                                          const TickScale& scale,
+                                          const std::string& default_symbol = "",
+                                          CaptureConvertStats* stats = nullptr);
+
+} // namespace lob
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lob {
+
+// LZ77 block codec in the LZ4 family: byte-oriented sequences of
+// (token, literals, 16-bit offset, match length), no entropy stage, so
+// decoding is a tight copy loop. Each call codes one independent block.
+
+// Worst-case compressed size for n input bytes
+[[nodiscard]] constexpr size_t block_compress_bound(size_t n) noexcept {
+    return n + n / 255 + 16;
+}
+
+// Compress src into dst (capacity block_compress_bound(size)); returns the
+// compressed size
+size_t block_compress(const char* src, size_t size, char* dst);
+
+// Decompress exactly raw_size bytes; false if the input is malformed
+[[nodiscard]] bool block_decompress(const char* src, size_t size, char* dst, size_t raw_size) noexcept;
+
+// Compressed container layout:
+//   CompressedHeader | block payloads | CompressedBlock[block_count]
+// Blocks are fixed-size slices of the original file coded independently,
+// so they can be decoded in any order and on any thread. A block that
+// does not shrink is stored as is.
+
+struct CompressedHeader {
+    char magic[8];              // "LOBZBLK1"
+    uint32_t version;
+    uint32_t block_bytes;       // Uncompressed size of every block but the last
+    uint64_t raw_size;
+    uint64_t block_count;
+    uint64_t index_offset;
+    uint64_t reserved;
+};
+static_assert(sizeof(CompressedHeader) == 48, "CompressedHeader layout is part of the file format");
+
+struct CompressedBlock {
+    uint64_t offset;            // Payload position in the file
+    uint32_t stored_size;       // Payload bytes; == raw_size means stored uncompressed
+    uint32_t raw_size;
+};
+static_assert(sizeof(CompressedBlock) == 16, "CompressedBlock layout is part of the file format");
+
+constexpr uint32_t COMPRESSED_VERSION = 1;
+constexpr size_t DEFAULT_COMPRESSED_BLOCK = 1 << 20;
+
+struct CompressStats {
+    uint64_t raw_bytes = 0;
+    uint64_t stored_bytes = 0;  // Whole container, header and index included
+    size_t blocks = 0;
+};
+
+// Compress a file into the container; blocks are coded in parallel
+[[nodiscard]] bool compress_file(const std::string& input, const std::string& output,
+                                 size_t block_bytes = DEFAULT_COMPRESSED_BLOCK,
+                                 size_t threads = 0, CompressStats* stats = nullptr);
+
+// True if the bytes start with a compressed container header
+[[nodiscard]] bool is_compressed(const char* data, size_t size) noexcept;
+
+// Random access to the blocks of a mapped container
+class CompressedFile {
+public:
+    [[nodiscard]] bool open(const std::string& filename);
+
+    // Take over an already mapped file; false if it is not a valid container
+    [[nodiscard]] bool attach(MappedFile file);
+
+    [[nodiscard]] size_t block_count() const noexcept {
+        return blocks_ ? static_cast<size_t>(header_.block_count) : 0;
+    }
+
+    [[nodiscard]] const CompressedBlock& block(size_t i) const noexcept {
+        return blocks_[i];
+    }
+
+    [[nodiscard]] size_t block_bytes() const noexcept {
+        return header_.block_bytes;
+    }
+
+    [[nodiscard]] uint64_t raw_size() const noexcept {
+        return header_.raw_size;
+    }
+
+    // Decode block i into out (block(i).raw_size bytes)
+    [[nodiscard]] bool decode_block(size_t i, char* out) const noexcept;
+
+    // Decode every block into one contiguous buffer, in parallel
+    [[nodiscard]] bool decode_all(std::vector<char>& out, size_t threads = 0) const;
+
+private:
+    MappedFile file_;
+    CompressedHeader header_{};
+    const CompressedBlock* blocks_ = nullptr;
+};
+
+// Whole-file view for the loaders: plain files are mapped, compressed
+// containers are decoded into memory in parallel
+class DecodedFile {
+public:
+    [[nodiscard]] bool open(const std::string& filename, size_t threads = 0);
+
+    [[nodiscard]] const char* data() const noexcept {
+        return data_;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        return std::string_view(data_, size_);
+    }
+
+    [[nodiscard]] bool compressed() const noexcept {
+        return compressed_;
+    }
+
+private:
+    MappedFile plain_;
+    std::vector<char> decoded_;
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool compressed_ = false;
+};
+
+// Sequential block source over a container for the streaming reader.
+// Decodes `parallelism` blocks at a time across threads, so memory stays
+// at parallelism * block_bytes.
+class CompressedBlockStream {
+public:
+    explicit CompressedBlockStream(size_t parallelism = 0);
+
+    [[nodiscard]] bool open(const std::string& filename);
+    [[nodiscard]] bool attach(MappedFile file);
+
+    // Next decoded block in file order; valid until the next call
+    [[nodiscard]] bool next(const char*& data, size_t& size);
+
+    [[nodiscard]] bool failed() const noexcept {
+        return failed_;
+    }
+
+    [[nodiscard]] size_t block_bytes() const noexcept {
+        return file_.block_bytes();
+    }
+
+private:
+    bool decode_batch();
+
+    CompressedFile file_;
+    size_t parallelism_;
+    std::vector<std::vector<char>> buffers_;
+    size_t batch_first_ = 0;    // Index of the block in buffers_[0]
+    size_t batch_size_ = 0;
+    size_t batch_pos_ = 0;
+    bool failed_ = false;
+};
+
+} // namespace lob
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+namespace lob {
+
+enum class ReadBackend {
+    Auto,       // io_uring when the kernel allows it, else pread
+    IoUring,    // io_uring only; open fails without it
+    Pread       // Synchronous pread with kernel readahead hints
+};
+
+struct BlockReaderOptions {
+    size_t block_bytes = 1 << 20;
+    unsigned queue_depth = 4;   // Blocks in flight ahead of the consumer
+    bool direct = false;        // O_DIRECT; dropped if the filesystem refuses it
+    ReadBackend backend = ReadBackend::Auto;
+};
+
+// Sequential block reader for large captures. With io_uring, queue_depth
+// reads into registered buffers stay in flight while the caller parses the
+// current block, so disk and CPU work overlap. Without it, pread is used
+// and the kernel is asked to read ahead of the consumer.
+class BlockReader {
+public:
+    BlockReader() noexcept;
+    ~BlockReader();
+
+    BlockReader(const BlockReader&) = delete;
+    BlockReader& operator=(const BlockReader&) = delete;
+
+    [[nodiscard]] bool open(const std::string& filename,
+                            const BlockReaderOptions& options = BlockReaderOptions());
+    void close() noexcept;
+
+    // Next block in file order. The block stays valid until the next call.
+    // Returns false at end of file or on a read error.
+    [[nodiscard]] bool next(const char*& data, size_t& size);
+
+    // Backend actually in use after open
+    [[nodiscard]] ReadBackend backend() const noexcept {
+        return backend_;
+    }
+
+    [[nodiscard]] bool direct() const noexcept {
+        return direct_;
+    }
+
+    // Block size after rounding for O_DIRECT alignment
+    [[nodiscard]] size_t block_bytes() const noexcept {
+        return block_bytes_;
+    }
+
+    [[nodiscard]] uint64_t file_size() const noexcept {
+        return file_size_;
+    }
+
+    [[nodiscard]] bool failed() const noexcept {
+        return failed_;
+    }
+
+private:
+    struct Ring;
+
+    bool start_ring(unsigned queue_depth);
+    bool submit_read(size_t slot);
+    bool next_ring(const char*& data, size_t& size);
+    bool next_pread(const char*& data, size_t& size);
+
+    int fd_ = -1;
+    std::FILE* stream_ = nullptr;   // Platforms without pread
+    ReadBackend backend_ = ReadBackend::Pread;
+    bool direct_ = false;
+    bool failed_ = false;
+    size_t block_bytes_ = 0;
+    uint64_t file_size_ = 0;
+    uint64_t next_offset_ = 0;      // Next file offset to request
+    uint64_t deliver_offset_ = 0;   // File offset of the next block handed out
+
+    // One aligned allocation split into per-slot blocks
+    char* buffers_ = nullptr;
+    size_t slots_ = 0;
+    std::unique_ptr<Ring> ring_;
+};
+
+} // namespace lob
@@ -41,11 +41,16 @@ public:
         }
     }
 
-    // Find and remove order by ID
-    [[nodiscard]] bool remove_order(OrderId id, uint64_t& removed_qty) noexcept {
-        for (auto it = orders_.begin(); it != orders_.end(); ++it) {
+    // Find and remove order by ID, optionally reporting its queue position
+    [[nodiscard]] bool remove_order(OrderId id, uint64_t& removed_qty,
+                                    size_t* position = nullptr) noexcept {
+        size_t index = 0;
+        for (auto it = orders_.begin(); it != orders_.end(); ++it, ++index) {
             if (it->order.id == id) {
                 removed_qty = it->remaining_qty;
+                if (position) {
+                    *position = index;
+                }
                 total_qty_ -= removed_qty;
                 orders_.erase(it);
                 return true;
@@ -85,6 +90,11 @@ public:
         return total_qty_;
     }
 
+    // Orders in queue (time priority) order
+    [[nodiscard]] const std::list<BookOrder>& orders() const noexcept {
+        return orders_;
+    }
+
 private:
     std::list<BookOrder> orders_;
     uint64_t total_qty_ = 0;
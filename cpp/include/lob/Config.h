@@ -1,19 +1,54 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 namespace lob {
 
+// What the engine does when the event ring is full
+enum class OverflowPolicy : uint8_t {
+    Drop = 0,   // Discard the event, count it and leave a sequence gap
+    Block = 1,  // Spin (then yield) until a consumer frees a slot
+    Spill = 2   // Append to an unbounded overflow segment drained in order
+};
+
+// Where an engine's threads run and where its memory lives. A value of -1
+// leaves the choice to the OS.
+struct ThreadPlacement {
+    int matcher_cpu = -1;         // Core for the thread calling submit/cancel/replace
+    int publisher_cpu = -1;       // Core for the event consumer/publisher thread
+    int feed_cpu = -1;            // Core for market-data feed threads
+    int numa_node = -1;           // Memory node; -1 follows matcher_cpu
+    bool require_isolated = false;  // Refuse cores not in the isolcpus= set
+};
+
+enum class ThreadRole : uint8_t {
+    Matcher = 0,
+    Publisher = 1,
+    Feed = 2
+};
+
 struct EngineConfig {
     size_t max_orders;      // Maximum number of active orders
     size_t ring_size;       // Size of event ring buffer
     double tick_size;       // Minimum price increment
+    OverflowPolicy overflow_policy;  // Behaviour when the event ring is full
+    ThreadPlacement placement;       // CPU pinning and NUMA placement
+    size_t published_depth;          // Levels per side published for lock-free readers (0 = top only)
+    bool level_updates;              // Emit LevelUpdate deltas for every changed price level
+    uint64_t snapshot_interval;      // Commands between full LevelUpdate snapshots (0 = on request only)
+    bool order_updates;              // Record order-by-order (L3) updates for poll_order_updates
     
     EngineConfig() noexcept 
-        : max_orders(100000), ring_size(10000), tick_size(0.01) {}
+        : max_orders(100000), ring_size(10000), tick_size(0.01),
+          overflow_policy(OverflowPolicy::Drop), published_depth(0),
+          level_updates(false), snapshot_interval(0), order_updates(false) {}
     
-    EngineConfig(size_t max_ord, size_t ring, double tick) noexcept
-        : max_orders(max_ord), ring_size(ring), tick_size(tick) {}
+    EngineConfig(size_t max_ord, size_t ring, double tick,
+                 OverflowPolicy overflow = OverflowPolicy::Drop) noexcept
+        : max_orders(max_ord), ring_size(ring), tick_size(tick),
+          overflow_policy(overflow), published_depth(0),
+          level_updates(false), snapshot_interval(0), order_updates(false) {}
 };
 
 } // namespace lob
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace lob {
+
+// Allocation-free CSV helpers. Fields are string_views into the caller's
+// buffer (typically a MappedFile), numbers are converted with from_chars
+// and failures are reported through return values, never exceptions.
+
+constexpr size_t MAX_CSV_FIELDS = 16;
+
+[[nodiscard]] inline bool is_csv_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+[[nodiscard]] inline std::string_view trim_field(std::string_view s) noexcept {
+    size_t b = 0;
+    size_t e = s.size();
+    while (b < e && is_csv_space(s[b])) ++b;
+    while (e > b && is_csv_space(s[e - 1])) --e;
+    return s.substr(b, e - b);
+}
+
+// Split one line (without its newline) into at most max_fields trimmed
+// fields; returns the number of fields written
+inline size_t split_csv_line(std::string_view line, std::string_view* out,
+                             size_t max_fields = MAX_CSV_FIELDS) noexcept {
+    size_t count = 0;
+    size_t start = 0;
+    while (count < max_fields) {
+        size_t comma = line.find(',', start);
+        if (comma == std::string_view::npos) {
+            out[count++] = trim_field(line.substr(start));
+            break;
+        }
+        out[count++] = trim_field(line.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return count;
+}
+
+// Call fn(line, line_number) for every line in [data, data + size);
+// line_number is 1-based and lines exclude their terminator
+template<typename Fn>
+void for_each_line(const char* data, size_t size, Fn&& fn) {
+    const char* p = data;
+    const char* end = data + size;
+    size_t line_no = 0;
+    while (p < end) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* line_end = nl ? nl : end;
+        ++line_no;
+        fn(std::string_view(p, line_end - p), line_no);
+        p = nl ? nl + 1 : end;
+    }
+}
+
+// Parse an unsigned integer occupying the whole field
+[[nodiscard]] inline bool parse_uint(std::string_view s, uint64_t& out) noexcept {
+    if (s.empty()) return false;
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && ptr == s.data() + s.size();
+}
+
+// Parse a floating-point number occupying the whole field
+[[nodiscard]] inline bool parse_double(std::string_view s, double& out) noexcept {
+    if (s.empty()) return false;
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && ptr == s.data() + s.size();
+#else
+    // Standard libraries without floating-point from_chars
+    char buf[64];
+    if (s.size() >= sizeof(buf)) return false;
+    std::memcpy(buf, s.data(), s.size());
+    buf[s.size()] = '\0';
+    char* end = nullptr;
+    out = std::strtod(buf, &end);
+    return end == buf + s.size();
+#endif
+}
+
+// Case-insensitive ASCII comparison against a lowercase literal
+[[nodiscard]] inline bool iequals(std::string_view s, std::string_view lower) noexcept {
+    if (s.size() != lower.size()) return false;
+    for (size_t i = 0; i < s.size(); ++i) {
+        char c = s[i];
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c != lower[i]) return false;
+    }
+    return true;
+}
+
+} // namespace lob
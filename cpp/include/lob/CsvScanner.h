@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CsvParser.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace lob {
+
+// Structural scanner for CSV ingestion (in the style of simdjson stage 1):
+// finds every ',' and '\n' in a block with vector compares and writes their
+// offsets out in one pass, so field splitting becomes index arithmetic.
+enum class ScanKernel : uint8_t {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2
+};
+
+// Best kernel supported by the running CPU (checked once)
+[[nodiscard]] ScanKernel best_scan_kernel() noexcept;
+
+// Write the offset of every ',' and '\n' in [data, data + len) to out, which
+// must have room for len entries. Returns the number of offsets written.
+size_t find_structurals(const char* data, size_t len, uint32_t* out) noexcept;
+size_t find_structurals(const char* data, size_t len, uint32_t* out,
+                        ScanKernel kernel) noexcept;
+
+// Call fn(fields, count, line_no) for every row in [data, data + size).
+// Fields are trimmed views into data; at most MAX_CSV_FIELDS are reported
+// per row. line_no is 1-based.
+template<typename Fn>
+void for_each_csv_row(const char* data, size_t size, Fn&& fn,
+                      ScanKernel kernel = best_scan_kernel()) {
+    constexpr size_t kBlock = 64 * 1024;
+    std::vector<uint32_t> index(std::min(size, kBlock));
+    std::string_view fields[MAX_CSV_FIELDS];
+    size_t count = 0;
+    size_t field_start = 0;
+    size_t line_no = 0;
+    
+    for (size_t base = 0; base < size; base += kBlock) {
+        size_t len = std::min(kBlock, size - base);
+        size_t n = find_structurals(data + base, len, index.data(), kernel);
+        for (size_t i = 0; i < n; ++i) {
+            size_t pos = base + index[i];
+            if (count < MAX_CSV_FIELDS) {
+                fields[count++] = trim_field(std::string_view(data + field_start, pos - field_start));
+            }
+            field_start = pos + 1;
+            if (data[pos] == '\n') {
+                fn(static_cast<const std::string_view*>(fields), count, ++line_no);
+                count = 0;
+            }
+        }
+    }
+    
+    // Last row without a trailing newline
+    if (field_start < size || count > 0) {
+        if (count < MAX_CSV_FIELDS) {
+            fields[count++] = trim_field(std::string_view(data + field_start, size - field_start));
+        }
+        fn(static_cast<const std::string_view*>(fields), count, ++line_no);
+    }
+}
+
+} // namespace lob
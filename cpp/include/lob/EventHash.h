@@ -0,0 +1,161 @@
+#pragma once
+
+#include "Events.h"
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace lob {
+
+// Rolling hash of an event stream as of a given sequence number
+struct HashCheckpoint {
+    uint64_t seq = 0;
+    uint64_t hash = 0;
+
+    constexpr bool operator==(const HashCheckpoint&) const noexcept = default;
+};
+
+struct EventHashConfig {
+    uint64_t checkpoint_interval = 4096;  // Record a checkpoint every N sequence numbers (0 = never)
+    bool include_timestamps = true;       // Clear to compare runs with different clocks
+};
+
+// Order-sensitive 64-bit hash over every field of every event, including
+// its sequence number, so drops and reorderings change the result. Events
+// are hashed field by field rather than as raw bytes, so struct padding
+// never leaks into the hash. Not cryptographic; a few multiplies per
+// field keeps it cheap enough to leave on.
+class EventHasher {
+public:
+    static constexpr uint64_t SEED = 0x6c6f62686173683bULL;
+
+    explicit EventHasher(const EventHashConfig& config = EventHashConfig()) noexcept
+        : config_(config) {}
+
+    template<typename... Events>
+    void update(uint64_t seq, const std::variant<Events...>& event) noexcept {
+        std::visit([this, seq](const auto& e) { update(seq, e); }, event);
+    }
+
+    void update(uint64_t seq, const TradeEvent& e) noexcept {
+        begin(seq, e.type);
+        mix(e.taker_id);
+        mix(e.maker_id);
+        mix(e.price);
+        mix(e.qty);
+        end(e.ts);
+    }
+
+    void update(uint64_t seq, const AcceptEvent& e) noexcept {
+        begin(seq, e.type);
+        mix(e.id);
+        end(e.ts);
+    }
+
+    void update(uint64_t seq, const RejectEvent& e) noexcept {
+        begin(seq, e.type);
+        mix(e.id);
+        mix(e.reason_code);
+        end(e.ts);
+    }
+
+    void update(uint64_t seq, const CancelEvent& e) noexcept {
+        begin(seq, e.type);
+        mix(e.id);
+        mix(e.remaining);
+        end(e.ts);
+    }
+
+    void update(uint64_t seq, const ReplaceEvent& e) noexcept {
+        begin(seq, e.type);
+        mix(e.id);
+        mix(e.new_price);
+        mix(e.new_qty);
+        end(e.ts);
+    }
+
+    void update(uint64_t seq, const BookTop& e) noexcept {
+        begin(seq, e.type);
+        mix(e.best_bid);
+        mix(e.bid_qty);
+        mix(e.best_ask);
+        mix(e.ask_qty);
+        end(e.ts);
+    }
+
+    void update(uint64_t seq, const LevelUpdate& e) noexcept {
+        begin(seq, e.type);
+        mix(static_cast<uint64_t>(e.side) | static_cast<uint64_t>(e.kind) << 8 |
+            static_cast<uint64_t>(e.order_count) << 32);
+        mix(e.price);
+        mix(e.qty);
+        mix(e.seq);
+        end(e.ts);
+    }
+
+    // Hash and sequence number of the last event folded in
+    [[nodiscard]] HashCheckpoint current() const noexcept {
+        return HashCheckpoint{seq_, hash_};
+    }
+
+    // True if the last update landed on a checkpoint boundary
+    [[nodiscard]] bool at_checkpoint() const noexcept {
+        return config_.checkpoint_interval != 0 && seq_ % config_.checkpoint_interval == 0;
+    }
+
+    [[nodiscard]] const EventHashConfig& config() const noexcept {
+        return config_;
+    }
+
+    void reset() noexcept {
+        hash_ = SEED;
+        seq_ = 0;
+    }
+
+private:
+    static constexpr uint64_t rotl(uint64_t v, int r) noexcept {
+        return (v << r) | (v >> (64 - r));
+    }
+
+    void mix(uint64_t v) noexcept {
+        hash_ = rotl(hash_ ^ (v * 0x9e3779b97f4a7c15ULL), 29) * 0xbf58476d1ce4e5b9ULL;
+    }
+
+    void mix(Price p) noexcept {
+        mix(static_cast<uint64_t>(p.ticks));
+    }
+
+    void begin(uint64_t seq, EventType type) noexcept {
+        seq_ = seq;
+        mix(seq);
+        mix(static_cast<uint64_t>(type));
+    }
+
+    void end(uint64_t ts) noexcept {
+        if (config_.include_timestamps) {
+            mix(ts);
+        }
+        hash_ ^= hash_ >> 32;
+    }
+
+    EventHashConfig config_;
+    uint64_t hash_ = SEED;
+    uint64_t seq_ = 0;
+};
+
+// Where two checkpoint lists (each in sequence order) first disagree
+struct HashDivergence {
+    bool diverged = false;
+    uint64_t last_match_seq = 0;  // Last sequence both sides hashed identically (0 = none)
+    uint64_t first_diff_seq = 0;  // First checkpoint sequence where they differ
+};
+
+// Compare checkpoints taken at the same sequence numbers. The first
+// divergent event lies in (last_match_seq, first_diff_seq], so only that
+// window needs replaying to find it. Checkpoints present on only one side
+// are ignored.
+[[nodiscard]] HashDivergence find_divergence(const std::vector<HashCheckpoint>& a,
+                                             const std::vector<HashCheckpoint>& b) noexcept;
+
+} // namespace lob
@@ -2,6 +2,7 @@
 
 #include "OrderId.h"
 #include "Price.h"
+#include "Side.h"
 #include <cstdint>
 #include <vector>
 
@@ -13,7 +14,8 @@ enum class EventType : uint8_t {
     OrderRejected = 2,
     OrderCanceled = 3,
     OrderReplaced = 4,
-    BookUpdate = 5
+    BookUpdate = 5,
+    LevelUpdate = 6
 };
 
 struct TradeEvent {
@@ -86,6 +88,67 @@ struct BookTop {
           best_ask(INVALID_PRICE), ask_qty(0), ts(0) {}
 };
 
+enum class LevelUpdateKind : uint8_t {
+    Delta = 0,          // One level changed since the last update
+    SnapshotStart = 1,  // Drop the local book; order_count SnapshotLevel entries follow
+    SnapshotLevel = 2   // One level of a full snapshot
+};
+
+// Incremental L2 depth: the new state of one price level. Updates carry
+// their own contiguous sequence number, so a subscriber that filters the
+// engine stream down to level updates can still detect gaps, and resyncs
+// at the next snapshot.
+struct LevelUpdate {
+    EventType type = EventType::LevelUpdate;
+    Side side;
+    LevelUpdateKind kind;
+    uint32_t order_count;   // Orders at the level (SnapshotStart: levels that follow)
+    Price price;
+    uint64_t qty;           // Total quantity at the level; 0 = level removed
+    uint64_t seq;           // Level-feed sequence number
+    uint64_t ts;
+
+    LevelUpdate() noexcept
+        : side(Side::Buy), kind(LevelUpdateKind::Delta), order_count(0),
+          price(), qty(0), seq(0), ts(0) {}
+    LevelUpdate(Side s, LevelUpdateKind k, Price p, uint64_t q, uint32_t count, uint64_t t) noexcept
+        : side(s), kind(k), order_count(count), price(p), qty(q), seq(0), ts(t) {}
+};
+
+enum class OrderUpdateKind : uint8_t {
+    Add = 0,        // Order now rests at the back of its level's queue
+    Modify = 1,     // Order was replaced and rests again (new price/qty, back of queue)
+    Delete = 2,     // Order left the book other than by a fill
+    Execute = 3,    // Resting order traded at the front of its queue
+    Clear = 4       // Drop the local book; qty Add entries follow
+};
+
+// Order-by-order (L3) book change, fixed size and trivially copyable so the
+// stream can be written or mapped as raw records. Updates are numbered per
+// book without gaps; an order's queue position can be tracked from the
+// stream alone.
+struct OrderUpdate {
+    uint64_t seq;           // Per-book sequence number
+    uint64_t ts;
+    OrderId id;             // Execute: the resting (maker) order
+    Price price;
+    uint64_t qty;           // Add/Modify: resting qty; Delete: qty removed;
+                            // Execute: qty filled; Clear: orders that follow
+    uint32_t position;      // 0-based queue position at the level (Execute: 0)
+    OrderUpdateKind kind;
+    Side side;
+    uint8_t reserved[2];
+
+    OrderUpdate() noexcept
+        : seq(0), ts(0), id(0), price(), qty(0), position(0),
+          kind(OrderUpdateKind::Add), side(Side::Buy), reserved{} {}
+    OrderUpdate(OrderUpdateKind k, Side s, OrderId order_id, Price p, uint64_t q,
+                uint32_t pos, uint64_t sequence, uint64_t t) noexcept
+        : seq(sequence), ts(t), id(order_id), price(p), qty(q), position(pos),
+          kind(k), side(s), reserved{} {}
+};
+static_assert(sizeof(OrderUpdate) == 48, "OrderUpdate is a fixed-size wire record");
+
 // Represents a single level in a depth snapshot
 struct DepthLevel {
     Price price;
@@ -106,4 +169,19 @@ struct DepthSnapshot {
     DepthSnapshot() noexcept : ts(0) {}
 };
 
+// Upper bound on levels per side in a FixedDepth
+constexpr size_t MAX_FIXED_DEPTH = 16;
+
+// Heap-free depth snapshot with a bounded number of levels, suitable for
+// publishing through a SeqLock
+struct FixedDepth {
+    DepthLevel bids[MAX_FIXED_DEPTH];
+    DepthLevel asks[MAX_FIXED_DEPTH];
+    uint32_t bid_levels;
+    uint32_t ask_levels;
+    uint64_t ts;
+
+    FixedDepth() noexcept : bid_levels(0), ask_levels(0), ts(0) {}
+};
+
 } // namespace lob
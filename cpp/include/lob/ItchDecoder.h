@@ -0,0 +1,122 @@
+#pragma once
+
+#include "MultiSymbolEngine.h"
+#include "Price.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lob {
+
+// Big-endian field loads for exchange binary protocols
+[[nodiscard]] inline uint16_t load_be16(const char* p) noexcept {
+    auto b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint16_t>((b[0] << 8) | b[1]);
+}
+
+[[nodiscard]] inline uint32_t load_be32(const char* p) noexcept {
+    auto b = reinterpret_cast<const unsigned char*>(p);
+    return (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) | (uint32_t(b[2]) << 8) | b[3];
+}
+
+[[nodiscard]] inline uint64_t load_be48(const char* p) noexcept {
+    return (uint64_t(load_be16(p)) << 32) | load_be32(p + 2);
+}
+
+[[nodiscard]] inline uint64_t load_be64(const char* p) noexcept {
+    return (uint64_t(load_be32(p)) << 32) | load_be32(p + 4);
+}
+
+// ITCH 5.0 message lengths (excluding the 2-byte length prefix)
+namespace itch {
+constexpr size_t STOCK_DIRECTORY_LEN = 39;  // 'R'
+constexpr size_t ADD_ORDER_LEN = 36;        // 'A'
+constexpr size_t ADD_ORDER_MPID_LEN = 40;   // 'F'
+constexpr size_t ORDER_EXECUTED_LEN = 31;   // 'E'
+constexpr size_t EXECUTED_PRICE_LEN = 36;   // 'C'
+constexpr size_t ORDER_CANCEL_LEN = 23;     // 'X'
+constexpr size_t ORDER_DELETE_LEN = 19;     // 'D'
+constexpr size_t ORDER_REPLACE_LEN = 35;    // 'U'
+constexpr int PRICE_DECIMALS = 4;
+} // namespace itch
+
+struct ItchStats {
+    uint64_t messages = 0;
+    uint64_t directory = 0;
+    uint64_t adds = 0;
+    uint64_t executes = 0;
+    uint64_t cancels = 0;
+    uint64_t deletes = 0;
+    uint64_t replaces = 0;
+    uint64_t ignored = 0;         // Message types that do not touch the book
+    uint64_t unknown_orders = 0;  // References to orders we never saw added
+    uint64_t malformed = 0;       // Messages shorter than their type requires
+    uint64_t rejected = 0;        // Commands the engine refused
+};
+
+// Decodes length-prefixed ITCH 5.0 order flow (2-byte big-endian length,
+// then the message) straight into a MultiSymbolEngine. Books are looked up
+// through a stock-locate table rather than by symbol string, and symbols are
+// added to the engine as the stock directory (or first add) names them.
+//
+// Executions and partial cancels shrink the resting order through replace,
+// so they cost the order its queue position; full fills and deletes cancel.
+// Engines must not be removed from the MultiSymbolEngine while decoding.
+//
+// The decoder is the consumer of every book it drives: after each message
+// it drains the touched book's event ring into the sink (or discards the
+// events if there is none), so the ring never fills whatever its overflow
+// policy. Nothing else may poll those books while decoding.
+class ItchDecoder {
+public:
+    using EventSink = std::function<void(const SymbolId& symbol, const SequencedEvent& event)>;
+
+    explicit ItchDecoder(MultiSymbolEngine& engine, const TickScale& scale = TickScale(),
+                         EventSink sink = nullptr)
+        : engine_(engine), scale_(scale), sink_(std::move(sink)) {}
+
+    // Decode a whole capture through a read-only mapping
+    [[nodiscard]] bool decode_file(const std::string& filename);
+
+    // Decode complete messages in [data, data + size); returns the bytes
+    // consumed so a trailing partial message can be carried to the next call
+    size_t decode(const char* data, size_t size);
+
+    [[nodiscard]] const ItchStats& stats() const noexcept {
+        return stats_;
+    }
+
+    // Symbol registered for a stock locate, or empty if none
+    [[nodiscard]] const SymbolId& symbol(uint16_t locate) const noexcept;
+
+    // Convert an ITCH price (4 implied decimals) to engine ticks;
+    // INVALID_PRICE if the tick count does not fit in a Price
+    [[nodiscard]] Price to_price(uint32_t itch_price) const noexcept;
+
+private:
+    struct LiveOrder {
+        MatchingEngine* book;
+        Price price;
+        uint32_t shares;
+        Side side;
+        uint16_t locate;
+    };
+
+    void on_message(const char* msg, size_t len);
+    MatchingEngine* book_for(uint16_t locate, const char* stock);
+    void reduce(uint64_t ref, uint32_t shares);
+    void drain(uint16_t locate);
+
+    MultiSymbolEngine& engine_;
+    TickScale scale_;
+    EventSink sink_;
+    std::vector<SequencedEvent> events_;
+    std::vector<MatchingEngine*> books_;       // Indexed by stock locate
+    std::vector<SymbolId> symbols_;            // Indexed by stock locate
+    std::unordered_map<uint64_t, LiveOrder> orders_;
+    ItchStats stats_;
+};
+
+} // namespace lob
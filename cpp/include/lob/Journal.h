@@ -0,0 +1,207 @@
+#pragma once
+
+#include "MatchingEngine.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace lob {
+
+// Journal file layout (native byte order):
+//   JournalFileHeader | records...
+// Each record is a JournalRecordHeader followed by a POD payload, padded
+// to 8 bytes. The file is preallocated and zero-filled, so the first
+// record with length 0 marks the end of the journal.
+
+enum class JournalKind : uint8_t {
+    Command = 1,    // Inbound request, seq = command number
+    Event = 2       // Outbound engine event, seq = event sequence number
+};
+
+enum class JournalCommand : uint8_t {
+    Submit = 0,     // Payload: Order
+    Cancel = 1,     // Payload: CancelCommand
+    Replace = 2     // Payload: ReplaceCommand
+};
+
+struct CancelCommand {
+    OrderId id;
+};
+
+struct ReplaceCommand {
+    OrderId id;
+    Price price;
+    uint64_t qty;
+};
+
+struct JournalRecordHeader {
+    uint32_t length;        // Payload bytes; written last
+    JournalKind kind;
+    uint8_t type;           // JournalCommand, or the EngineEvent variant index
+    uint16_t reserved;
+    uint64_t seq;
+};
+static_assert(sizeof(JournalRecordHeader) == 16, "JournalRecordHeader layout is part of the file format");
+
+struct JournalFileHeader {
+    char magic[8];          // "LOBJRNL1"
+    uint32_t version;
+    uint32_t reserved0;
+    uint64_t capacity;      // File size including this header
+    uint64_t reserved[5];
+};
+static_assert(sizeof(JournalFileHeader) == 64, "JournalFileHeader layout is part of the file format");
+
+constexpr uint32_t JOURNAL_VERSION = 1;
+
+struct JournalConfig {
+    size_t capacity_bytes = 64 << 20;
+
+    // Group-commit window: appended records are synced to disk together at
+    // most this long after they were written. Shorter means less data at
+    // risk on a crash, longer means fewer syncs. Zero disables background
+    // syncing; records then reach disk on flush() or by OS writeback.
+    std::chrono::microseconds commit_interval{1000};
+
+    // Fault the whole mapping in up front so appends never page-fault
+    bool prefault = true;
+};
+
+struct JournalStats {
+    uint64_t records = 0;
+    uint64_t appended_bytes = 0;
+    uint64_t durable_bytes = 0;     // Bytes known to be on disk
+    uint64_t dropped = 0;           // Records lost because the journal was full
+    uint64_t syncs = 0;
+};
+
+// Write-ahead journal of engine commands and events on a memory-mapped,
+// preallocated file. Appends are a bounds check and a memcpy on the
+// matcher thread; a background thread syncs batches of records to disk,
+// so the matcher never waits for I/O. When the file is full, further
+// records are counted as dropped rather than blocking.
+class Journal {
+public:
+    Journal() = default;
+    ~Journal() { close(); }
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Create (or truncate) a journal file
+    [[nodiscard]] bool open(const std::string& filename,
+                            const JournalConfig& config = JournalConfig());
+
+    // Sync outstanding records, stop the syncer and unmap
+    void close();
+
+    [[nodiscard]] bool is_open() const noexcept {
+        return base_ != nullptr;
+    }
+
+    // Single writer (the matcher thread)
+    void append_submit(const Order& order) noexcept {
+        append(JournalKind::Command, static_cast<uint8_t>(JournalCommand::Submit),
+               ++command_seq_, &order, sizeof(order));
+    }
+
+    void append_cancel(OrderId id) noexcept {
+        CancelCommand cmd{id};
+        append(JournalKind::Command, static_cast<uint8_t>(JournalCommand::Cancel),
+               ++command_seq_, &cmd, sizeof(cmd));
+    }
+
+    void append_replace(OrderId id, Price price, uint64_t qty) noexcept {
+        ReplaceCommand cmd{id, price, qty};
+        append(JournalKind::Command, static_cast<uint8_t>(JournalCommand::Replace),
+               ++command_seq_, &cmd, sizeof(cmd));
+    }
+
+    void append_event(uint64_t seq, const EngineEvent& event) noexcept {
+        std::visit([&](const auto& e) {
+            append(JournalKind::Event, static_cast<uint8_t>(event.index()), seq, &e, sizeof(e));
+        }, event);
+    }
+
+    // Sync everything appended so far; blocks the caller, not the matcher
+    bool flush();
+
+    [[nodiscard]] JournalStats stats() const noexcept;
+
+private:
+    bool append(JournalKind kind, uint8_t type, uint64_t seq,
+                const void* payload, uint32_t length) noexcept;
+    bool sync_to(uint64_t end);
+    void sync_loop();
+
+    int fd_ = -1;
+    char* base_ = nullptr;
+    size_t capacity_ = 0;
+    JournalConfig config_;
+
+    // Writer-owned state
+    uint64_t write_pos_ = 0;
+    uint64_t command_seq_ = 0;
+
+    // Published to the syncer and stats readers
+    std::atomic<uint64_t> tail_{0};
+    std::atomic<uint64_t> durable_{0};
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> syncs_{0};
+
+    std::mutex sync_mutex_;         // Serializes syncs
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+    std::thread syncer_;
+};
+
+// View of one journal record; payload points into the mapped file
+struct JournalRecord {
+    JournalKind kind;
+    uint8_t type;
+    uint64_t seq;
+    const char* payload;
+    uint32_t length;
+
+    // Copy the payload out as T; false if the size does not match
+    template<typename T>
+    [[nodiscard]] bool as(T& out) const noexcept {
+        if (length != sizeof(T)) return false;
+        std::memcpy(&out, payload, sizeof(T));
+        return true;
+    }
+
+    // Decode an event record
+    [[nodiscard]] bool event(EngineEvent& out) const noexcept;
+};
+
+// Sequential reader over a journal file, e.g. for audit or recovery
+class JournalReader {
+public:
+    [[nodiscard]] bool open(const std::string& filename);
+
+    // Next record, or false at the end of the journal
+    [[nodiscard]] bool next(JournalRecord& out) noexcept;
+
+    void rewind() noexcept {
+        pos_ = sizeof(JournalFileHeader);
+    }
+
+private:
+    MappedFile file_;
+    size_t pos_ = 0;
+};
+
+// Re-run every journaled command against an engine; returns the number
+// the engine accepted. Rebuilds the book as of the end of the journal.
+size_t replay_journal(JournalReader& reader, MatchingEngine& engine);
+
+} // namespace lob
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "Price.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace lob {
+
+// Append-only JSON writer over a reusable buffer. Numbers go through
+// std::to_chars straight into the buffer, so once the buffer has grown to
+// the largest message no further allocation happens; clear() between
+// messages keeps the capacity. Commas are inserted automatically.
+class JsonWriter {
+public:
+    explicit JsonWriter(size_t capacity = 1024) {
+        buf_.resize(capacity);
+    }
+
+    // Render Price values as decimals of tick_size (e.g. 10050 ticks at
+    // 0.01 -> 100.50, invalid prices -> null); 0 writes raw ticks
+    void set_tick_size(double tick_size) noexcept {
+        decimal_prices_ = tick_size > 0.0;
+        if (decimal_prices_) {
+            scale_ = TickScale::from_double(tick_size);
+        }
+    }
+
+    void clear() noexcept {
+        len_ = 0;
+        need_comma_ = false;
+    }
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        return std::string_view(buf_.data(), len_);
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return len_;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return buf_.size();
+    }
+
+    JsonWriter& begin_object() {
+        separate();
+        put('{');
+        need_comma_ = false;
+        return *this;
+    }
+
+    JsonWriter& end_object() {
+        put('}');
+        need_comma_ = true;
+        return *this;
+    }
+
+    JsonWriter& begin_array() {
+        separate();
+        put('[');
+        need_comma_ = false;
+        return *this;
+    }
+
+    JsonWriter& end_array() {
+        put(']');
+        need_comma_ = true;
+        return *this;
+    }
+
+    // Keys are written as given; they are expected to be plain identifiers
+    JsonWriter& key(std::string_view name) {
+        separate();
+        reserve(name.size() + 3);
+        buf_[len_++] = '"';
+        name.copy(&buf_[len_], name.size());
+        len_ += name.size();
+        buf_[len_++] = '"';
+        buf_[len_++] = ':';
+        need_comma_ = false;
+        return *this;
+    }
+
+    template<typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    JsonWriter& value(T v) {
+        separate();
+        reserve(24);
+        len_ = static_cast<size_t>(std::to_chars(&buf_[len_], buf_.data() + buf_.size(), v).ptr -
+                                   buf_.data());
+        need_comma_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(bool v) {
+        return literal(v ? "true" : "false");
+    }
+
+    // Escaped string value
+    JsonWriter& value(std::string_view s);
+
+    JsonWriter& value(const char* s) {
+        return value(std::string_view(s));
+    }
+
+    JsonWriter& value(Price p) {
+        if (!decimal_prices_) {
+            return value(p.ticks);
+        }
+        if (p == INVALID_PRICE) {
+            return null();
+        }
+        separate();
+        write_decimal(p.ticks * scale_.units);
+        need_comma_ = true;
+        return *this;
+    }
+
+    JsonWriter& null() {
+        return literal("null");
+    }
+
+    template<typename T>
+    JsonWriter& field(std::string_view name, const T& v) {
+        key(name);
+        return value(v);
+    }
+
+private:
+    void reserve(size_t n) {
+        if (len_ + n > buf_.size()) {
+            buf_.resize(std::max(buf_.size() * 2, len_ + n));
+        }
+    }
+
+    void put(char c) {
+        reserve(1);
+        buf_[len_++] = c;
+    }
+
+    void separate() {
+        if (need_comma_) {
+            put(',');
+        }
+    }
+
+    JsonWriter& literal(std::string_view text) {
+        separate();
+        reserve(text.size());
+        text.copy(&buf_[len_], text.size());
+        len_ += text.size();
+        need_comma_ = true;
+        return *this;
+    }
+
+    // Fixed-point value with scale_.decimals fractional digits
+    void write_decimal(int64_t scaled) {
+        reserve(24);
+        uint64_t magnitude = scaled < 0 ? 0 - static_cast<uint64_t>(scaled) : static_cast<uint64_t>(scaled);
+        if (scaled < 0) {
+            buf_[len_++] = '-';
+        }
+        uint64_t pow = 1;
+        for (uint8_t i = 0; i < scale_.decimals; ++i) {
+            pow *= 10;
+        }
+        char* end = buf_.data() + buf_.size();
+        len_ = static_cast<size_t>(std::to_chars(&buf_[len_], end, magnitude / pow).ptr - buf_.data());
+        if (scale_.decimals > 0) {
+            buf_[len_++] = '.';
+            uint64_t frac = magnitude % pow;
+            for (size_t i = scale_.decimals; i > 0; --i) {
+                buf_[len_ + i - 1] = static_cast<char>('0' + frac % 10);
+                frac /= 10;
+            }
+            len_ += scale_.decimals;
+        }
+    }
+
+    std::string buf_;
+    size_t len_ = 0;
+    bool need_comma_ = false;
+    bool decimal_prices_ = false;
+    TickScale scale_;
+};
+
+inline JsonWriter& JsonWriter::value(std::string_view s) {
+    static constexpr char HEX[] = "0123456789abcdef";
+    separate();
+    // Worst case every byte becomes \u00XX
+    reserve(s.size() * 6 + 2);
+    buf_[len_++] = '"';
+    for (char c : s) {
+        const auto u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            buf_[len_++] = '\\';
+            buf_[len_++] = c;
+        } else if (u < 0x20) {
+            buf_[len_++] = '\\';
+            buf_[len_++] = 'u';
+            buf_[len_++] = '0';
+            buf_[len_++] = '0';
+            buf_[len_++] = HEX[u >> 4];
+            buf_[len_++] = HEX[u & 0xf];
+        } else {
+            buf_[len_++] = c;
+        }
+    }
+    buf_[len_++] = '"';
+    need_comma_ = true;
+    return *this;
+}
+
+} // namespace lob
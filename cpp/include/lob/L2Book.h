@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Events.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+
+namespace lob {
+
+// Subscriber-side price-level book rebuilt from LevelUpdate events. It
+// applies deltas while the level sequence is contiguous. After a gap it
+// reports itself stale and ignores deltas until the next snapshot.
+class L2Book {
+public:
+    struct Level {
+        uint64_t qty = 0;
+        uint32_t order_count = 0;
+    };
+
+    // Apply one update; returns false if it exposed a gap (or arrived
+    // while stale and was skipped)
+    bool apply(const LevelUpdate& update);
+
+    // True once a snapshot has been applied and no gap seen since
+    [[nodiscard]] bool synced() const noexcept {
+        return synced_;
+    }
+
+    // Level-feed sequence of the last update applied
+    [[nodiscard]] uint64_t seq() const noexcept {
+        return seq_;
+    }
+
+    [[nodiscard]] const std::map<Price, Level, std::greater<Price>>& bids() const noexcept {
+        return bids_;
+    }
+
+    [[nodiscard]] const std::map<Price, Level, std::less<Price>>& asks() const noexcept {
+        return asks_;
+    }
+
+    // Same shape as LimitBook::get_depth, for comparison with the source book
+    void get_depth(DepthSnapshot& out, size_t max_levels = 10) const;
+
+private:
+    void set_level(const LevelUpdate& update);
+
+    std::map<Price, Level, std::greater<Price>> bids_;
+    std::map<Price, Level, std::less<Price>> asks_;
+    uint64_t seq_ = 0;
+    bool synced_ = true;    // Matches the source's initially empty book
+};
+
+} // namespace lob
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Events.h"
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace lob {
+
+// Subscriber-side order-by-order book rebuilt from OrderUpdate records.
+// Keeps each level's queue in time priority, so a consumer can follow its
+// own (or any) order's queue position. Goes stale on a sequence gap or an
+// update that contradicts its state, and resyncs at the next Clear.
+class L3Book {
+public:
+    struct Entry {
+        OrderId id = 0;
+        uint64_t qty = 0;
+    };
+
+    using Queue = std::vector<Entry>;
+
+    // Apply one update; returns false if it exposed a gap or inconsistency
+    // (or arrived while stale and was skipped)
+    bool apply(const OrderUpdate& update);
+
+    // True once a snapshot has been applied and no gap seen since
+    [[nodiscard]] bool synced() const noexcept {
+        return synced_;
+    }
+
+    // Order-feed sequence of the last update applied
+    [[nodiscard]] uint64_t seq() const noexcept {
+        return seq_;
+    }
+
+    [[nodiscard]] size_t order_count() const noexcept {
+        return index_.size();
+    }
+
+    // Orders resting at a level, front of the queue first; nullptr if the
+    // level is empty
+    [[nodiscard]] const Queue* queue(Side side, Price price) const noexcept;
+
+    [[nodiscard]] const std::map<Price, Queue, std::greater<Price>>& bids() const noexcept {
+        return bids_;
+    }
+
+    [[nodiscard]] const std::map<Price, Queue, std::less<Price>>& asks() const noexcept {
+        return asks_;
+    }
+
+    // Same shape as LimitBook::get_depth, for comparison with the source book
+    void get_depth(DepthSnapshot& out, size_t max_levels = 10) const;
+
+private:
+    struct Location {
+        Side side;
+        Price price;
+    };
+
+    bool change(const OrderUpdate& update);
+    bool insert(const OrderUpdate& update);
+    Queue* find_queue(Side side, Price price) noexcept;
+    void erase_if_empty(Side side, Price price);
+
+    std::map<Price, Queue, std::greater<Price>> bids_;
+    std::map<Price, Queue, std::less<Price>> asks_;
+    std::unordered_map<OrderId, Location> index_;
+    uint64_t seq_ = 0;
+    bool synced_ = true;    // Matches the source's initially empty book
+};
+
+} // namespace lob
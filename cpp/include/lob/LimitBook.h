@@ -11,6 +11,31 @@
 
 namespace lob {
 
+// Book image layout (native byte order):
+//   BookImageHeader | bid levels (best first) | ask levels (best first)
+// where each level is a BookLevelImage followed by its BookOrders in queue
+// order. Loading appends levels and orders in stored order, so no
+// matching or price-level searches are needed.
+struct BookImageHeader {
+    char magic[8];          // "LOBBOOK1"
+    uint32_t version;
+    uint32_t reserved0;
+    double tick_size;
+    uint64_t order_count;
+    uint64_t bid_levels;
+    uint64_t ask_levels;
+    uint64_t next_seq;      // Owner's event sequence counter (0 if none)
+    uint64_t reserved;
+};
+static_assert(sizeof(BookImageHeader) == 64, "BookImageHeader layout is part of the file format");
+
+struct BookLevelImage {
+    Price price;
+    uint64_t order_count;
+};
+
+constexpr uint32_t BOOK_IMAGE_VERSION = 1;
+
 class LimitBook {
 public:
     explicit LimitBook(double tick_size, std::shared_ptr<TimeSource> time_source);
@@ -32,6 +57,9 @@ public:
     // Get market depth snapshot up to specified levels
     void get_depth(DepthSnapshot& out, size_t max_levels = 10) const noexcept;
 
+    // Fill a fixed-capacity snapshot (capped at MAX_FIXED_DEPTH levels)
+    void get_depth(FixedDepth& out, size_t max_levels = MAX_FIXED_DEPTH) const noexcept;
+
     // Get total number of active orders
     [[nodiscard]] size_t total_orders() const noexcept {
         return order_index_.size();
@@ -41,6 +69,55 @@ public:
         return tick_size_;
     }
 
+    // Remember which price levels change, for incremental depth feeds.
+    // Off by default; costs a short scan per touched level when on.
+    void set_level_tracking(bool enabled) noexcept {
+        track_levels_ = enabled;
+        changed_levels_.clear();
+    }
+
+    // Append a Delta update (current qty and order count, 0 if the level is
+    // gone) for every level changed since the last call, then forget them.
+    // seq is left for the caller to assign.
+    void collect_level_updates(std::vector<LevelUpdate>& out);
+
+    // Append every level as a SnapshotLevel update, bids then asks, best
+    // first, and forget pending changes
+    void snapshot_levels(std::vector<LevelUpdate>& out);
+
+    // Record an OrderUpdate for every order-level change (add, replace,
+    // cancel, fill) as it happens. Off by default. Clears pending updates
+    // and continues numbering after last_seq.
+    void set_order_updates(bool enabled, uint64_t last_seq = 0) noexcept {
+        record_orders_ = enabled;
+        order_seq_ = last_seq;
+        order_updates_.clear();
+    }
+
+    // Sequence number of the last OrderUpdate recorded
+    [[nodiscard]] uint64_t order_update_seq() const noexcept {
+        return order_seq_;
+    }
+
+    // Hand over the updates recorded since the last call: out is cleared
+    // and swapped with the pending buffer, so both keep their capacity
+    void take_order_updates(std::vector<OrderUpdate>& out) noexcept {
+        out.clear();
+        out.swap(order_updates_);
+    }
+
+    // Record a Clear followed by an Add for every resting order, bids then
+    // asks, best level first and in queue order
+    void snapshot_orders();
+
+    // Append a binary image of every resting order to out
+    void save_image(std::vector<char>& out, uint64_t next_seq = 0) const;
+
+    // Replace the book with a saved image. Validates the whole image first
+    // and leaves the book untouched if it is malformed or was saved with a
+    // different tick size.
+    [[nodiscard]] bool load_image(const char* data, size_t size, uint64_t* next_seq = nullptr);
+
 private:
     // Match order against opposite side, generating trades
     void match_order(Order& order, std::vector<TradeEvent>& out_trades);
@@ -57,6 +134,23 @@ private:
     // Check if order would cross (aggressive)
     [[nodiscard]] bool would_cross(const Order& order) const noexcept;
 
+    void mark_level(Side side, Price price) {
+        if (!track_levels_) return;
+        // Changes cluster (one sweep, one level per command), so look at
+        // the most recent entries first
+        for (auto it = changed_levels_.rbegin(); it != changed_levels_.rend(); ++it) {
+            if (it->price == price && it->side == side) return;
+        }
+        changed_levels_.push_back({side, price});
+    }
+
+    void record_order(OrderUpdateKind kind, Side side, OrderId id, Price price,
+                      uint64_t qty, size_t position) {
+        if (!record_orders_) return;
+        order_updates_.emplace_back(kind, side, id, price, qty, static_cast<uint32_t>(position),
+                                    ++order_seq_, time_source_->now_ns());
+    }
+
     double tick_size_;
     std::shared_ptr<TimeSource> time_source_;
     
@@ -70,6 +164,18 @@ private:
         Price price;
     };
     std::unordered_map<OrderId, OrderLocation> order_index_;
+
+    // Levels touched since the last collect_level_updates
+    bool track_levels_ = false;
+    std::vector<OrderLocation> changed_levels_;
+
+    // Order-level feed not yet taken by take_order_updates. replacing_
+    // marks a replace that will rest without trading, whose cancel and
+    // re-add are recorded as a single Modify.
+    bool record_orders_ = false;
+    bool replacing_ = false;
+    uint64_t order_seq_ = 0;
+    std::vector<OrderUpdate> order_updates_;
 };
 
 } // namespace lob
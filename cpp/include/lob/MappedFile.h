@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lob {
+
+// Read-only view of a whole file. Uses mmap where available and falls back
+// to reading the file into memory elsewhere.
+class MappedFile {
+public:
+    MappedFile() noexcept = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map a file; returns false if it cannot be opened
+    [[nodiscard]] bool open(const std::string& filename);
+    void close() noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept {
+        return open_;
+    }
+
+    [[nodiscard]] const char* data() const noexcept {
+        return data_;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return size_;
+    }
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        return std::string_view(data_, size_);
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool open_ = false;
+    bool mapped_ = false;
+    std::vector<char> fallback_;
+};
+
+} // namespace lob
@@ -2,10 +2,10 @@
 
 #include "Order.h"
 #include "Events.h"
+#include "ParallelCsv.h"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
-#include <sstream>
 
 namespace lob {
 
@@ -41,6 +41,15 @@ struct MDTrade {
     uint64_t qty;
 };
 
+// Outcome of the most recent load call
+struct MDLoadStats {
+    size_t bytes = 0;           // File size
+    size_t lines = 0;           // Lines scanned, header included
+    size_t loaded = 0;          // Records produced
+    size_t bad_rows = 0;        // Non-empty rows that failed to parse
+    size_t first_bad_line = 0;  // 1-based line of the first bad row (0 = none)
+};
+
 class MarketDataFeed {
 public:
     MarketDataFeed() = default;
@@ -63,9 +72,27 @@ public:
     // Parse order type string
     [[nodiscard]] static OrderType parse_order_type(const std::string& type_str);
 
+    // Row-level parsers over pre-split, trimmed fields
+    [[nodiscard]] static bool parse_order(const std::string_view* fields, size_t count,
+                                          MDOrder& out);
+    [[nodiscard]] static bool parse_quote(const std::string_view* fields, size_t count,
+                                          MDQuote& out) noexcept;
+    [[nodiscard]] static bool parse_trade(const std::string_view* fields, size_t count,
+                                          MDTrade& out) noexcept;
+
+    // Statistics for the last load_* call, including malformed rows
+    [[nodiscard]] const MDLoadStats& last_load_stats() const noexcept {
+        return stats_;
+    }
+
+    // Threading for the loaders; large files are parsed in parallel chunks
+    void set_parse_options(const CsvParseOptions& options) noexcept {
+        parse_options_ = options;
+    }
+
 private:
-    [[nodiscard]] static bool parse_csv_line(const std::string& line, 
-                                              std::vector<std::string>& out_fields);
+    MDLoadStats stats_;
+    CsvParseOptions parse_options_;
 };
 
 } // namespace lob
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "MatchingEngine.h"
+#include "BinaryCapture.h"
+#include "ParallelCsv.h"
+#include "BlockCompression.h"
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <optional>
 
 namespace lob {
@@ -12,7 +16,7 @@ namespace lob {
 // Represents a recorded market data message
 struct MarketDataMessage {
     uint64_t timestamp;    // Nanoseconds since epoch
-    std::string action;    // "ADD", "CANCEL", "REPLACE", "TRADE"
+    MDAction action;
     OrderId order_id;
     Side side;
     Price price;
@@ -20,83 +24,173 @@ struct MarketDataMessage {
     OrderType order_type;
     
     MarketDataMessage() noexcept
-        : timestamp(0), order_id(0), side(Side::Buy), 
+        : timestamp(0), action(MDAction::Unknown), order_id(0), side(Side::Buy), 
           price(), qty(0), order_type(OrderType::Limit) {}
 };
 
+// Loaded messages replayed between book checkpoints by default
+constexpr size_t DEFAULT_CHECKPOINT_INTERVAL = 65536;
+
+// Pull-based message stream for inputs too large to load up front
+class ReplaySource {
+public:
+    virtual ~ReplaySource() = default;
+
+    // Replace batch with the next messages in file order; false at end of stream
+    virtual bool next_batch(std::vector<MarketDataMessage>& batch) = 0;
+
+    // True if the stream stopped on a read or decode error rather than at
+    // its end; meaningful once next_batch has returned false
+    [[nodiscard]] virtual bool failed() const noexcept {
+        return false;
+    }
+};
+
 // Market data replay engine for replaying historical order flow
 class MarketDataReplay {
 public:
     explicit MarketDataReplay(MatchingEngine& engine)
         : engine_(engine) {}
     
-    // Load market data from CSV file
+    // Load market data from CSV file; large files are parsed in parallel
     // CSV format: timestamp,action,order_id,side,price,qty,order_type
-    bool load_from_csv(const std::string& filename, double tick_size) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
+    bool load_from_csv(const std::string& filename, double tick_size,
+                       const CsvParseOptions& options = CsvParseOptions()) {
+        DecodedFile file;
+        if (!file.open(filename, options.threads)) {
             return false;
         }
         
-        messages_.clear();
-        std::string line;
-        
-        // Skip header if present
-        if (std::getline(file, line)) {
-            if (line.find("timestamp") == std::string::npos) {
-                // No header, process this line
-                if (auto msg = parse_csv_line(line, tick_size)) {
-                    messages_.push_back(*msg);
+        const TickScale scale = TickScale::from_double(tick_size);
+        parse_csv_parallel(file.data(), file.size(), messages_,
+            [&](const std::string_view* fields, size_t count, bool first_line,
+                MarketDataMessage& msg) {
+                // Skip header if present
+                if (first_line && fields[0].find("timestamp") != std::string_view::npos) {
+                    return RowStatus::Skip;
                 }
-            }
+                auto parsed = parse_fields(fields, count, scale);
+                if (!parsed) return RowStatus::Bad;
+                msg = std::move(*parsed);
+                return RowStatus::Ok;
+            }, options);
+        
+        return !messages_.empty();
+    }
+    
+    // Replay from a streaming source instead of loaded messages. replay_all
+    // and replay_until then pull batches incrementally; successive
+    // replay_until calls resume where the previous one stopped.
+    void set_source(std::unique_ptr<ReplaySource> source) {
+        source_ = std::move(source);
+        stream_batch_.clear();
+        stream_pos_ = 0;
+        stream_failed_ = false;
+    }
+    
+    // True once the streaming source ended on an error, so the replay
+    // stopped short of the end of the file
+    [[nodiscard]] bool stream_failed() const noexcept {
+        return stream_failed_;
+    }
+    
+    // Replay all remaining messages in order
+    size_t replay_all(std::vector<EngineEvent>* out_events = nullptr) {
+        if (source_) {
+            return replay_stream(UINT64_MAX, out_events);
         }
         
-        // Read data lines
-        while (std::getline(file, line)) {
-            if (auto msg = parse_csv_line(line, tick_size)) {
-                messages_.push_back(*msg);
-            }
+        return advance_to(messages_.size(), out_events);
+    }
+    
+    // Replay messages up to specified timestamp. The cursor persists, so
+    // stepping through a day in slices replays each message once.
+    size_t replay_until(uint64_t timestamp, std::vector<EngineEvent>* out_events = nullptr) {
+        if (source_) {
+            return replay_stream(timestamp, out_events);
         }
         
-        return !messages_.empty();
+        size_t end = cursor_;
+        while (end < messages_.size() && messages_[end].timestamp <= timestamp) {
+            ++end;
+        }
+        return advance_to(end, out_events);
     }
     
-    // Replay all messages in order
-    size_t replay_all(std::vector<EngineEvent>* out_events = nullptr) {
-        size_t processed = 0;
+    // Position the loaded replay just after the last message at or before
+    // timestamp, in either direction. Restores the nearest checkpoint at or
+    // before the target when that saves work (always, when seeking back) and
+    // replays only the gap. Messages must be in timestamp order. Returns
+    // false if seeking back with no checkpoint to restore.
+    bool seek(uint64_t timestamp, std::vector<EngineEvent>* out_events = nullptr) {
+        auto target_it = std::partition_point(messages_.begin(), messages_.end(),
+            [timestamp](const MarketDataMessage& msg) { return msg.timestamp <= timestamp; });
+        size_t target = static_cast<size_t>(target_it - messages_.begin());
         
-        for (const auto& msg : messages_) {
-            if (replay_message(msg)) {
-                ++processed;
+        auto cp = std::upper_bound(checkpoints_.begin(), checkpoints_.end(), target,
+            [](size_t pos, const Checkpoint& c) { return pos < c.position; });
+        const Checkpoint* nearest = cp == checkpoints_.begin() ? nullptr : &*(cp - 1);
+        
+        if (target < cursor_ || (nearest && nearest->position > cursor_)) {
+            if (!nearest) {
+                return false;
             }
-            
-            // Poll events if output vector provided
+            engine_.restore_book(nearest->book);
+            cursor_ = nearest->position;
             if (out_events) {
                 engine_.poll_events(*out_events);
             }
         }
         
-        return processed;
+        advance_to(target, out_events);
+        return true;
     }
     
-    // Replay messages up to specified timestamp
-    size_t replay_until(uint64_t timestamp, std::vector<EngineEvent>* out_events = nullptr) {
-        size_t processed = 0;
+    // Checkpoint the book every `messages` replayed messages (0 disables).
+    // Changing the interval drops existing checkpoints.
+    void set_checkpoint_interval(size_t messages) {
+        checkpoint_interval_ = messages;
+        checkpoints_.clear();
+    }
+    
+    // Number of loaded messages replayed so far
+    [[nodiscard]] size_t position() const noexcept {
+        return cursor_;
+    }
+    
+    [[nodiscard]] size_t checkpoint_count() const noexcept {
+        return checkpoints_.size();
+    }
+    
+    // Replay a binary capture straight from its mapping. An empty symbol
+    // replays every record; otherwise only that symbol's records. Nothing is
+    // replayed if the capture's ticks are not the engine's tick size.
+    size_t replay_capture(const CaptureReader& capture,
+                          std::vector<EngineEvent>* out_events = nullptr,
+                          std::string_view symbol = {}) {
+        if (!(capture.tick_scale() == TickScale::from_double(engine_.config().tick_size))) {
+            return 0;
+        }
         
-        for (const auto& msg : messages_) {
-            if (msg.timestamp > timestamp) {
-                break;
-            }
-            
-            if (replay_message(msg)) {
+        uint32_t symbol_id = 0;
+        bool filter = !symbol.empty();
+        if (filter) {
+            const auto& symbols = capture.symbols();
+            auto it = std::find(symbols.begin(), symbols.end(), symbol);
+            if (it == symbols.end()) return 0;
+            symbol_id = static_cast<uint32_t>(it - symbols.begin());
+        }
+        
+        size_t processed = 0;
+        for (const CaptureRecord& record : capture) {
+            if (filter && record.symbol != symbol_id) continue;
+            if (apply(engine_, record)) {
                 ++processed;
             }
-            
             if (out_events) {
-                engine_.poll_events(*out_events);
+                (void)engine_.poll_events(*out_events);
             }
         }
-        
         return processed;
     }
     
@@ -105,70 +199,178 @@ public:
         return messages_.size();
     }
     
-    // Clear all loaded messages
+    // Clear all loaded messages and reset the cursor
     void clear() noexcept {
         messages_.clear();
+        checkpoints_.clear();
+        cursor_ = 0;
+    }
+    
+    // Apply a single message to an engine
+    static bool apply(MatchingEngine& engine, const MarketDataMessage& msg) {
+        switch (msg.action) {
+            case MDAction::Add: {
+                Order order(msg.order_id, msg.side, msg.price, msg.qty, 
+                           msg.timestamp, msg.order_type);
+                return engine.submit(order);
+            }
+            case MDAction::Cancel:
+                return engine.cancel(msg.order_id);
+            case MDAction::Replace:
+                return engine.replace(msg.order_id, msg.price, msg.qty);
+            default:
+                return false;
+        }
+    }
+    
+    // Apply a capture record; no parsing or allocation on this path
+    static bool apply(MatchingEngine& engine, const CaptureRecord& record) {
+        switch (record.action) {
+            case MDAction::Add: {
+                Order order(record.order_id, record.side, Price(record.price), record.qty, 
+                           record.timestamp, record.order_type);
+                return engine.submit(order);
+            }
+            case MDAction::Cancel:
+                return engine.cancel(record.order_id);
+            case MDAction::Replace:
+                return engine.replace(record.order_id, Price(record.price), record.qty);
+            default:
+                return false;
+        }
+    }
+    
+    static MarketDataMessage to_message(const CaptureRecord& record) noexcept {
+        MarketDataMessage msg;
+        msg.timestamp = record.timestamp;
+        msg.action = record.action;
+        msg.order_id = record.order_id;
+        msg.side = record.side;
+        msg.price = Price(record.price);
+        msg.qty = record.qty;
+        msg.order_type = record.order_type;
+        return msg;
+    }
+    
+    // Parse one line of the replay CSV format
+    static std::optional<MarketDataMessage> parse_csv_line(const std::string& line, double tick_size) {
+        std::string_view fields[MAX_CSV_FIELDS];
+        size_t count = split_csv_line(line, fields);
+        return parse_fields(fields, count, TickScale::from_double(tick_size));
+    }
+    
+    // Parse pre-split, trimmed fields of one replay row. Prices go straight
+    // from decimal text to ticks.
+    static std::optional<MarketDataMessage> parse_fields(const std::string_view* fields, size_t count,
+                                                         const TickScale& scale) {
+        if (count < 6 || fields[0].empty() || fields[0][0] == '#') {
+            return std::nullopt; // Skip short lines and comments
+        }
+        
+        MarketDataMessage msg;
+        if (!parse_uint(fields[0], msg.timestamp) ||
+            !parse_uint(fields[2], msg.order_id) ||
+            !parse_price_ticks(fields[4], scale, msg.price.ticks) ||
+            !parse_uint(fields[5], msg.qty)) {
+            return std::nullopt; // Parse error
+        }
+        
+        msg.action = parse_md_action(fields[1]);
+        msg.side = (fields[3] == "BUY" || fields[3] == "Buy" || fields[3] == "B") 
+                   ? Side::Buy : Side::Sell;
+        
+        if (count > 6) {
+            std::string_view type = fields[6];
+            if (type == "MARKET" || type == "Market") {
+                msg.order_type = OrderType::Market;
+            } else if (type == "IOC") {
+                msg.order_type = OrderType::IOC;
+            } else if (type == "FOK") {
+                msg.order_type = OrderType::FOK;
+            }
+        }
+        
+        return msg;
     }
 
 private:
     bool replay_message(const MarketDataMessage& msg) {
-        if (msg.action == "ADD" || msg.action == "SUBMIT") {
-            Order order(msg.order_id, msg.side, msg.price, msg.qty, 
-                       msg.timestamp, msg.order_type);
-            return engine_.submit(order);
-        } else if (msg.action == "CANCEL") {
-            return engine_.cancel(msg.order_id);
-        } else if (msg.action == "REPLACE") {
-            return engine_.replace(msg.order_id, msg.price, msg.qty);
-        }
-        return false;
+        return apply(engine_, msg);
     }
     
-    std::optional<MarketDataMessage> parse_csv_line(const std::string& line, double tick_size) {
-        if (line.empty() || line[0] == '#') {
-            return std::nullopt; // Skip empty lines and comments
+    // Replay loaded messages [cursor_, end), checkpointing on the way
+    size_t advance_to(size_t end, std::vector<EngineEvent>* out_events) {
+        size_t processed = 0;
+        
+        for (; cursor_ < end; ++cursor_) {
+            if (checkpoint_interval_ && cursor_ % checkpoint_interval_ == 0 &&
+                (checkpoints_.empty() || checkpoints_.back().position < cursor_)) {
+                checkpoints_.push_back({cursor_, engine_.book()});
+            }
+            
+            if (replay_message(messages_[cursor_])) {
+                ++processed;
+            }
+            
+            // Poll events if output vector provided
+            if (out_events) {
+                (void)engine_.poll_events(*out_events);
+            }
         }
         
-        std::istringstream ss(line);
-        std::string field;
-        MarketDataMessage msg;
-        int field_idx = 0;
-        
-        while (std::getline(ss, field, ',')) {
-            try {
-                switch (field_idx) {
-                    case 0: msg.timestamp = std::stoull(field); break;
-                    case 1: msg.action = field; break;
-                    case 2: msg.order_id = std::stoull(field); break;
-                    case 3: 
-                        msg.side = (field == "BUY" || field == "Buy" || field == "B") 
-                                   ? Side::Buy : Side::Sell; 
-                        break;
-                    case 4: msg.price = Price::from_double(std::stod(field), tick_size); break;
-                    case 5: msg.qty = std::stoull(field); break;
-                    case 6: 
-                        if (field == "MARKET" || field == "Market") {
-                            msg.order_type = OrderType::Market;
-                        } else if (field == "IOC") {
-                            msg.order_type = OrderType::IOC;
-                        } else if (field == "FOK") {
-                            msg.order_type = OrderType::FOK;
-                        } else {
-                            msg.order_type = OrderType::Limit;
-                        }
-                        break;
+        return processed;
+    }
+    
+    size_t replay_stream(uint64_t timestamp, std::vector<EngineEvent>* out_events) {
+        size_t processed = 0;
+        
+        while (true) {
+            if (stream_pos_ == stream_batch_.size()) {
+                stream_pos_ = 0;
+                if (!source_->next_batch(stream_batch_)) {
+                    stream_batch_.clear();
+                    stream_failed_ = source_->failed();
+                    break;
                 }
-                ++field_idx;
-            } catch (...) {
-                return std::nullopt; // Parse error
+                continue;
+            }
+            
+            const MarketDataMessage& msg = stream_batch_[stream_pos_];
+            if (msg.timestamp > timestamp) {
+                break;
+            }
+            ++stream_pos_;
+            
+            if (replay_message(msg)) {
+                ++processed;
+            }
+            
+            if (out_events) {
+                (void)engine_.poll_events(*out_events);
             }
         }
         
-        return field_idx >= 6 ? std::optional<MarketDataMessage>(msg) : std::nullopt;
+        return processed;
     }
     
     MatchingEngine& engine_;
     std::vector<MarketDataMessage> messages_;
+    
+    // Book state before messages_[position] was replayed
+    struct Checkpoint {
+        size_t position;
+        LimitBook book;
+    };
+    
+    size_t cursor_ = 0;                 // Next loaded message to replay
+    size_t checkpoint_interval_ = DEFAULT_CHECKPOINT_INTERVAL;
+    std::vector<Checkpoint> checkpoints_;
+    
+    // Streaming state; stream_pos_ indexes the next unreplayed message
+    std::unique_ptr<ReplaySource> source_;
+    std::vector<MarketDataMessage> stream_batch_;
+    size_t stream_pos_ = 0;
+    bool stream_failed_ = false;
 };
 
 } // namespace lob
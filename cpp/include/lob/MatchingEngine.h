@@ -1,19 +1,51 @@
 #pragma once
 
 #include "Config.h"
+#include "Affinity.h"
+#include "EventHash.h"
 #include "LimitBook.h"
 #include "Events.h"
 #include "TimeSource.h"
 #include "RingBuffer.h"
+#include "SeqLock.h"
+#include "WaitStrategy.h"
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <vector>
 #include <variant>
 
 namespace lob {
 
+class Journal;
+class ReplicationPrimary;
+class SharedEventRing;
+
 // Unified event type for all engine events
 using EngineEvent = std::variant<TradeEvent, AcceptEvent, RejectEvent, 
-                                  CancelEvent, ReplaceEvent, BookTop>;
+                                  CancelEvent, ReplaceEvent, BookTop, LevelUpdate>;
+
+// Engine event tagged with its position in the engine's output stream.
+// Sequence numbers start at 1 and are assigned to every emitted event,
+// including dropped ones, so consumers can detect gaps.
+struct SequencedEvent {
+    uint64_t seq;
+    EngineEvent event;
+
+    SequencedEvent() noexcept : seq(0), event() {}
+    SequencedEvent(uint64_t s, const EngineEvent& e) noexcept : seq(s), event(e) {}
+};
+
+// Event ring accounting, readable from any thread
+struct EventStats {
+    uint64_t emitted = 0;      // Events produced (== last assigned sequence number)
+    uint64_t dropped = 0;      // Events lost under OverflowPolicy::Drop
+    uint64_t spilled = 0;      // Events routed through the overflow segment
+    uint64_t blocked = 0;      // Pushes that had to wait under OverflowPolicy::Block
+    uint64_t spill_depth = 0;  // Events currently waiting in the overflow segment
+};
 
 class MatchingEngine {
 public:
@@ -29,9 +61,95 @@ public:
     // Replace existing order (modify price and/or quantity)
     [[nodiscard]] bool replace(OrderId id, Price new_price, uint64_t new_qty);
 
+    // Replace the book with an earlier copy of book() (e.g. a replay
+    // checkpoint) and emit the resulting top of book. Matcher thread only.
+    void restore_book(const LimitBook& book);
+
+    // Emit a full LevelUpdate snapshot (SnapshotStart, then every level) so
+    // L2 subscribers can (re)build their book. Matcher thread only.
+    void emit_depth_snapshot();
+
+    // Record a full order snapshot (Clear, then an Add per resting order)
+    // on the order-update feed so L3 subscribers can (re)build their book.
+    // Matcher thread only; no-op unless config.order_updates is set.
+    void emit_order_snapshot();
+
+    // Write the resting book and event sequence counter to a snapshot file
+    [[nodiscard]] bool save_snapshot(const std::string& filename) const;
+
+    // Warm start from save_snapshot output: bulk-loads resting orders in
+    // queue order without matching, resumes the event sequence and emits
+    // the restored top of book. Matcher thread only; false leaves the
+    // engine unchanged.
+    [[nodiscard]] bool load_snapshot(const std::string& filename);
+
     // Poll for events from the engine
     [[nodiscard]] bool poll_events(std::vector<EngineEvent>& out_events);
 
+    // Poll for events along with their sequence numbers (gaps mark drops)
+    [[nodiscard]] bool poll_sequenced(std::vector<SequencedEvent>& out_events);
+
+    // Take the order-by-order (L3) updates recorded since the last call.
+    // They travel on their own ring with their own sequence numbers, and a
+    // full ring drops updates there (see order_updates_dropped). One
+    // consumer thread.
+    [[nodiscard]] bool poll_order_updates(std::vector<OrderUpdate>& out_updates);
+
+    [[nodiscard]] uint64_t order_updates_dropped() const noexcept {
+        return order_updates_dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Wait (per the configured strategy) until events are available, then
+    // poll them. Returns false if the timeout elapsed with nothing to read.
+    [[nodiscard]] bool wait_events(std::vector<EngineEvent>& out_events,
+                                   std::chrono::nanoseconds timeout);
+
+    // Set how wait_events consumers wait; must be set before a consumer
+    // thread starts. Defaults to BlockingWait.
+    void set_wait_strategy(std::shared_ptr<WaitStrategy> strategy) noexcept {
+        wait_strategy_ = strategy ? std::move(strategy) : std::make_shared<BlockingWait>();
+    }
+
+    // Journal every command and event from now on; nullptr detaches. Set
+    // before the matcher thread starts.
+    void set_journal(std::shared_ptr<Journal> journal) noexcept {
+        journal_ = std::move(journal);
+    }
+
+    // Stream every command from now on to a replica; nullptr detaches.
+    // Set before the matcher thread starts.
+    void set_replication(std::shared_ptr<ReplicationPrimary> primary) noexcept {
+        replication_ = std::move(primary);
+    }
+
+    // Also publish every event to a shared-memory ring for another process;
+    // a full ring drops the event there (see SharedEventRing::dropped)
+    // without affecting in-process consumers. nullptr detaches. Set before
+    // the matcher thread starts.
+    void set_event_ring(std::shared_ptr<SharedEventRing> ring) noexcept {
+        event_ring_ = std::move(ring);
+    }
+
+    // Fold every event emitted from now on into a rolling hash, recording
+    // a checkpoint every config.checkpoint_interval sequence numbers. Set
+    // before the matcher thread starts.
+    void enable_event_hash(const EventHashConfig& config = EventHashConfig());
+
+    // Hash as of the last completed command (seq 0 if hashing is off or
+    // nothing was emitted yet). Safe to call from any thread.
+    [[nodiscard]] HashCheckpoint event_hash() const noexcept {
+        HashCheckpoint out;
+        published_hash_.read(out);
+        return out;
+    }
+
+    // Checkpoints recorded so far with seq >= from_seq, in sequence order.
+    // Safe to call from any thread.
+    [[nodiscard]] std::vector<HashCheckpoint> hash_checkpoints(uint64_t from_seq = 0) const;
+
+    // Snapshot of event ring counters
+    [[nodiscard]] EventStats event_stats() const noexcept;
+
     // Get const reference to order book
     [[nodiscard]] const LimitBook& book() const noexcept {
         return book_;
@@ -47,6 +165,27 @@ public:
         book_.get_depth(out, max_levels);
     }
 
+    // Consistent top-of-book as of the last completed command. Safe to call
+    // from any number of threads concurrently with the matcher.
+    void snapshot_top(BookTop& out) const noexcept {
+        published_top_.read(out);
+    }
+
+    // Consistent depth (config().published_depth levels per side) as of the
+    // last completed command. Safe to call from any thread.
+    void snapshot_depth(FixedDepth& out) const noexcept {
+        published_depth_.read(out);
+    }
+
+    // Number of book states published so far
+    [[nodiscard]] uint64_t snapshot_version() const noexcept {
+        return published_top_.version();
+    }
+
+    [[nodiscard]] const std::shared_ptr<TimeSource>& time_source() const noexcept {
+        return time_source_;
+    }
+
     // Get current timestamp
     [[nodiscard]] uint64_t now() const noexcept {
         return time_source_->now_ns();
@@ -56,13 +195,78 @@ public:
         return config_;
     }
 
+    // Pin the calling thread to the core configured for the given role
+    [[nodiscard]] bool pin_thread(ThreadRole role) const noexcept;
+
+    // NUMA node engine memory was allocated on, or -1 if unplaced
+    [[nodiscard]] int numa_node() const noexcept {
+        return numa_node_;
+    }
+
 private:
     void emit_event(const EngineEvent& event);
+    void publish() noexcept;
+    void publish_book(const BookTop& top) noexcept;
+    void emit_level_updates();
+    void emit_snapshot_levels();
+    void forward_order_updates() noexcept;
+    void spill_event(const SequencedEvent& event);
+
+    template<typename Sink>
+    void drain_events(Sink&& sink);
 
     EngineConfig config_;
+    int numa_node_;
+
+    // Active only while the members below are constructed, so the ring
+    // and book allocations land on the matcher's node
+    ScopedNumaPolicy numa_scope_;
+
     std::shared_ptr<TimeSource> time_source_;
     LimitBook book_;
-    RingBuffer<EngineEvent> event_buffer_;
+    RingBuffer<SequencedEvent> event_buffer_;
+    std::shared_ptr<WaitStrategy> wait_strategy_;
+    std::shared_ptr<Journal> journal_;
+    std::shared_ptr<ReplicationPrimary> replication_;
+    std::shared_ptr<SharedEventRing> event_ring_;
+
+    // Book state for lock-free readers on other threads
+    SeqLock<BookTop> published_top_;
+    SeqLock<FixedDepth> published_depth_;
+    FixedDepth depth_scratch_;
+
+    // Producer-owned sequence counter
+    uint64_t next_seq_ = 1;
+
+    // Incremental depth feed state (config_.level_updates)
+    uint64_t level_seq_ = 0;
+    uint64_t commands_since_snapshot_ = 0;
+    std::vector<LevelUpdate> level_scratch_;
+
+    // Order-by-order feed (config_.order_updates): the book records each
+    // command's updates, which are moved onto this ring when it completes
+    std::unique_ptr<RingBuffer<OrderUpdate>> order_ring_;
+    std::vector<OrderUpdate> order_scratch_;
+    std::atomic<uint64_t> order_updates_dropped_{0};
+
+    // Optional rolling event hash; the hasher is matcher-owned, readers go
+    // through published_hash_ and the mutex-guarded checkpoint list
+    bool hashing_ = false;
+    EventHasher hasher_;
+    SeqLock<HashCheckpoint> published_hash_;
+    std::vector<HashCheckpoint> hash_checkpoints_;
+    mutable std::mutex hash_mutex_;
+
+    // Overflow segment for OverflowPolicy::Spill. Only touched on the slow
+    // path; while it holds events every new event is appended behind them.
+    std::deque<SequencedEvent> spill_;
+    mutable std::mutex spill_mutex_;
+    std::atomic<bool> spilling_{false};
+
+    std::atomic<uint64_t> emitted_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> spilled_{0};
+    std::atomic<uint64_t> blocked_{0};
 };
 
 } // namespace lob
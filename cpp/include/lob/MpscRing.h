@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace lob {
+
+// Bounded lock-free multi-producer single-consumer queue. Each slot
+// carries a sequence number that tells producers and the consumer whose
+// turn it is, so a producer claims a slot with one CAS on the tail and
+// never waits on the consumer; a full ring refuses the push. With a single
+// producer the CAS always succeeds first time.
+//
+// Items move in and out by swap: the pusher gets back whatever the slot
+// held before, and the consumer hands its old item to the slot. For types
+// that own buffers (strings, vectors) the buffers circulate between the
+// threads, so a steady stream of pushes allocates nothing.
+template<typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity)
+        : capacity_(next_power_of_two(capacity))
+        , mask_(capacity_ - 1)
+        , slots_(new Slot[capacity_]) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // Producer side, any thread. Swaps item into the ring; false (item
+    // untouched) if the ring is full.
+    [[nodiscard]] bool try_push(T& item) noexcept {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const size_t seq = slot.seq.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    using std::swap;
+                    swap(slot.value, item);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;   // Consumer has not freed this slot yet
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer side. Swaps the oldest item into out; false if empty (or
+    // the next producer has claimed its slot but not finished writing).
+    [[nodiscard]] bool try_pop(T& out) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[head & mask_];
+        if (slot.seq.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        using std::swap;
+        swap(out, slot.value);
+        slot.seq.store(head + capacity_, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Pop up to count items into out[0..count); returns how many
+    size_t pop_batch(T* out, size_t count) noexcept {
+        size_t n = 0;
+        while (n < count && try_pop(out[n])) {
+            ++n;
+        }
+        return n;
+    }
+
+    // Consumer side
+    [[nodiscard]] bool empty() const noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        return slots_[head & mask_].seq.load(std::memory_order_acquire) != head + 1;
+    }
+
+    // Approximate when called concurrently with producers
+    [[nodiscard]] size_t size() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    static size_t next_power_of_two(size_t n) noexcept {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> tail_{0};   // Next slot producers claim
+    alignas(64) std::atomic<size_t> head_{0};   // Next slot the consumer reads
+};
+
+} // namespace lob
@@ -4,6 +4,8 @@
 #include <unordered_map>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
 
 namespace lob {
@@ -31,6 +33,30 @@ public:
         return true;
     }
     
+    // Add a new symbol using the default config with its own placement,
+    // e.g. to spread books across cores and NUMA nodes
+    bool add_symbol(const SymbolId& symbol, const ThreadPlacement& placement) {
+        EngineConfig config = default_config_;
+        config.placement = placement;
+        return add_symbol(symbol, &config);
+    }
+    
+    // Config used for symbols added without one
+    [[nodiscard]] const EngineConfig& default_config() const noexcept {
+        return default_config_;
+    }
+    
+    // Placement of a symbol's engine, or nullopt if unknown. Returned by
+    // value: the engine may be removed as soon as the lock is released.
+    [[nodiscard]] std::optional<ThreadPlacement> placement(const SymbolId& symbol) const {
+        std::shared_lock lock(mutex_);
+        auto it = engines_.find(symbol);
+        if (it == engines_.end()) {
+            return std::nullopt;
+        }
+        return it->second->config().placement;
+    }
+    
     // Remove a symbol and its order book
     bool remove_symbol(const SymbolId& symbol) {
         std::unique_lock lock(mutex_);
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CsvScanner.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+// Result of a parse_row callback
+enum class RowStatus : uint8_t {
+    Skip = 0,   // Header, blank line or comment
+    Ok = 1,     // Record produced
+    Bad = 2     // Malformed row
+};
+
+struct CsvParseOptions {
+    size_t threads = 0;                  // Worker threads (0 = hardware concurrency)
+    size_t min_chunk_bytes = 1 << 20;    // Smallest chunk worth handing to a thread
+};
+
+struct CsvParseStats {
+    size_t lines = 0;
+    size_t loaded = 0;
+    size_t bad_rows = 0;
+    size_t first_bad_line = 0;  // 1-based, 0 = none
+};
+
+// Split [data, data + size) into about `target` ranges that each end just
+// after a newline (or at end of input)
+inline std::vector<std::pair<size_t, size_t>> split_at_newlines(const char* data, size_t size,
+                                                                size_t target) {
+    std::vector<std::pair<size_t, size_t>> chunks;
+    size_t step = target ? (size + target - 1) / target : size;
+    size_t begin = 0;
+    while (begin < size) {
+        size_t end = std::min(size, begin + std::max<size_t>(step, 1));
+        if (end < size) {
+            const void* nl = std::memchr(data + end - 1, '\n', size - end + 1);
+            end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data) + 1 : size;
+        }
+        chunks.emplace_back(begin, end);
+        begin = end;
+    }
+    return chunks;
+}
+
+// Parse CSV rows concurrently. The input is cut into newline-aligned chunks
+// that are parsed on a work-stealing pool into per-chunk record buffers,
+// then moved into place in file order, also in parallel. Records stay
+// row-shaped because every consumer (replay, the feed loaders, capture
+// conversion) takes rows; a column layout would need a transpose pass back.
+// parse_row(fields, count, first_line, record) is called once per row;
+// first_line is true only for the first line of the input.
+template<typename Record, typename ParseRow>
+CsvParseStats parse_csv_parallel(const char* data, size_t size, std::vector<Record>& out,
+                                 ParseRow&& parse_row,
+                                 const CsvParseOptions& options = CsvParseOptions()) {
+    struct Chunk {
+        std::vector<Record> records;
+        CsvParseStats stats;
+    };
+    
+    WorkStealingPool pool(options.threads);
+    size_t min_chunk = std::max<size_t>(options.min_chunk_bytes, 1);
+    size_t target = std::max<size_t>(1, std::min(pool.num_threads() * 4, size / min_chunk));
+    auto ranges = split_at_newlines(data, size, target);
+    std::vector<Chunk> chunks(ranges.size());
+    
+    std::vector<WorkStealingPool::Task> tasks;
+    tasks.reserve(ranges.size());
+    for (size_t c = 0; c < ranges.size(); ++c) {
+        tasks.emplace_back([&, c] {
+            Chunk& chunk = chunks[c];
+            size_t begin = ranges[c].first;
+            size_t len = ranges[c].second - begin;
+            chunk.records.reserve(len / 32);
+            for_each_csv_row(data + begin, len,
+                             [&](const std::string_view* fields, size_t count, size_t line_no) {
+                chunk.stats.lines = line_no;
+                Record record;
+                switch (parse_row(fields, count, c == 0 && line_no == 1, record)) {
+                    case RowStatus::Ok:
+                        chunk.records.push_back(std::move(record));
+                        ++chunk.stats.loaded;
+                        break;
+                    case RowStatus::Bad:
+                        if (chunk.stats.bad_rows == 0) chunk.stats.first_bad_line = line_no;
+                        ++chunk.stats.bad_rows;
+                        break;
+                    case RowStatus::Skip:
+                        break;
+                }
+            });
+        });
+    }
+    pool.run(tasks);
+    
+    // Turn chunk-relative line numbers absolute and find each chunk's slot
+    CsvParseStats total;
+    std::vector<size_t> offsets(chunks.size());
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        const CsvParseStats& stats = chunks[c].stats;
+        if (stats.bad_rows > 0 && total.bad_rows == 0) {
+            total.first_bad_line = total.lines + stats.first_bad_line;
+        }
+        offsets[c] = total.loaded;
+        total.loaded += stats.loaded;
+        total.bad_rows += stats.bad_rows;
+        total.lines += stats.lines;
+    }
+    
+    if (chunks.size() == 1) {
+        out.swap(chunks[0].records);
+        return total;
+    }
+    
+    // Stitch in file order, each chunk moved into its slot by a worker
+    out.clear();
+    out.resize(total.loaded);
+    tasks.clear();
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        tasks.emplace_back([&, c] {
+            std::vector<Record>& records = chunks[c].records;
+            std::move(records.begin(), records.end(), out.begin() + offsets[c]);
+            std::vector<Record>().swap(records);
+        });
+    }
+    pool.run(tasks);
+    return total;
+}
+
+} // namespace lob
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "MarketDataReplay.h"
+#include "MultiSymbolEngine.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lob {
+
+// Engine event tagged with the message and symbol that produced it
+struct ReplayEvent {
+    uint64_t timestamp;      // Timestamp of the originating message
+    uint32_t symbol_index;   // Index into ParallelReplay::symbols()
+    EngineEvent event;
+};
+
+// Replays a multi-symbol capture into a MultiSymbolEngine in parallel.
+// Messages are partitioned by symbol; each symbol's stream is replayed in
+// order by a single task on a work-stealing pool, and per-symbol outputs
+// are merged by (timestamp, symbol) so the result does not depend on
+// thread scheduling.
+class ParallelReplay {
+public:
+    explicit ParallelReplay(MultiSymbolEngine& engine, size_t num_threads = 0)
+        : engine_(engine), pool_(num_threads) {}
+    
+    // Append a message to a symbol's stream
+    void add_message(const SymbolId& symbol, const MarketDataMessage& msg) {
+        auto [it, inserted] = stream_index_.try_emplace(symbol, streams_.size());
+        if (inserted) {
+            streams_.push_back({symbol, {}});
+        }
+        streams_[it->second].messages.push_back(msg);
+        ++message_count_;
+    }
+    
+    // Load a multi-symbol capture
+    // CSV format: timestamp,symbol,action,order_id,side,price,qty,order_type
+    bool load_from_csv(const std::string& filename, double tick_size,
+                       const CsvParseOptions& options = CsvParseOptions()) {
+        DecodedFile file;
+        if (!file.open(filename, options.threads)) {
+            return false;
+        }
+        
+        clear();
+        const TickScale scale = TickScale::from_double(tick_size);
+        std::vector<std::pair<SymbolId, MarketDataMessage>> rows;
+        parse_csv_parallel(file.data(), file.size(), rows,
+            [&](const std::string_view* fields, size_t count, bool first_line,
+                std::pair<SymbolId, MarketDataMessage>& row) {
+                if (count < 2) return RowStatus::Skip;
+                if (first_line && fields[0].find("timestamp") != std::string_view::npos) {
+                    return RowStatus::Skip;
+                }
+                
+                // Drop the symbol column and parse the rest as a plain replay row
+                std::string_view rest[MAX_CSV_FIELDS];
+                rest[0] = fields[0];
+                for (size_t i = 2; i < count; ++i) {
+                    rest[i - 1] = fields[i];
+                }
+                auto msg = MarketDataReplay::parse_fields(rest, count - 1, scale);
+                if (!msg) return RowStatus::Bad;
+                row.first.assign(fields[1].data(), fields[1].size());
+                row.second = std::move(*msg);
+                return RowStatus::Ok;
+            }, options);
+        
+        for (const auto& [symbol, msg] : rows) {
+            add_message(symbol, msg);
+        }
+        return message_count_ > 0;
+    }
+    
+    // Load a binary capture; records are bucketed by their symbol id. Fails
+    // if the capture's ticks are not the tick size of the engine (default
+    // config, or an existing symbol's own config) that would replay them.
+    bool load_from_capture(const CaptureReader& capture) {
+        clear();
+        const auto& symbols = capture.symbols();
+        const TickScale scale = capture.tick_scale();
+        if (!(scale == TickScale::from_double(engine_.default_config().tick_size))) {
+            return false;
+        }
+        for (const SymbolId& symbol : symbols) {
+            const MatchingEngine* existing = engine_.get_engine(symbol);
+            if (existing && !(scale == TickScale::from_double(existing->config().tick_size))) {
+                return false;
+            }
+        }
+        
+        for (const CaptureRecord& record : capture) {
+            if (record.symbol >= symbols.size()) continue;
+            add_message(symbols[record.symbol], MarketDataReplay::to_message(record));
+        }
+        return message_count_ > 0;
+    }
+    
+    // Replay every symbol's stream; returns the number of accepted messages.
+    // If out_events is given it receives all engine events in merged order.
+    size_t replay_all(std::vector<ReplayEvent>* out_events = nullptr) {
+        sort_symbols();
+        
+        // Resolve engines up front so tasks never touch the symbol map
+        std::vector<MatchingEngine*> engines(streams_.size());
+        for (size_t i = 0; i < streams_.size(); ++i) {
+            engine_.add_symbol(streams_[i].symbol);
+            engines[i] = engine_.get_engine(streams_[i].symbol);
+        }
+        
+        std::vector<size_t> processed(streams_.size(), 0);
+        std::vector<std::vector<ReplayEvent>> outputs(out_events ? streams_.size() : 0);
+        
+        // Largest streams first for better load balance
+        std::vector<size_t> order(streams_.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return streams_[a].messages.size() > streams_[b].messages.size();
+        });
+        
+        std::vector<WorkStealingPool::Task> tasks;
+        tasks.reserve(order.size());
+        for (size_t idx : order) {
+            tasks.emplace_back([&, idx] {
+                MatchingEngine& engine = *engines[idx];
+                std::vector<EngineEvent> batch;
+                for (const auto& msg : streams_[idx].messages) {
+                    if (MarketDataReplay::apply(engine, msg)) {
+                        ++processed[idx];
+                    }
+                    if (out_events && engine.poll_events(batch)) {
+                        for (const auto& e : batch) {
+                            outputs[idx].push_back({msg.timestamp, static_cast<uint32_t>(idx), e});
+                        }
+                    }
+                }
+            });
+        }
+        pool_.run(tasks);
+        
+        if (out_events) {
+            merge(outputs, *out_events);
+        }
+        
+        size_t total = 0;
+        for (size_t n : processed) total += n;
+        return total;
+    }
+    
+    // Symbols in the order used by ReplayEvent::symbol_index
+    [[nodiscard]] const std::vector<SymbolId>& symbols() {
+        sort_symbols();
+        return symbols_;
+    }
+    
+    [[nodiscard]] size_t message_count() const noexcept {
+        return message_count_;
+    }
+    
+    [[nodiscard]] size_t symbol_count() const noexcept {
+        return streams_.size();
+    }
+    
+    [[nodiscard]] const WorkStealingPool& pool() const noexcept {
+        return pool_;
+    }
+    
+    void clear() noexcept {
+        streams_.clear();
+        stream_index_.clear();
+        symbols_.clear();
+        message_count_ = 0;
+    }
+
+private:
+    struct SymbolStream {
+        SymbolId symbol;
+        std::vector<MarketDataMessage> messages;
+    };
+    
+    // Order streams by symbol name so indices are stable across runs
+    void sort_symbols() {
+        if (symbols_.size() == streams_.size()) return;
+        std::sort(streams_.begin(), streams_.end(),
+                  [](const SymbolStream& a, const SymbolStream& b) { return a.symbol < b.symbol; });
+        symbols_.clear();
+        for (size_t i = 0; i < streams_.size(); ++i) {
+            stream_index_[streams_[i].symbol] = i;
+            symbols_.push_back(streams_[i].symbol);
+        }
+    }
+    
+    // K-way merge on (timestamp, symbol_index); each symbol's own order is
+    // preserved even if its timestamps are not monotonic
+    static void merge(std::vector<std::vector<ReplayEvent>>& outputs, 
+                      std::vector<ReplayEvent>& out) {
+        out.clear();
+        size_t total = 0;
+        for (const auto& o : outputs) total += o.size();
+        out.reserve(total);
+        
+        using Head = std::pair<uint64_t, uint32_t>;
+        std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+        std::vector<size_t> pos(outputs.size(), 0);
+        for (size_t i = 0; i < outputs.size(); ++i) {
+            if (!outputs[i].empty()) {
+                heads.emplace(outputs[i][0].timestamp, static_cast<uint32_t>(i));
+            }
+        }
+        
+        while (!heads.empty()) {
+            uint32_t idx = heads.top().second;
+            heads.pop();
+            auto& src = outputs[idx];
+            out.push_back(std::move(src[pos[idx]++]));
+            if (pos[idx] < src.size()) {
+                heads.emplace(src[pos[idx]].timestamp, idx);
+            }
+        }
+    }
+    
+    MultiSymbolEngine& engine_;
+    WorkStealingPool pool_;
+    std::vector<SymbolStream> streams_;
+    std::unordered_map<SymbolId, size_t> stream_index_;
+    std::vector<SymbolId> symbols_;
+    size_t message_count_ = 0;
+};
+
+} // namespace lob
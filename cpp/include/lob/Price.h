@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <compare>
 #include <functional>
+#include <string_view>
 
 namespace lob {
 
@@ -29,6 +31,49 @@ struct Price {
 
 constexpr Price INVALID_PRICE{-1};
 
+// Tick size as an exact decimal: tick = units * 10^-decimals
+// (e.g. 0.01 -> {1, 2}, 0.0025 -> {25, 4})
+struct TickScale {
+    int64_t units;
+    uint8_t decimals;
+
+    constexpr TickScale() noexcept : units(1), decimals(2) {}
+    constexpr TickScale(int64_t u, uint8_t d) noexcept : units(u), decimals(d) {}
+
+    // Parse a decimal tick size such as "0.05"
+    [[nodiscard]] static bool parse(std::string_view text, TickScale& out) noexcept;
+
+    // Recover the decimal form of a double tick size (up to 9 decimals)
+    [[nodiscard]] static TickScale from_double(double tick_size) noexcept;
+
+    // Same tick size, whatever the trailing zeros ({10, 3} == {1, 2})
+    [[nodiscard]] constexpr TickScale normalized() const noexcept {
+        TickScale out = *this;
+        while (out.decimals > 0 && out.units % 10 == 0) {
+            out.units /= 10;
+            --out.decimals;
+        }
+        return out;
+    }
+
+    constexpr bool operator==(const TickScale& other) const noexcept {
+        const TickScale a = normalized();
+        const TickScale b = other.normalized();
+        return a.units == b.units && a.decimals == b.decimals;
+    }
+};
+
+// Convert decimal text such as "100.0500" straight to integer ticks without
+// going through floating point. Rounds half away from zero to the nearest
+// tick. Returns false on malformed input or overflow.
+[[nodiscard]] bool parse_price_ticks(std::string_view text, const TickScale& scale,
+                                     int64_t& out_ticks) noexcept;
+
+// Convert a column of decimal strings. Entries that fail become
+// INVALID_PRICE; returns the number of failures.
+size_t parse_price_column(const std::string_view* texts, size_t count,
+                          const TickScale& scale, Price* out) noexcept;
+
 } // namespace lob
 
 // Hash support for Price
@@ -0,0 +1,316 @@
+#pragma once
+
+#include "MatchingEngine.h"
+#include "Journal.h"
+#include "TimeSource.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// Largest message any transport carries; a longer length prefix on the
+// receiving side means the stream is corrupt
+constexpr size_t REPLICATION_MAX_MESSAGE = 64 << 20;
+
+// Moves whole messages from a primary to a replica, in order. Each side is
+// used by one thread.
+class ReplicationTransport {
+public:
+    virtual ~ReplicationTransport() = default;
+
+    // Send one message; false if the transport is broken or full
+    virtual bool send(const char* data, size_t size) = 0;
+
+    // Receive the next message into out, waiting up to timeout. False if
+    // nothing arrived in time, the transport is closed or it has failed.
+    virtual bool receive(std::vector<char>& out, std::chrono::microseconds timeout) = 0;
+
+    // Largest message send() can ever take and receive() will accept
+    [[nodiscard]] virtual size_t max_message_size() const noexcept {
+        return REPLICATION_MAX_MESSAGE;
+    }
+
+    // True once receive() read a length prefix over max_message_size() (or
+    // past the data written); the stream cannot be resynchronized
+    [[nodiscard]] bool failed() const noexcept {
+        return failed_;
+    }
+
+protected:
+    bool failed_ = false;
+};
+
+// Stream over a Unix domain socket. The primary listens and accepts one
+// replica; in-process pairs come from make_pair.
+//
+// Sends never block the matcher: when the socket buffer is full, send()
+// writes what fits and returns false, and the same message must be offered
+// again to finish it (ReplicationPrimary retries its oldest frame).
+class UnixSocketTransport : public ReplicationTransport {
+public:
+    UnixSocketTransport() = default;
+    ~UnixSocketTransport() override { close(); }
+
+    UnixSocketTransport(const UnixSocketTransport&) = delete;
+    UnixSocketTransport& operator=(const UnixSocketTransport&) = delete;
+
+    // Bind and listen at path (replacing a stale socket file)
+    [[nodiscard]] bool listen(const std::string& path);
+
+    // Wait for the replica to connect
+    [[nodiscard]] bool accept(std::chrono::milliseconds timeout);
+
+    [[nodiscard]] bool connect(const std::string& path);
+
+    // Two connected ends in this process
+    [[nodiscard]] static bool make_pair(std::shared_ptr<UnixSocketTransport>& a,
+                                        std::shared_ptr<UnixSocketTransport>& b);
+
+    void close() noexcept;
+
+    bool send(const char* data, size_t size) override;
+    bool receive(std::vector<char>& out, std::chrono::microseconds timeout) override;
+
+private:
+    int fd_ = -1;
+    int listen_fd_ = -1;
+    size_t sent_ = 0;       // Bytes of a refused message already written
+    std::string path_;
+};
+
+// Single-producer/single-consumer byte ring in a named POSIX shared memory
+// object. The creator owns (and unlinks) the object; the other side opens
+// it by name. Sends fail rather than wait when the ring is full.
+class SharedMemoryTransport : public ReplicationTransport {
+public:
+    SharedMemoryTransport() = default;
+    ~SharedMemoryTransport() override { close(); }
+
+    SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+    SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+    // Create a ring of capacity bytes (rounded up to a power of two)
+    [[nodiscard]] bool create(const std::string& name, size_t capacity);
+
+    // Attach to a ring made by create
+    [[nodiscard]] bool open(const std::string& name);
+
+    void close() noexcept;
+
+    bool send(const char* data, size_t size) override;
+    bool receive(std::vector<char>& out, std::chrono::microseconds timeout) override;
+
+    // A message and its length prefix must fit in the ring
+    [[nodiscard]] size_t max_message_size() const noexcept override;
+
+private:
+    struct Control;
+
+    void copy_in(uint64_t pos, const void* src, size_t size) noexcept;
+    void copy_out(uint64_t pos, void* dst, size_t size) const noexcept;
+
+    Control* control_ = nullptr;
+    char* ring_ = nullptr;
+    size_t mapped_ = 0;
+    uint64_t mask_ = 0;
+    std::string name_;
+    bool owner_ = false;
+};
+
+// Messages appended to a file, which the replica tails. Doubles as a
+// replayable record of the primary's inbound flow.
+class FileTransport : public ReplicationTransport {
+public:
+    FileTransport() = default;
+    ~FileTransport() override { close(); }
+
+    FileTransport(const FileTransport&) = delete;
+    FileTransport& operator=(const FileTransport&) = delete;
+
+    // Writer side: create (or truncate) the file
+    [[nodiscard]] bool create(const std::string& path);
+
+    // Reader side: tail an existing file from the start
+    [[nodiscard]] bool open(const std::string& path);
+
+    void close() noexcept;
+
+    bool send(const char* data, size_t size) override;
+    bool receive(std::vector<char>& out, std::chrono::microseconds timeout) override;
+
+private:
+    int fd_ = -1;
+    uint64_t read_pos_ = 0;
+};
+
+// Wire format of one batch (native byte order):
+//   ReplicationFrameHeader | (ReplicationCommandHeader | payload)...
+// Payloads are the journal's command records (Order, CancelCommand,
+// ReplaceCommand).
+struct ReplicationFrameHeader {
+    uint32_t magic;         // REPLICATION_MAGIC
+    uint32_t count;         // Commands in the frame
+    uint64_t first_seq;     // Command sequence number of the first command
+    uint64_t hash_seq;      // Primary event hash after the last command
+    uint64_t hash;          //   (hash_seq 0 = primary not hashing)
+};
+static_assert(sizeof(ReplicationFrameHeader) == 32, "ReplicationFrameHeader layout is part of the wire format");
+
+struct ReplicationCommandHeader {
+    JournalCommand type;
+    uint8_t reserved[7];
+    uint64_t stamp;         // Primary clock at the start of the command
+};
+static_assert(sizeof(ReplicationCommandHeader) == 16, "ReplicationCommandHeader layout is part of the wire format");
+
+constexpr uint32_t REPLICATION_MAGIC = 0x4c4f4252;  // "RBOL"
+
+struct ReplicationConfig {
+    size_t batch_bytes = 16 << 10;              // Send once a batch reaches this size (capped at
+                                                //   the transport's max_message_size())
+    std::chrono::microseconds max_delay{200};   // maybe_flush() sends batches older than this
+};
+
+struct PrimaryStats {
+    uint64_t commands = 0;      // Commands recorded
+    uint64_t sent_seq = 0;      // Last command handed to the transport
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t send_failures = 0; // Sends the transport refused; the frame is kept and retried
+    uint64_t pending_frames = 0;// Frames waiting for the transport to take them
+};
+
+// Primary side. Attach with MatchingEngine::set_replication: the engine
+// records each command before executing it, so the stream is the exact
+// inbound order including rejected commands. Recording is a memcpy into
+// the open batch; the transport is only touched once per batch.
+//
+// Each command carries the primary's clock at its start. If the engine
+// runs on a LatchedTimeSource the primary latches it per command, so every
+// timestamp within a command is that stamp and a replica reproduces the
+// event stream bit for bit; with a free-running clock only the
+// non-timestamp fields are guaranteed to match.
+class ReplicationPrimary {
+public:
+    ReplicationPrimary(const MatchingEngine& engine, std::shared_ptr<ReplicationTransport> transport,
+                       const ReplicationConfig& config = ReplicationConfig());
+
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+    // Called by the engine on the matcher thread
+    void append_submit(const Order& order) noexcept {
+        append(JournalCommand::Submit, &order, sizeof(order));
+    }
+
+    void append_cancel(OrderId id) noexcept {
+        CancelCommand cmd{id};
+        append(JournalCommand::Cancel, &cmd, sizeof(cmd));
+    }
+
+    void append_replace(OrderId id, Price price, uint64_t qty) noexcept {
+        ReplaceCommand cmd{id, price, qty};
+        append(JournalCommand::Replace, &cmd, sizeof(cmd));
+    }
+
+    // Send the open batch now, behind any frames the transport refused
+    // earlier. False if frames are still waiting; they are retried by the
+    // next flush, so the replica never sees a gap. Matcher thread, between
+    // commands.
+    bool flush();
+
+    // Send the open batch if it has waited longer than max_delay, and
+    // retry refused frames; call from the matcher loop when idle
+    bool maybe_flush();
+
+    [[nodiscard]] PrimaryStats stats() const noexcept;
+
+private:
+    struct PendingFrame {
+        std::vector<char> bytes;
+        uint64_t last_seq;
+    };
+
+    void append(JournalCommand type, const void* payload, size_t length) noexcept;
+    void seal_batch();
+
+    const MatchingEngine& engine_;
+    std::shared_ptr<ReplicationTransport> transport_;
+    std::shared_ptr<LatchedTimeSource> latch_;
+    ReplicationConfig config_;
+
+    // Matcher-owned batch
+    std::vector<char> batch_;
+    uint32_t batch_count_ = 0;
+    uint64_t batch_first_seq_ = 0;
+    std::chrono::steady_clock::time_point batch_started_;
+    uint64_t next_seq_ = 1;
+
+    // Sealed frames not yet taken by the transport, oldest first, and
+    // spent buffers for the next batch
+    std::deque<PendingFrame> pending_;
+    std::vector<std::vector<char>> spare_;
+
+    std::atomic<uint64_t> commands_{0};
+    std::atomic<uint64_t> sent_seq_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> send_failures_{0};
+    std::atomic<uint64_t> pending_frames_{0};
+};
+
+struct ReplicaStats {
+    uint64_t frames = 0;
+    uint64_t applied_seq = 0;       // Last command applied
+    uint64_t applied_stamp = 0;     // Primary clock of that command
+    uint64_t verified_seq = 0;      // Last event sequence whose hash matched the primary's
+    uint64_t hash_mismatches = 0;
+    uint64_t first_mismatch_seq = 0;
+};
+
+// Replica side. The engine must run on a SimulatedTimeSource, which is set
+// to each command's primary stamp before the command is applied. To take
+// over, stop polling and drive the engine directly.
+class ReplicationReplica {
+public:
+    ReplicationReplica(MatchingEngine& engine, std::shared_ptr<ReplicationTransport> transport);
+
+    ReplicationReplica(const ReplicationReplica&) = delete;
+    ReplicationReplica& operator=(const ReplicationReplica&) = delete;
+
+    // Receive and apply one batch; returns the number of commands applied
+    size_t poll(std::chrono::microseconds timeout);
+
+    // False once a malformed frame or a sequence gap was seen, the
+    // transport failed, or the engine has no SimulatedTimeSource; nothing is
+    // applied after that
+    [[nodiscard]] bool ok() const noexcept {
+        return ok_.load(std::memory_order_acquire);
+    }
+
+    // Safe to call from any thread
+    [[nodiscard]] ReplicaStats stats() const noexcept;
+
+private:
+    bool apply(const char* data, size_t size, uint32_t expected_count);
+
+    MatchingEngine& engine_;
+    std::shared_ptr<ReplicationTransport> transport_;
+    std::shared_ptr<SimulatedTimeSource> clock_;
+    std::vector<char> frame_;
+
+    std::atomic<bool> ok_{true};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> applied_seq_{0};
+    std::atomic<uint64_t> applied_stamp_{0};
+    std::atomic<uint64_t> verified_seq_{0};
+    std::atomic<uint64_t> hash_mismatches_{0};
+    std::atomic<uint64_t> first_mismatch_seq_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace lob {
+
+// Single-writer, multi-reader sequence lock. The writer never blocks and
+// readers retry until they observe a consistent copy. The payload is held
+// as relaxed atomic words so concurrent reads are race-free.
+template<typename T>
+class alignas(64) SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() noexcept {
+        store(T{});
+        seq_.store(0, std::memory_order_relaxed);
+    }
+
+    explicit SeqLock(const T& initial) noexcept {
+        store(initial);
+        seq_.store(0, std::memory_order_relaxed);
+    }
+
+    // Publish a new value (single writer only)
+    void write(const T& value) noexcept {
+        uint64_t s = seq_.load(std::memory_order_relaxed);
+        seq_.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        store(value);
+        seq_.store(s + 2, std::memory_order_release);
+    }
+
+    // Single read attempt; false if a write was in progress
+    [[nodiscard]] bool try_read(T& out) const noexcept {
+        uint64_t s1 = seq_.load(std::memory_order_acquire);
+        if (s1 & 1) {
+            return false;
+        }
+        load(out);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return seq_.load(std::memory_order_relaxed) == s1;
+    }
+
+    // Read a consistent copy, retrying while the writer is active
+    void read(T& out) const noexcept {
+        while (!try_read(out)) {
+        }
+    }
+
+    // Number of completed writes
+    [[nodiscard]] uint64_t version() const noexcept {
+        return seq_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    void store(const T& value) noexcept {
+        uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    void load(T& out) const noexcept {
+        uint64_t words[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            words[i] = data_[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(&out, words, sizeof(T));
+    }
+
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> data_[kWords];
+};
+
+} // namespace lob
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "MatchingEngine.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace lob {
+
+// One engine event in a cache line. The payload holds the event struct's
+// bytes as-is, so producing and consuming are plain copies.
+struct alignas(64) SharedEventSlot {
+    uint64_t seq;
+    uint8_t type;           // EngineEvent variant index
+    uint8_t reserved[7];
+    unsigned char payload[48];
+};
+static_assert(sizeof(SharedEventSlot) == 64, "SharedEventSlot layout is part of the segment format");
+
+// Copy an event into a slot and back
+void encode_event(const SequencedEvent& event, SharedEventSlot& slot) noexcept;
+[[nodiscard]] bool decode_event(const SharedEventSlot& slot, SequencedEvent& out) noexcept;
+
+// Segment layout: SharedRingHeader | capacity slots
+struct SharedRingHeader {
+    char magic[8];          // "LOBSHMR1"
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;      // Slots; a power of two
+    uint64_t reserved[5];
+    alignas(64) std::atomic<uint64_t> head;     // Slots consumed
+    alignas(64) std::atomic<uint64_t> tail;     // Slots produced
+    alignas(64) std::atomic<uint64_t> dropped;  // Pushes refused because the ring was full
+};
+
+constexpr uint32_t SHARED_RING_VERSION = 1;
+
+// RingBuffer<SequencedEvent> in shared memory, for handing engine output
+// to another process without serialization. One producer (attach it with
+// MatchingEngine::set_event_ring) and one consumer, each holding its own
+// SharedEventRing over the same segment. As with the in-process ring a
+// full ring refuses the push, so a slow consumer sees sequence gaps
+// rather than stalling the matcher.
+class SharedEventRing {
+public:
+    SharedEventRing() = default;
+    ~SharedEventRing() { close(); }
+
+    SharedEventRing(const SharedEventRing&) = delete;
+    SharedEventRing& operator=(const SharedEventRing&) = delete;
+
+    // Create a named POSIX shm segment (unlinked again on close)
+    [[nodiscard]] bool create(const std::string& name, size_t capacity);
+
+    // Create an unnamed memfd segment (Linux); share it through fd() by
+    // fork or SCM_RIGHTS
+    [[nodiscard]] bool create_anonymous(size_t capacity);
+
+    // Consumer side: map an existing segment by name or descriptor
+    [[nodiscard]] bool open(const std::string& name);
+    [[nodiscard]] bool attach(int fd);
+
+    void close() noexcept;
+
+    [[nodiscard]] bool is_open() const noexcept {
+        return header_ != nullptr;
+    }
+
+    // Descriptor of a segment made by create_anonymous, else -1
+    [[nodiscard]] int fd() const noexcept {
+        return fd_;
+    }
+
+    // Producer side
+    [[nodiscard]] bool push(const SequencedEvent& event) noexcept {
+        const uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == capacity_) {
+            head_cache_ = header_->head.load(std::memory_order_acquire);
+            if (tail - head_cache_ == capacity_) {
+                header_->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        encode_event(event, slots_[tail & mask_]);
+        header_->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: zero-copy access to the oldest slot, then release it
+    [[nodiscard]] const SharedEventSlot* front() noexcept {
+        const uint64_t head = header_->head.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = header_->tail.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return nullptr;
+            }
+        }
+        return &slots_[head & mask_];
+    }
+
+    void release() noexcept {
+        header_->head.store(header_->head.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_release);
+    }
+
+    // Pop the oldest event. A slot that does not decode is still released,
+    // so one bad record cannot wedge the ring, but it is counted in
+    // undecodable() and its sequence number shows up as a gap; pop returns
+    // false for it as for an empty ring.
+    [[nodiscard]] bool pop(SequencedEvent& out) noexcept {
+        const SharedEventSlot* slot = front();
+        if (!slot) {
+            return false;
+        }
+        bool ok = decode_event(*slot, out);
+        release();
+        if (!ok) {
+            ++undecodable_;
+        }
+        return ok;
+    }
+
+    // Pop up to max_events into out (cleared first), skipping undecodable
+    // slots; returns the count
+    size_t poll(std::vector<SequencedEvent>& out, size_t max_events = SIZE_MAX);
+
+    // Spin, then yield, until an event is available or timeout elapses
+    [[nodiscard]] bool wait(std::chrono::nanoseconds timeout) noexcept;
+
+    [[nodiscard]] bool empty() const noexcept {
+        return header_->head.load(std::memory_order_acquire) ==
+               header_->tail.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return header_->tail.load(std::memory_order_acquire) -
+               header_->head.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept {
+        return capacity_;
+    }
+
+    [[nodiscard]] uint64_t dropped() const noexcept {
+        return header_->dropped.load(std::memory_order_relaxed);
+    }
+
+    // Slots this consumer released without delivering because they did not
+    // decode
+    [[nodiscard]] uint64_t undecodable() const noexcept {
+        return undecodable_;
+    }
+
+private:
+    bool create_on(int fd, size_t capacity);
+    bool map(int fd);
+
+    SharedRingHeader* header_ = nullptr;
+    SharedEventSlot* slots_ = nullptr;
+    size_t mapped_ = 0;
+    uint64_t capacity_ = 0;
+    uint64_t mask_ = 0;
+    int fd_ = -1;
+    std::string name_;          // Set when this side must unlink
+
+    // Each side's cached copy of the other side's index
+    uint64_t head_cache_ = 0;
+    uint64_t tail_cache_ = 0;
+    uint64_t undecodable_ = 0;
+};
+
+} // namespace lob
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "MarketDataReplay.h"
+#include "BlockReader.h"
+#include "BlockCompression.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lob {
+
+constexpr size_t DEFAULT_STREAM_BLOCK = 1 << 20;
+
+// Streams a replay CSV from disk in fixed-size blocks. A background thread
+// reads and parses one block ahead into a pair of message buffers, so peak
+// memory is about two blocks' worth regardless of file size and replay can
+// start as soon as the first block is parsed. Blocks come from a
+// BlockReader, so with io_uring the disk also runs ahead of the parser;
+// compressed containers are decoded a few blocks at a time in parallel.
+class CsvStreamSource : public ReplaySource {
+public:
+    CsvStreamSource() = default;
+    ~CsvStreamSource() override { close(); }
+
+    CsvStreamSource(const CsvStreamSource&) = delete;
+    CsvStreamSource& operator=(const CsvStreamSource&) = delete;
+
+    // Open a file and start the reader thread
+    // CSV format: timestamp,action,order_id,side,price,qty,order_type
+    [[nodiscard]] bool open(const std::string& filename, double tick_size,
+                            size_t block_bytes = DEFAULT_STREAM_BLOCK);
+
+    // Open with explicit block reader settings (backend, queue depth, O_DIRECT)
+    [[nodiscard]] bool open(const std::string& filename, double tick_size,
+                            const BlockReaderOptions& options);
+
+    // Stop the reader thread and close the file
+    void close();
+
+    // Swap the next parsed block into batch; blocks until it is ready.
+    // Returns false once the file is exhausted or a read failed.
+    bool next_batch(std::vector<MarketDataMessage>& batch) override;
+
+    // The file could not be read (or decoded) to its end; the batches
+    // delivered cover only the part before the error
+    [[nodiscard]] bool failed() const noexcept override {
+        return failed_.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] size_t bad_rows() const noexcept {
+        return bad_rows_.load(std::memory_order_relaxed);
+    }
+
+    // Read block size, or the longest line carried between blocks if larger
+    [[nodiscard]] size_t buffer_capacity() const noexcept {
+        return buffer_capacity_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void reader_loop();
+    void parse_block(const char* data, size_t size, bool first_block,
+                     std::vector<MarketDataMessage>& out);
+
+    BlockReader blocks_;
+    std::unique_ptr<CompressedBlockStream> zblocks_;    // Set for compressed files
+    TickScale scale_;
+    std::thread reader_;
+
+    // Double buffer: the reader fills one slot while replay drains the other
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<MarketDataMessage> slots_[2];
+    bool full_[2] = {false, false};
+    size_t read_slot_ = 0;
+    bool done_ = false;
+    bool stop_ = false;
+
+    std::atomic<bool> failed_{false};
+    std::atomic<size_t> bad_rows_{0};
+    std::atomic<size_t> buffer_capacity_{0};
+};
+
+// Feeds a mapped binary capture to replay in fixed-size batches. The
+// mapping is paged in on demand, so resident memory stays bounded too.
+class CaptureStreamSource : public ReplaySource {
+public:
+    explicit CaptureStreamSource(const CaptureReader& capture, size_t batch_size = 4096)
+        : capture_(capture), batch_size_(batch_size ? batch_size : 1) {}
+
+    bool next_batch(std::vector<MarketDataMessage>& batch) override {
+        batch.clear();
+        size_t end = std::min(pos_ + batch_size_, capture_.size());
+        for (; pos_ < end; ++pos_) {
+            batch.push_back(MarketDataReplay::to_message(capture_.records()[pos_]));
+        }
+        return !batch.empty();
+    }
+
+private:
+    const CaptureReader& capture_;
+    size_t batch_size_;
+    size_t pos_ = 0;
+};
+
+} // namespace lob
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <memory>
 #include <chrono>
+#include <utility>
 
 namespace lob {
 
@@ -51,4 +52,27 @@ private:
     std::chrono::steady_clock::time_point start_;
 };
 
+// Holds one reading of another clock until latched again, so every
+// now_ns() between two latches returns the same value. Lets a whole
+// command run at a single timestamp that can be reproduced elsewhere.
+class LatchedTimeSource : public TimeSource {
+public:
+    explicit LatchedTimeSource(std::shared_ptr<TimeSource> clock) noexcept
+        : clock_(std::move(clock)), latched_(clock_->now_ns()) {}
+    
+    uint64_t now_ns() noexcept override {
+        return latched_;
+    }
+    
+    // Take a fresh reading of the underlying clock and return it
+    uint64_t latch() noexcept {
+        latched_ = clock_->now_ns();
+        return latched_;
+    }
+
+private:
+    std::shared_ptr<TimeSource> clock_;
+    uint64_t latched_;
+};
+
 } // namespace lob
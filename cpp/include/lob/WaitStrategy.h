@@ -0,0 +1,206 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace lob {
+
+// How a ring consumer waits for the producer. Producers call notify() after
+// publishing; consumers call wait() with a readiness predicate. Strategies
+// trade CPU use for wake-up latency.
+class WaitStrategy {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~WaitStrategy() = default;
+
+    // Wait until ready() is true or timeout elapses; returns ready()
+    virtual bool wait(const std::function<bool()>& ready,
+                      std::chrono::nanoseconds timeout) = 0;
+
+    // Wake any waiting consumer (producer side, must be cheap)
+    virtual void notify() noexcept {}
+
+protected:
+    static void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+};
+
+// Spin on the predicate; lowest latency, burns a full core
+class BusySpinWait : public WaitStrategy {
+public:
+    bool wait(const std::function<bool()>& ready,
+              std::chrono::nanoseconds timeout) override {
+        auto deadline = Clock::now() + timeout;
+        uint32_t spins = 0;
+        while (!ready()) {
+            cpu_relax();
+            // Reading the clock on every iteration would dominate the loop
+            if ((++spins & 1023) == 0 && Clock::now() >= deadline) {
+                return ready();
+            }
+        }
+        return true;
+    }
+};
+
+// Spin for a bounded number of iterations, then yield the core between checks
+class SpinYieldWait : public WaitStrategy {
+public:
+    explicit SpinYieldWait(uint32_t spin_limit = 256) noexcept
+        : spin_limit_(spin_limit) {}
+
+    bool wait(const std::function<bool()>& ready,
+              std::chrono::nanoseconds timeout) override {
+        auto deadline = Clock::now() + timeout;
+        uint32_t spins = 0;
+        while (!ready()) {
+            if (spins < spin_limit_) {
+                ++spins;
+                cpu_relax();
+            } else {
+                if (Clock::now() >= deadline) return ready();
+                std::this_thread::yield();
+            }
+        }
+        return true;
+    }
+
+private:
+    uint32_t spin_limit_;
+};
+
+// Sleep with exponentially growing intervals between checks
+class BackoffWait : public WaitStrategy {
+public:
+    explicit BackoffWait(std::chrono::nanoseconds min_sleep = std::chrono::microseconds(1),
+                         std::chrono::nanoseconds max_sleep = std::chrono::milliseconds(1)) noexcept
+        : min_sleep_(min_sleep), max_sleep_(max_sleep) {}
+
+    bool wait(const std::function<bool()>& ready,
+              std::chrono::nanoseconds timeout) override {
+        auto deadline = Clock::now() + timeout;
+        auto sleep = min_sleep_;
+        while (!ready()) {
+            auto now = Clock::now();
+            if (now >= deadline) return ready();
+            std::this_thread::sleep_for(std::min(sleep, 
+                std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now)));
+            sleep = std::min(sleep * 2, max_sleep_);
+        }
+        return true;
+    }
+
+private:
+    std::chrono::nanoseconds min_sleep_;
+    std::chrono::nanoseconds max_sleep_;
+};
+
+// Park the consumer in the kernel until notified. Uses a futex on Linux and
+// a condition variable elsewhere. notify() only enters the kernel when a
+// consumer is actually parked.
+class BlockingWait : public WaitStrategy {
+public:
+    bool wait(const std::function<bool()>& ready,
+              std::chrono::nanoseconds timeout) override {
+        auto deadline = Clock::now() + timeout;
+        while (!ready()) {
+            uint32_t seen = epoch_.load(std::memory_order_acquire);
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            // Re-check after announcing ourselves so a notify cannot be lost
+            if (ready()) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            auto now = Clock::now();
+            if (now >= deadline) {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                return ready();
+            }
+            park(seen, std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now));
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    void notify() noexcept override {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) == 0) {
+            return;
+        }
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_),
+                FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+#endif
+    }
+
+private:
+    void park(uint32_t seen, std::chrono::nanoseconds timeout) noexcept {
+#ifdef __linux__
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(timeout.count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&epoch_),
+                FUTEX_WAIT_PRIVATE, seen, &ts, nullptr, 0);
+#else
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, timeout, [&] {
+            return epoch_.load(std::memory_order_acquire) != seen;
+        });
+#endif
+    }
+
+    alignas(64) std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> waiters_{0};
+#ifndef __linux__
+    std::mutex mutex_;
+    std::condition_variable cv_;
+#endif
+};
+
+enum class WaitKind : uint8_t {
+    BusySpin = 0,
+    SpinYield = 1,
+    Blocking = 2,
+    Backoff = 3
+};
+
+[[nodiscard]] inline std::shared_ptr<WaitStrategy> make_wait_strategy(WaitKind kind) {
+    switch (kind) {
+        case WaitKind::BusySpin:  return std::make_shared<BusySpinWait>();
+        case WaitKind::SpinYield: return std::make_shared<SpinYieldWait>();
+        case WaitKind::Backoff:   return std::make_shared<BackoffWait>();
+        case WaitKind::Blocking:  break;
+    }
+    return std::make_shared<BlockingWait>();
+}
+
+} // namespace lob
@@ -2,24 +2,41 @@
 
 #include "MatchingEngine.h"
 #include "Events.h"
+#include "Affinity.h"
+#include "JsonWriter.h"
+#include "MpscRing.h"
+#include "WaitStrategy.h"
+#include <algorithm>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
+#include <iterator>
 #include <memory>
 #include <thread>
 #include <atomic>
-#include <mutex>
-#include <condition_variable>
-#include <queue>
 
 namespace lob {
 
+// What a server does with a client whose unsent data outgrows its backlog
+enum class SlowClientPolicy : uint8_t {
+    Disconnect = 0,     // Close the connection
+    Conflate = 1        // Discard its queued, not yet started messages and carry on
+};
+
 // WebSocket feed configuration
 struct WebSocketConfig {
     std::string host = "0.0.0.0";
     uint16_t port = 8080;
     size_t max_connections = 100;
     size_t buffer_size = 4096;
+    int cpu = -1;              // Core to pin the feed thread to (-1 = any)
+    WaitKind wait_kind = WaitKind::Blocking;  // How the feed thread idles
+    double price_tick = 0.0;   // Send prices as decimals of this tick size (0 = integer ticks)
+    size_t queue_capacity = 8192;  // Encoded messages waiting for the feed thread
+    size_t batch_size = 256;       // Messages the feed thread takes per drain
+    size_t max_client_backlog = 1 << 20;  // Bytes queued per client before slow_client applies
+    SlowClientPolicy slow_client = SlowClientPolicy::Disconnect;
     
     WebSocketConfig() noexcept = default;
 };
@@ -35,15 +52,122 @@ struct WebSocketMessage {
         : type(t), data(d), timestamp(ts) {}
 };
 
-// WebSocket feed for live order book visualization
-// Note: This is a simplified interface. Full implementation would require
-// an actual WebSocket library like websocketpp or Boost.Beast
+// JSON bodies of feed messages, written straight from the event structs
+inline void write_json(JsonWriter& w, const TradeEvent& e, std::string_view symbol) {
+    w.begin_object()
+     .field("symbol", symbol)
+     .field("taker_id", e.taker_id)
+     .field("maker_id", e.maker_id)
+     .field("price", e.price)
+     .field("qty", e.qty)
+     .field("ts", e.ts)
+     .end_object();
+}
+
+inline void write_json(JsonWriter& w, const BookTop& e, std::string_view symbol) {
+    w.begin_object()
+     .field("symbol", symbol)
+     .field("best_bid", e.best_bid)
+     .field("bid_qty", e.bid_qty)
+     .field("best_ask", e.best_ask)
+     .field("ask_qty", e.ask_qty)
+     .field("ts", e.ts)
+     .end_object();
+}
+
+inline void write_json(JsonWriter& w, const AcceptEvent& e, std::string_view symbol) {
+    w.begin_object()
+     .field("symbol", symbol)
+     .field("order_id", e.id)
+     .field("ts", e.ts)
+     .end_object();
+}
+
+inline void write_json(JsonWriter& w, const CancelEvent& e, std::string_view symbol) {
+    w.begin_object()
+     .field("symbol", symbol)
+     .field("order_id", e.id)
+     .field("remaining", e.remaining)
+     .field("ts", e.ts)
+     .end_object();
+}
+
+inline void write_json(JsonWriter& w, const RejectEvent& e, std::string_view symbol) {
+    w.begin_object()
+     .field("symbol", symbol)
+     .field("order_id", e.id)
+     .field("reason_code", e.reason_code)
+     .field("ts", e.ts)
+     .end_object();
+}
+
+inline void write_json(JsonWriter& w, const ReplaceEvent& e, std::string_view symbol) {
+    w.begin_object()
+     .field("symbol", symbol)
+     .field("order_id", e.id)
+     .field("price", e.new_price)
+     .field("qty", e.new_qty)
+     .field("ts", e.ts)
+     .end_object();
+}
+
+inline void write_json(JsonWriter& w, const LevelUpdate& e, std::string_view symbol) {
+    static constexpr const char* KINDS[] = {"delta", "snapshot_start", "snapshot_level"};
+    w.begin_object()
+     .field("symbol", symbol)
+     .field("kind", KINDS[static_cast<size_t>(e.kind)])
+     .field("side", e.side == Side::Buy ? "bid" : "ask")
+     .field("price", e.price)
+     .field("qty", e.qty)
+     .field("orders", e.order_count)
+     .field("seq", e.seq)
+     .field("ts", e.ts)
+     .end_object();
+}
+
+inline void write_json(JsonWriter& w, const DepthSnapshot& depth, std::string_view symbol) {
+    auto levels = [&w](const std::vector<DepthLevel>& side) {
+        w.begin_array();
+        for (const DepthLevel& level : side) {
+            w.begin_object()
+             .field("price", level.price)
+             .field("qty", level.qty)
+             .field("orders", level.order_count)
+             .end_object();
+        }
+        w.end_array();
+    };
+    w.begin_object().field("symbol", symbol).key("bids");
+    levels(depth.bids);
+    w.key("asks");
+    levels(depth.asks);
+    w.field("ts", depth.ts).end_object();
+}
+
+// Message type tag for each event
+inline const char* json_type(const EngineEvent& event) noexcept {
+    static constexpr const char* TYPES[] = {
+        "trade", "accept", "reject", "cancel", "replace", "booktop", "level"
+    };
+    static_assert(std::variant_size_v<EngineEvent> == std::size(TYPES), "tag every event type");
+    return TYPES[event.index()];
+}
+
+inline void write_json(JsonWriter& w, const EngineEvent& event, std::string_view symbol) {
+    std::visit([&](const auto& e) { write_json(w, e, symbol); }, event);
+}
+
+// Encodes engine output and hands it to a feed thread through a lock-free
+// queue. This base class delivers to an in-process callback; WebSocketServer
+// serves the same stream to WebSocket clients.
 class WebSocketFeed {
 public:
     using MessageCallback = std::function<void(const WebSocketMessage&)>;
     
     explicit WebSocketFeed(const WebSocketConfig& config = WebSocketConfig())
-        : config_(config), running_(false) {}
+        : config_(config), running_(false),
+          queue_(config.queue_capacity),
+          wait_strategy_(make_wait_strategy(config.wait_kind)) {}
     
     virtual ~WebSocketFeed() {
         stop();
@@ -56,7 +180,12 @@ public:
         }
         
         running_.store(true);
-        worker_thread_ = std::thread(&WebSocketFeed::worker_loop, this);
+        worker_thread_ = std::thread([this] {
+            if (config_.cpu >= 0) {
+                (void)pin_current_thread(config_.cpu);
+            }
+            worker_loop();
+        });
         return true;
     }
     
@@ -67,55 +196,61 @@ public:
         }
         
         running_.store(false);
-        cv_.notify_all();
+        notify_worker();
         
         if (worker_thread_.joinable()) {
             worker_thread_.join();
         }
     }
     
-    // Broadcast message to all connected clients
-    void broadcast(const WebSocketMessage& msg) {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
-        message_queue_.push(msg);
-        cv_.notify_one();
+    // Queue a message for all connected clients. Never blocks: if the
+    // feed thread has fallen a whole queue behind, the message is dropped
+    // (counted in dropped()) and false returned. Safe from any thread.
+    bool broadcast(const WebSocketMessage& msg) {
+        WebSocketMessage& staged = staging_message();
+        staged.type = msg.type;
+        staged.data = msg.data;
+        staged.timestamp = msg.timestamp;
+        bool queued = enqueue(staged);
+        notify_worker();
+        return queued;
     }
     
     // Broadcast engine events as JSON
-    void broadcast_event(const EngineEvent& event, const std::string& symbol = "") {
-        WebSocketMessage msg;
-        msg.timestamp = get_event_timestamp(event);
-        
-        std::visit([&](auto&& e) {
-            using T = std::decay_t<decltype(e)>;
-            if constexpr (std::is_same_v<T, TradeEvent>) {
-                msg.type = "trade";
-                msg.data = trade_to_json(e, symbol);
-            } else if constexpr (std::is_same_v<T, BookTop>) {
-                msg.type = "booktop";
-                msg.data = booktop_to_json(e, symbol);
-            } else if constexpr (std::is_same_v<T, AcceptEvent>) {
-                msg.type = "accept";
-                msg.data = accept_to_json(e, symbol);
-            } else if constexpr (std::is_same_v<T, CancelEvent>) {
-                msg.type = "cancel";
-                msg.data = cancel_to_json(e, symbol);
-            } else if constexpr (std::is_same_v<T, RejectEvent>) {
-                msg.type = "reject";
-                msg.data = reject_to_json(e, symbol);
-            }
-        }, event);
-        
-        broadcast(msg);
+    bool broadcast_event(const EngineEvent& event, const std::string& symbol = "") {
+        bool queued = enqueue(stage_event(event, symbol));
+        notify_worker();
+        return queued;
+    }
+    
+    // Broadcast a batch (e.g. one poll_events result) with a single wake-up
+    // of the feed thread; returns the number queued
+    size_t broadcast_event(const std::vector<EngineEvent>& events, const std::string& symbol = "") {
+        size_t queued = 0;
+        for (const EngineEvent& event : events) {
+            queued += enqueue(stage_event(event, symbol));
+        }
+        notify_worker();
+        return queued;
     }
     
     // Broadcast depth snapshot
-    void broadcast_depth(const DepthSnapshot& depth, const std::string& symbol = "") {
-        WebSocketMessage msg;
-        msg.type = "depth";
-        msg.timestamp = depth.ts;
-        msg.data = depth_to_json(depth, symbol);
-        broadcast(msg);
+    bool broadcast_depth(const DepthSnapshot& depth, const std::string& symbol = "") {
+        JsonWriter& w = scratch_writer();
+        write_json(w, depth, symbol);
+        
+        WebSocketMessage& staged = staging_message();
+        staged.type = "depth";
+        staged.data.assign(w.view());
+        staged.timestamp = depth.ts;
+        bool queued = enqueue(staged);
+        notify_worker();
+        return queued;
+    }
+    
+    // Messages refused because the queue was full
+    [[nodiscard]] uint64_t dropped() const noexcept {
+        return dropped_.load(std::memory_order_relaxed);
     }
     
     [[nodiscard]] bool is_running() const noexcept {
@@ -128,29 +263,45 @@ public:
 
 protected:
     virtual void worker_loop() {
-        // This would contain the actual WebSocket server logic
-        // For now, it's a placeholder that processes the message queue
+        // Messages are swapped out of the queue into this batch and back
+        // in on the next drain, so their buffers are reused
+        std::vector<WebSocketMessage> batch(std::max<size_t>(config_.batch_size, 1));
         while (running_.load()) {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            cv_.wait_for(lock, std::chrono::milliseconds(100), 
-                        [this] { return !message_queue_.empty() || !running_.load(); });
+            wait_strategy_->wait([this] {
+                return !queue_.empty() || !running_.load();
+            }, std::chrono::milliseconds(100));
             
-            while (!message_queue_.empty()) {
-                WebSocketMessage msg = message_queue_.front();
-                message_queue_.pop();
-                lock.unlock();
-                
-                // Actual WebSocket send would happen here
-                // For demo purposes, we just process the message
-                if (on_message_) {
-                    on_message_(msg);
-                }
-                
-                lock.lock();
+            size_t count;
+            while ((count = queue_.pop_batch(batch.data(), batch.size())) > 0) {
+                deliver(batch.data(), count);
+            }
+        }
+    }
+    
+    // Hand a drained batch to clients, in queue order. Runs on the feed
+    // thread; the default passes each message to the message callback.
+    virtual void deliver(const WebSocketMessage* messages, size_t count) {
+        if (on_message_) {
+            for (size_t i = 0; i < count; ++i) {
+                on_message_(messages[i]);
             }
         }
     }
     
+    // Wake the feed thread after queuing; called on producer threads
+    virtual void notify_worker() noexcept {
+        wait_strategy_->notify();
+    }
+    
+    // Feed-thread side of the queue, for subclasses with their own loop
+    size_t take_messages(WebSocketMessage* out, size_t count) noexcept {
+        return queue_.pop_batch(out, count);
+    }
+    
+    [[nodiscard]] bool has_messages() const noexcept {
+        return !queue_.empty();
+    }
+    
     void set_message_callback(MessageCallback cb) {
         on_message_ = std::move(cb);
     }
@@ -160,71 +311,47 @@ private:
         return std::visit([](auto&& e) -> uint64_t { return e.ts; }, event);
     }
     
-    std::string trade_to_json(const TradeEvent& e, const std::string& symbol) const {
-        return "{\"symbol\":\"" + symbol + 
-               "\",\"taker_id\":" + std::to_string(e.taker_id) +
-               ",\"maker_id\":" + std::to_string(e.maker_id) +
-               ",\"price\":" + std::to_string(e.price.ticks) +
-               ",\"qty\":" + std::to_string(e.qty) +
-               ",\"ts\":" + std::to_string(e.ts) + "}";
-    }
-    
-    std::string booktop_to_json(const BookTop& e, const std::string& symbol) const {
-        return "{\"symbol\":\"" + symbol +
-               "\",\"best_bid\":" + std::to_string(e.best_bid.ticks) +
-               ",\"bid_qty\":" + std::to_string(e.bid_qty) +
-               ",\"best_ask\":" + std::to_string(e.best_ask.ticks) +
-               ",\"ask_qty\":" + std::to_string(e.ask_qty) +
-               ",\"ts\":" + std::to_string(e.ts) + "}";
+    // Per-thread encoder, so producers on several threads never share one;
+    // it keeps its capacity between messages
+    JsonWriter& scratch_writer() const {
+        thread_local JsonWriter writer;
+        writer.set_tick_size(config_.price_tick);
+        writer.clear();
+        return writer;
     }
     
-    std::string accept_to_json(const AcceptEvent& e, const std::string& symbol) const {
-        return "{\"symbol\":\"" + symbol +
-               "\",\"order_id\":" + std::to_string(e.id) +
-               ",\"ts\":" + std::to_string(e.ts) + "}";
+    // Per-thread message a producer fills and swaps into the queue; it
+    // comes back holding a consumed message whose buffers are reused
+    static WebSocketMessage& staging_message() {
+        thread_local WebSocketMessage staged;
+        return staged;
     }
     
-    std::string cancel_to_json(const CancelEvent& e, const std::string& symbol) const {
-        return "{\"symbol\":\"" + symbol +
-               "\",\"order_id\":" + std::to_string(e.id) +
-               ",\"remaining\":" + std::to_string(e.remaining) +
-               ",\"ts\":" + std::to_string(e.ts) + "}";
-    }
-    
-    std::string reject_to_json(const RejectEvent& e, const std::string& symbol) const {
-        return "{\"symbol\":\"" + symbol +
-               "\",\"order_id\":" + std::to_string(e.id) +
-               ",\"reason_code\":" + std::to_string(e.reason_code) +
-               ",\"ts\":" + std::to_string(e.ts) + "}";
+    WebSocketMessage& stage_event(const EngineEvent& event, std::string_view symbol) {
+        JsonWriter& w = scratch_writer();
+        write_json(w, event, symbol);
+        
+        WebSocketMessage& staged = staging_message();
+        staged.type = json_type(event);
+        staged.data.assign(w.view());
+        staged.timestamp = get_event_timestamp(event);
+        return staged;
     }
     
-    std::string depth_to_json(const DepthSnapshot& depth, const std::string& symbol) const {
-        std::string json = "{\"symbol\":\"" + symbol + "\",\"bids\":[";
-        for (size_t i = 0; i < depth.bids.size(); ++i) {
-            if (i > 0) json += ",";
-            const auto& level = depth.bids[i];
-            json += "{\"price\":" + std::to_string(level.price.ticks) +
-                   ",\"qty\":" + std::to_string(level.qty) +
-                   ",\"orders\":" + std::to_string(level.order_count) + "}";
-        }
-        json += "],\"asks\":[";
-        for (size_t i = 0; i < depth.asks.size(); ++i) {
-            if (i > 0) json += ",";
-            const auto& level = depth.asks[i];
-            json += "{\"price\":" + std::to_string(level.price.ticks) +
-                   ",\"qty\":" + std::to_string(level.qty) +
-                   ",\"orders\":" + std::to_string(level.order_count) + "}";
+    bool enqueue(WebSocketMessage& staged) noexcept {
+        if (queue_.try_push(staged)) {
+            return true;
         }
-        json += "],\"ts\":" + std::to_string(depth.ts) + "}";
-        return json;
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
     
     WebSocketConfig config_;
     std::atomic<bool> running_;
     std::thread worker_thread_;
-    std::queue<WebSocketMessage> message_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable cv_;
+    MpscRing<WebSocketMessage> queue_;
+    std::atomic<uint64_t> dropped_{0};
+    std::shared_ptr<WaitStrategy> wait_strategy_;
     MessageCallback on_message_;
 };
 
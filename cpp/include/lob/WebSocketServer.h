@@ -0,0 +1,105 @@
+#pragma once
+
+#include "WebSocketFeed.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lob {
+
+// Sec-WebSocket-Accept value for a client's Sec-WebSocket-Key (RFC 6455)
+[[nodiscard]] std::string websocket_accept_key(std::string_view client_key);
+
+struct WebSocketServerStats {
+    uint64_t accepted = 0;          // TCP connections accepted
+    uint64_t clients = 0;           // Clients currently subscribed (handshake done)
+    uint64_t rejected = 0;          // Over max_connections or a bad handshake
+    uint64_t slow_disconnects = 0;  // Clients closed under SlowClientPolicy::Disconnect
+    uint64_t conflated = 0;         // Frame batches discarded under SlowClientPolicy::Conflate
+    uint64_t frames = 0;            // Frames encoded (once each, whatever the client count)
+    uint64_t bytes_sent = 0;
+};
+
+// Dependency-free WebSocket server for the feed (Linux epoll; start()
+// fails elsewhere). The feed thread owns every socket: it accepts, does
+// the HTTP upgrade handshake, and for each drained batch of messages
+// encodes the frames once into a shared buffer, which every client's send
+// queue references. Each client is written with one scatter-gather call
+// per wake-up. Sockets are non-blocking; a client whose unsent bytes
+// exceed max_client_backlog is handled per config.slow_client rather
+// than holding up the others.
+//
+// Each frame is a text message {"type":...,"data":...} as read by
+// docs/visualization.html. Producers only touch the lock-free queue; the
+// feed thread is woken through an eventfd, and only when it is asleep.
+class WebSocketServer : public WebSocketFeed {
+public:
+    explicit WebSocketServer(const WebSocketConfig& config = WebSocketConfig());
+    ~WebSocketServer() override;
+
+    // Bind and listen on config.host:port (port 0 picks a free port), then
+    // start the feed thread. False if the socket could not be set up.
+    bool start() override;
+
+    // Stop the feed thread and close every connection
+    void stop() override;
+
+    // Port actually bound; 0 when not running
+    [[nodiscard]] uint16_t port() const noexcept {
+        return port_.load(std::memory_order_acquire);
+    }
+
+    // Safe to call from any thread
+    [[nodiscard]] WebSocketServerStats stats() const noexcept;
+
+protected:
+    void worker_loop() override;
+    void deliver(const WebSocketMessage* messages, size_t count) override;
+    void notify_worker() noexcept override;
+
+private:
+    struct Client;
+    struct FrameBlock;
+
+    void accept_clients();
+    bool on_readable(Client& client);
+    bool handshake(Client& client, size_t header_end);
+    bool read_frames(Client& client);
+    bool enqueue_block(Client& client, const std::shared_ptr<FrameBlock>& block);
+    void send_control(Client& client, uint8_t opcode, const char* payload, size_t size);
+    bool flush(Client& client);
+    void watch_writable(Client& client, bool on);
+    void close_client(int fd);
+    std::shared_ptr<FrameBlock> acquire_block();
+    void close_sockets() noexcept;
+
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<uint16_t> port_{0};
+
+    // Feed-thread state
+    std::unordered_map<int, std::unique_ptr<Client>> clients_;
+    std::vector<std::shared_ptr<FrameBlock>> block_pool_;
+    std::vector<char> read_buf_;
+    std::vector<int> dead_;
+
+    // Wake-up handshake with producers: they write the eventfd only while
+    // the feed thread is (about to be) parked in epoll_wait
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> wake_pending_{false};
+
+    std::atomic<uint64_t> accepted_{0};
+    std::atomic<uint64_t> open_clients_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> slow_disconnects_{0};
+    std::atomic<uint64_t> conflated_{0};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lob {
+
+// Fork-join pool for coarse-grained tasks. Each worker owns a deque and
+// takes work from its front; idle workers steal from the back of others'.
+// Intended for long tasks (a symbol's whole stream), so per-deque mutexes
+// are cheap relative to the work they guard.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t num_threads = 0)
+        : num_threads_(num_threads ? num_threads : default_threads()) {}
+
+    [[nodiscard]] size_t num_threads() const noexcept {
+        return num_threads_;
+    }
+
+    // Run all tasks to completion. Tasks are dealt round-robin in the given
+    // order, so callers should put the largest tasks first.
+    void run(std::vector<Task>& tasks) {
+        if (tasks.empty()) return;
+        
+        size_t workers = std::min(num_threads_, tasks.size());
+        std::vector<WorkerQueue> queues(workers);
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            queues[i % workers].tasks.push_back(i);
+        }
+        
+        auto worker = [&](size_t self) {
+            size_t task;
+            while (take(queues, self, task)) {
+                tasks[task]();
+            }
+        };
+        
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (size_t i = 1; i < workers; ++i) {
+            threads.emplace_back(worker, i);
+        }
+        worker(0);
+        for (auto& t : threads) {
+            t.join();
+        }
+        steals_ += steal_count_.exchange(0);
+    }
+
+    // Total tasks executed by a worker other than the one they were dealt to
+    [[nodiscard]] size_t steals() const noexcept {
+        return steals_;
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    static size_t default_threads() noexcept {
+        unsigned n = std::thread::hardware_concurrency();
+        return n == 0 ? 1 : n;
+    }
+
+    // No task spawns new tasks, so once every deque is seen empty the
+    // worker can exit
+    bool take(std::vector<WorkerQueue>& queues, size_t self, size_t& out) {
+        {
+            std::lock_guard<std::mutex> lock(queues[self].mutex);
+            if (!queues[self].tasks.empty()) {
+                out = queues[self].tasks.front();
+                queues[self].tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues.size(); ++i) {
+            WorkerQueue& victim = queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                out = victim.tasks.back();
+                victim.tasks.pop_back();
+                steal_count_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    size_t num_threads_;
+    size_t steals_ = 0;
+    std::atomic<size_t> steal_count_{0};
+};
+
+} // namespace lob
@@ -0,0 +1,127 @@
+#include "lob/Affinity.h"
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <filesystem>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+namespace {
+
+// Parse a kernel cpulist such as "2-5,8" and test membership
+bool cpulist_contains(const std::string& list, int cpu) {
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) end = list.size();
+        std::string range = list.substr(pos, end - pos);
+        if (!range.empty()) {
+            size_t dash = range.find('-');
+            int lo = std::stoi(range.substr(0, dash));
+            int hi = dash == std::string::npos ? lo : std::stoi(range.substr(dash + 1));
+            if (cpu >= lo && cpu <= hi) return true;
+        }
+        pos = end + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+size_t cpu_count() noexcept {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+int numa_node_of_cpu(int cpu) noexcept {
+#ifdef __linux__
+    if (cpu < 0) return -1;
+    try {
+        std::error_code ec;
+        std::filesystem::path dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+        std::filesystem::directory_iterator it(dir, ec), end;
+        for (; !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().string();
+            if (name.size() > 4 && name.compare(0, 4, "node") == 0) {
+                return std::atoi(name.c_str() + 4);
+            }
+        }
+    } catch (...) {
+        return -1;
+    }
+#else
+    (void)cpu;
+#endif
+    return -1;
+}
+
+bool is_isolated_cpu(int cpu) noexcept {
+#ifdef __linux__
+    std::ifstream file("/sys/devices/system/cpu/isolated");
+    std::string list;
+    if (!file || !std::getline(file, list)) return false;
+    try {
+        return cpulist_contains(list, cpu);
+    } catch (...) {
+        return false;
+    }
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+bool pin_current_thread(int cpu, bool require_isolated) noexcept {
+#ifdef __linux__
+    if (cpu < 0 || static_cast<size_t>(cpu) >= CPU_SETSIZE) return false;
+    if (require_isolated && !is_isolated_cpu(cpu)) return false;
+    
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    (void)require_isolated;
+    return false;
+#endif
+}
+
+ScopedNumaPolicy::ScopedNumaPolicy(int node) noexcept : active_(false) {
+#ifdef __linux__
+    if (node < 0 || node >= static_cast<int>(sizeof(unsigned long) * 8)) return;
+    // Remember the thread's policy (e.g. from numactl) to put it back later
+    if (syscall(SYS_get_mempolicy, &saved_mode_, saved_nodes_,
+                sizeof(saved_nodes_) * 8, nullptr, 0) != 0) {
+        return;
+    }
+    unsigned long mask = 1UL << node;
+    active_ = syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask,
+                      sizeof(mask) * 8) == 0;
+#else
+    (void)node;
+#endif
+}
+
+ScopedNumaPolicy::~ScopedNumaPolicy() {
+    release();
+}
+
+void ScopedNumaPolicy::release() noexcept {
+#ifdef __linux__
+    if (active_) {
+        syscall(SYS_set_mempolicy, saved_mode_, saved_nodes_, sizeof(saved_nodes_) * 8);
+    }
+#endif
+    active_ = false;
+}
+
+} // namespace lob
@@ -0,0 +1,221 @@
+#include "lob/BinaryCapture.h"
+#include "lob/MarketDataReplay.h"
+#include "lob/BlockCompression.h"
+#include <algorithm>
+#include <cstring>
+
+namespace lob {
+
+namespace {
+
+constexpr char CAPTURE_MAGIC[8] = {'L', 'O', 'B', 'C', 'A', 'P', '0', '1'};
+constexpr uint64_t CAPTURE_ALIGN = 64;
+
+uint64_t align_up(uint64_t n) noexcept {
+    return (n + CAPTURE_ALIGN - 1) & ~(CAPTURE_ALIGN - 1);
+}
+
+} // namespace
+
+bool CaptureWriter::open(const std::string& filename, const TickScale& scale) {
+    (void)close();
+    file_ = std::fopen(filename.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    
+    header_ = CaptureHeader{};
+    std::memcpy(header_.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    header_.byte_order = CAPTURE_BYTE_ORDER;
+    header_.version = CAPTURE_VERSION;
+    header_.record_size = sizeof(CaptureRecord);
+    header_.tick_units = scale.units;
+    header_.tick_decimals = scale.decimals;
+    header_.records_offset = align_up(sizeof(CaptureHeader));
+    
+    symbols_.clear();
+    symbol_index_.clear();
+    buffer_.clear();
+    buffer_.reserve(kBufferRecords);
+    
+    // Placeholder header, rewritten on close
+    ok_ = std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+    return ok_;
+}
+
+uint32_t CaptureWriter::symbol_id(std::string_view symbol) {
+    auto [it, inserted] = symbol_index_.try_emplace(std::string(symbol), 
+                                                    static_cast<uint32_t>(symbols_.size()));
+    if (inserted) {
+        symbols_.emplace_back(symbol);
+    }
+    return it->second;
+}
+
+bool CaptureWriter::append(const CaptureRecord& record) {
+    if (!file_) return false;
+    buffer_.push_back(record);
+    ++header_.record_count;
+    if (buffer_.size() >= kBufferRecords) {
+        return flush();
+    }
+    return ok_;
+}
+
+bool CaptureWriter::flush() {
+    if (!buffer_.empty()) {
+        ok_ &= std::fwrite(buffer_.data(), sizeof(CaptureRecord), buffer_.size(), file_) == buffer_.size();
+        buffer_.clear();
+    }
+    return ok_;
+}
+
+bool CaptureWriter::close() {
+    if (!file_) return false;
+    flush();
+    
+    // Symbol table after the records
+    uint64_t records_end = header_.records_offset + header_.record_count * sizeof(CaptureRecord);
+    header_.symbols_offset = align_up(records_end);
+    header_.symbol_count = static_cast<uint32_t>(symbols_.size());
+    static const char zeros[CAPTURE_ALIGN] = {};
+    ok_ &= std::fwrite(zeros, 1, header_.symbols_offset - records_end, file_) == 
+           header_.symbols_offset - records_end;
+    for (const auto& symbol : symbols_) {
+        uint16_t len = static_cast<uint16_t>(std::min<size_t>(symbol.size(), UINT16_MAX));
+        ok_ &= std::fwrite(&len, sizeof(len), 1, file_) == 1;
+        ok_ &= std::fwrite(symbol.data(), 1, len, file_) == len;
+    }
+    
+    ok_ &= std::fseek(file_, 0, SEEK_SET) == 0;
+    ok_ &= std::fwrite(&header_, sizeof(header_), 1, file_) == 1;
+    ok_ &= std::fclose(file_) == 0;
+    file_ = nullptr;
+    return ok_;
+}
+
+bool CaptureReader::open(const std::string& filename) {
+    records_ = nullptr;
+    count_ = 0;
+    symbols_.clear();
+    if (!file_.open(filename) || file_.size() < sizeof(CaptureHeader)) {
+        return false;
+    }
+    
+    CaptureHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 ||
+        header.byte_order != CAPTURE_BYTE_ORDER ||
+        header.version != CAPTURE_VERSION ||
+        header.record_size != sizeof(CaptureRecord)) {
+        return false;
+    }
+    
+    uint64_t size = file_.size();
+    if (header.records_offset > size ||
+        header.record_count > (size - header.records_offset) / sizeof(CaptureRecord) ||
+        header.symbols_offset > size) {
+        return false;
+    }
+    
+    const char* p = file_.data() + header.symbols_offset;
+    const char* end = file_.data() + size;
+    for (uint32_t i = 0; i < header.symbol_count; ++i) {
+        uint16_t len;
+        if (end - p < static_cast<ptrdiff_t>(sizeof(len))) return false;
+        std::memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        if (end - p < len) return false;
+        symbols_.emplace_back(p, len);
+        p += len;
+    }
+    
+    records_ = reinterpret_cast<const CaptureRecord*>(file_.data() + header.records_offset);
+    count_ = header.record_count;
+    scale_ = TickScale(header.tick_units, header.tick_decimals);
+    return true;
+}
+
+bool convert_csv_to_capture(const std::string& csv_file, const std::string& capture_file,
+                            const TickScale& scale, const std::string& default_symbol,
+                            CaptureConvertStats* stats) {
+    DecodedFile file;
+    if (!file.open(csv_file)) {
+        return false;
+    }
+    
+    // Layout is decided by the header line, if any
+    bool multi_symbol = false;
+    std::string_view first = file.view().substr(0, file.view().find('\n'));
+    std::string_view header_fields[MAX_CSV_FIELDS];
+    size_t header_count = split_csv_line(first, header_fields);
+    if (header_fields[0].find("timestamp") != std::string_view::npos) {
+        multi_symbol = header_count > 1 && header_fields[1] == "symbol";
+    }
+    
+    struct Row {
+        std::string_view symbol;
+        MarketDataMessage msg;
+    };
+    std::vector<Row> rows;
+    CsvParseStats parsed = parse_csv_parallel(file.data(), file.size(), rows,
+        [&](const std::string_view* fields, size_t count, bool first_line, Row& row) {
+            if (first_line && fields[0].find("timestamp") != std::string_view::npos) {
+                return RowStatus::Skip;
+            }
+            if (count == 1 && fields[0].empty()) return RowStatus::Skip;
+            
+            std::string_view rest[MAX_CSV_FIELDS];
+            const std::string_view* row_fields = fields;
+            size_t row_count = count;
+            if (multi_symbol) {
+                if (count < 2) return RowStatus::Bad;
+                rest[0] = fields[0];
+                for (size_t i = 2; i < count; ++i) rest[i - 1] = fields[i];
+                row_fields = rest;
+                row_count = count - 1;
+                row.symbol = fields[1];
+            } else {
+                row.symbol = default_symbol;
+            }
+            
+            auto msg = MarketDataReplay::parse_fields(row_fields, row_count, scale);
+            if (!msg) return RowStatus::Bad;
+            row.msg = *msg;
+            return RowStatus::Ok;
+        });
+    
+    CaptureWriter writer;
+    if (!writer.open(capture_file, scale)) {
+        return false;
+    }
+    for (const auto& row : rows) {
+        CaptureRecord record{};
+        record.timestamp = row.msg.timestamp;
+        record.order_id = row.msg.order_id;
+        record.price = row.msg.price.ticks;
+        record.qty = row.msg.qty;
+        record.symbol = writer.symbol_id(row.symbol);
+        record.action = row.msg.action;
+        record.side = row.msg.side;
+        record.order_type = row.msg.order_type;
+        if (!writer.append(record)) {
+            return false;
+        }
+    }
+    
+    if (stats) {
+        stats->rows = rows.size();
+        stats->bad_rows = parsed.bad_rows;
+    }
+    if (!writer.close()) {
+        return false;
+    }
+    if (stats) {
+        CaptureReader check;
+        stats->symbols = check.open(capture_file) ? check.symbols().size() : 0;
+    }
+    return true;
+}
+
+} // namespace lob
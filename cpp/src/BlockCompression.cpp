@@ -0,0 +1,410 @@
+#include "lob/BlockCompression.h"
+#include "lob/WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+namespace lob {
+
+namespace {
+
+constexpr char COMPRESSED_MAGIC[8] = {'L', 'O', 'B', 'Z', 'B', 'L', 'K', '1'};
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_LOG = 14;
+
+inline uint32_t load32(const char* p) noexcept {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t hash32(uint32_t v) noexcept {
+    return (v * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// Lengths of 15 and over continue in 255-valued bytes
+inline char* write_length(char* op, size_t len) noexcept {
+    while (len >= 255) {
+        *op++ = static_cast<char>(255);
+        len -= 255;
+    }
+    *op++ = static_cast<char>(len);
+    return op;
+}
+
+inline bool read_length(const unsigned char*& ip, const unsigned char* iend, size_t& len) noexcept {
+    unsigned char b;
+    do {
+        if (ip == iend) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+char* write_sequence(char* op, const char* literals, size_t lit_len,
+                     size_t offset, size_t match_len) noexcept {
+    char* token = op++;
+    unsigned char t = static_cast<unsigned char>(std::min<size_t>(lit_len, 15) << 4);
+    if (lit_len >= 15) {
+        op = write_length(op, lit_len - 15);
+    }
+    std::memcpy(op, literals, lit_len);
+    op += lit_len;
+    
+    if (match_len > 0) {
+        *op++ = static_cast<char>(offset & 0xFF);
+        *op++ = static_cast<char>(offset >> 8);
+        size_t ml = match_len - MIN_MATCH;
+        t |= static_cast<unsigned char>(std::min<size_t>(ml, 15));
+        if (ml >= 15) {
+            op = write_length(op, ml - 15);
+        }
+    }
+    *token = static_cast<char>(t);
+    return op;
+}
+
+uint64_t align8(uint64_t n) noexcept {
+    return (n + 7) & ~uint64_t(7);
+}
+
+} // namespace
+
+size_t block_compress(const char* src, size_t size, char* dst) {
+    char* op = dst;
+    size_t anchor = 0;
+    
+    if (size > MIN_MATCH) {
+        // Positions are stored +1 so zero means empty
+        std::vector<uint32_t> table(size_t(1) << HASH_LOG, 0);
+        const size_t limit = size - MIN_MATCH;
+        size_t misses = 0;
+        size_t i = 0;
+        
+        while (i <= limit) {
+            uint32_t v = load32(src + i);
+            uint32_t h = hash32(v);
+            size_t cand = table[h];
+            table[h] = static_cast<uint32_t>(i + 1);
+            
+            if (cand == 0 || i - (cand - 1) > MAX_OFFSET || load32(src + cand - 1) != v) {
+                // Step faster through data that does not compress
+                i += 1 + (++misses >> 6);
+                continue;
+            }
+            --cand;
+            misses = 0;
+            
+            size_t match_len = MIN_MATCH;
+            while (i + match_len < size && src[cand + match_len] == src[i + match_len]) {
+                ++match_len;
+            }
+            while (i > anchor && cand > 0 && src[i - 1] == src[cand - 1]) {
+                --i;
+                --cand;
+                ++match_len;
+            }
+            
+            op = write_sequence(op, src + anchor, i - anchor, i - cand, match_len);
+            i += match_len;
+            anchor = i;
+            if (i >= 2 && i - 2 <= limit) {
+                table[hash32(load32(src + i - 2))] = static_cast<uint32_t>(i - 1);
+            }
+        }
+    }
+    
+    // Trailing literals close the block
+    op = write_sequence(op, src + anchor, size - anchor, 0, 0);
+    return static_cast<size_t>(op - dst);
+}
+
+bool block_decompress(const char* src, size_t size, char* dst, size_t raw_size) noexcept {
+    auto ip = reinterpret_cast<const unsigned char*>(src);
+    const unsigned char* iend = ip + size;
+    char* op = dst;
+    char* const oend = dst + raw_size;
+    
+    while (ip < iend) {
+        unsigned char token = *ip++;
+        
+        size_t lit_len = token >> 4;
+        if (lit_len == 15 && !read_length(ip, iend, lit_len)) return false;
+        if (lit_len > static_cast<size_t>(iend - ip) || lit_len > static_cast<size_t>(oend - op)) {
+            return false;
+        }
+        std::memcpy(op, ip, lit_len);
+        ip += lit_len;
+        op += lit_len;
+        if (ip == iend) break;  // Final literal-only sequence
+        
+        if (iend - ip < 2) return false;
+        size_t offset = ip[0] | (size_t(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+        
+        size_t match_len = token & 15;
+        if (match_len == 15 && !read_length(ip, iend, match_len)) return false;
+        match_len += MIN_MATCH;
+        if (match_len > static_cast<size_t>(oend - op)) return false;
+        
+        const char* match = op - offset;
+        if (offset >= match_len) {
+            std::memcpy(op, match, match_len);
+        } else {
+            // Overlapping copy repeats the last `offset` bytes
+            for (size_t k = 0; k < match_len; ++k) {
+                op[k] = match[k];
+            }
+        }
+        op += match_len;
+    }
+    
+    return op == oend;
+}
+
+bool compress_file(const std::string& input, const std::string& output,
+                   size_t block_bytes, size_t threads, CompressStats* stats) {
+    MappedFile in;
+    if (!in.open(input)) {
+        return false;
+    }
+    block_bytes = std::clamp<size_t>(block_bytes, 1024, UINT32_MAX);
+    
+    std::FILE* out = std::fopen(output.c_str(), "wb");
+    if (!out) {
+        return false;
+    }
+    
+    CompressedHeader header{};
+    std::memcpy(header.magic, COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+    header.version = COMPRESSED_VERSION;
+    header.block_bytes = static_cast<uint32_t>(block_bytes);
+    header.raw_size = in.size();
+    header.block_count = (in.size() + block_bytes - 1) / block_bytes;
+    bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+    
+    // Compress a batch of blocks in parallel, then append them in order
+    WorkStealingPool pool(threads);
+    const size_t batch = pool.num_threads() * 2;
+    std::vector<std::vector<char>> coded(batch);
+    std::vector<size_t> coded_size(batch);
+    std::vector<CompressedBlock> index;
+    index.reserve(header.block_count);
+    uint64_t offset = sizeof(header);
+    
+    for (size_t first = 0; ok && first < header.block_count; first += batch) {
+        size_t count = std::min<size_t>(batch, header.block_count - first);
+        std::vector<WorkStealingPool::Task> tasks;
+        for (size_t k = 0; k < count; ++k) {
+            tasks.push_back([&, k] {
+                size_t begin = (first + k) * block_bytes;
+                size_t len = std::min(block_bytes, in.size() - begin);
+                coded[k].resize(block_compress_bound(len));
+                coded_size[k] = block_compress(in.data() + begin, len, coded[k].data());
+            });
+        }
+        pool.run(tasks);
+        
+        for (size_t k = 0; k < count; ++k) {
+            size_t begin = (first + k) * block_bytes;
+            uint32_t raw = static_cast<uint32_t>(std::min(block_bytes, in.size() - begin));
+            const char* payload = coded[k].data();
+            uint32_t stored = static_cast<uint32_t>(coded_size[k]);
+            if (stored >= raw) {
+                payload = in.data() + begin;
+                stored = raw;
+            }
+            ok &= std::fwrite(payload, 1, stored, out) == stored;
+            index.push_back({offset, stored, raw});
+            offset += stored;
+        }
+    }
+    
+    // Index is 8-byte aligned so readers can use it in place
+    static const char zeros[8] = {};
+    header.index_offset = align8(offset);
+    ok &= std::fwrite(zeros, 1, header.index_offset - offset, out) == header.index_offset - offset;
+    ok &= std::fwrite(index.data(), sizeof(CompressedBlock), index.size(), out) == index.size();
+    ok &= std::fseek(out, 0, SEEK_SET) == 0;
+    ok &= std::fwrite(&header, sizeof(header), 1, out) == 1;
+    ok &= std::fclose(out) == 0;
+    
+    if (stats) {
+        stats->raw_bytes = header.raw_size;
+        stats->stored_bytes = header.index_offset + index.size() * sizeof(CompressedBlock);
+        stats->blocks = index.size();
+    }
+    return ok;
+}
+
+bool is_compressed(const char* data, size_t size) noexcept {
+    return size >= sizeof(CompressedHeader) &&
+           std::memcmp(data, COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC)) == 0;
+}
+
+bool CompressedFile::open(const std::string& filename) {
+    MappedFile file;
+    return file.open(filename) && attach(std::move(file));
+}
+
+bool CompressedFile::attach(MappedFile file) {
+    blocks_ = nullptr;
+    if (!is_compressed(file.data(), file.size())) {
+        return false;
+    }
+    
+    CompressedHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    const uint64_t size = file.size();
+    if (header.version != COMPRESSED_VERSION || header.block_bytes == 0 ||
+        header.index_offset % alignof(CompressedBlock) != 0 ||
+        header.index_offset > size ||
+        header.block_count > (size - header.index_offset) / sizeof(CompressedBlock) ||
+        header.block_count != (header.raw_size + header.block_bytes - 1) / header.block_bytes) {
+        return false;
+    }
+    
+    // Block i decodes to [i * block_bytes, ...), so every block but the
+    // last must be exactly block_bytes and the last holds the remainder
+    auto blocks = reinterpret_cast<const CompressedBlock*>(file.data() + header.index_offset);
+    for (uint64_t i = 0; i < header.block_count; ++i) {
+        const CompressedBlock& b = blocks[i];
+        const uint64_t expected = i + 1 < header.block_count
+            ? header.block_bytes
+            : header.raw_size - i * header.block_bytes;
+        if (b.offset > header.index_offset || b.stored_size > header.index_offset - b.offset ||
+            b.raw_size != expected) {
+            return false;
+        }
+    }
+    
+    file_ = std::move(file);
+    header_ = header;
+    blocks_ = reinterpret_cast<const CompressedBlock*>(file_.data() + header.index_offset);
+    return true;
+}
+
+bool CompressedFile::decode_block(size_t i, char* out) const noexcept {
+    const CompressedBlock& b = blocks_[i];
+    const char* payload = file_.data() + b.offset;
+    if (b.stored_size == b.raw_size) {
+        std::memcpy(out, payload, b.raw_size);
+        return true;
+    }
+    return block_decompress(payload, b.stored_size, out, b.raw_size);
+}
+
+bool CompressedFile::decode_all(std::vector<char>& out, size_t threads) const {
+    out.resize(raw_size());
+    std::atomic<bool> ok{true};
+    std::vector<WorkStealingPool::Task> tasks;
+    tasks.reserve(block_count());
+    for (size_t i = 0; i < block_count(); ++i) {
+        tasks.push_back([&, i] {
+            if (!decode_block(i, out.data() + i * block_bytes())) {
+                ok.store(false, std::memory_order_relaxed);
+            }
+        });
+    }
+    WorkStealingPool pool(threads);
+    pool.run(tasks);
+    return ok.load();
+}
+
+bool DecodedFile::open(const std::string& filename, size_t threads) {
+    data_ = nullptr;
+    size_ = 0;
+    compressed_ = false;
+    decoded_.clear();
+    
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    
+    if (is_compressed(file.data(), file.size())) {
+        CompressedFile container;
+        if (!container.attach(std::move(file)) || !container.decode_all(decoded_, threads)) {
+            return false;
+        }
+        compressed_ = true;
+        data_ = decoded_.data();
+        size_ = decoded_.size();
+    } else {
+        plain_ = std::move(file);
+        data_ = plain_.data();
+        size_ = plain_.size();
+    }
+    return true;
+}
+
+CompressedBlockStream::CompressedBlockStream(size_t parallelism)
+    : parallelism_(parallelism ? parallelism : WorkStealingPool().num_threads()) {}
+
+bool CompressedBlockStream::open(const std::string& filename) {
+    MappedFile file;
+    return file.open(filename) && attach(std::move(file));
+}
+
+bool CompressedBlockStream::attach(MappedFile file) {
+    batch_first_ = 0;
+    batch_size_ = 0;
+    batch_pos_ = 0;
+    failed_ = false;
+    if (!file_.attach(std::move(file))) {
+        return false;
+    }
+    buffers_.resize(std::min(parallelism_, std::max<size_t>(file_.block_count(), 1)));
+    return true;
+}
+
+bool CompressedBlockStream::next(const char*& data, size_t& size) {
+    if (batch_pos_ == batch_size_) {
+        if (!decode_batch()) {
+            return false;
+        }
+        batch_pos_ = 0;
+    }
+    data = buffers_[batch_pos_].data();
+    size = buffers_[batch_pos_].size();
+    ++batch_pos_;
+    return true;
+}
+
+bool CompressedBlockStream::decode_batch() {
+    batch_first_ += batch_size_;
+    batch_size_ = std::min(buffers_.size(), file_.block_count() - std::min(batch_first_, file_.block_count()));
+    if (batch_size_ == 0 || failed_) {
+        return false;
+    }
+    
+    std::atomic<bool> ok{true};
+    auto decode = [&](size_t k) {
+        std::vector<char>& buf = buffers_[k];
+        buf.resize(file_.block(batch_first_ + k).raw_size);
+        if (!file_.decode_block(batch_first_ + k, buf.data())) {
+            ok.store(false, std::memory_order_relaxed);
+        }
+    };
+    
+    if (batch_size_ == 1) {
+        decode(0);
+    } else {
+        std::vector<WorkStealingPool::Task> tasks;
+        for (size_t k = 0; k < batch_size_; ++k) {
+            tasks.push_back([&, k] { decode(k); });
+        }
+        WorkStealingPool pool(batch_size_);
+        pool.run(tasks);
+    }
+    
+    failed_ = !ok.load();
+    return !failed_;
+}
+
+} // namespace lob
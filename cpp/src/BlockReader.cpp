@@ -0,0 +1,454 @@
+#include "lob/BlockReader.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LOB_HAVE_PREAD 1
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#define LOB_HAVE_IO_URING 1
+#endif
+#endif
+
+namespace lob {
+
+namespace {
+
+constexpr size_t DIRECT_ALIGN = 4096;
+
+size_t round_up(size_t n, size_t align) noexcept {
+    return (n + align - 1) / align * align;
+}
+
+// Where to continue a block after a short read. O_DIRECT needs the file
+// offset and buffer address sector-aligned, so the partial sector is read
+// again rather than appended to.
+size_t resume_point(size_t filled, bool direct) noexcept {
+    return direct ? filled / DIRECT_ALIGN * DIRECT_ALIGN : filled;
+}
+
+} // namespace
+
+// Per-slot read state plus, with io_uring, the mapped submission and
+// completion rings. liburing is not required; the three syscalls are used
+// directly.
+struct BlockReader::Ring {
+    struct Slot {
+        uint64_t offset = 0;    // File offset of the block
+        size_t needed = 0;      // Bytes of file data in the block
+        size_t filled = 0;      // Bytes in the buffer; aligned when a read is in flight
+        bool in_flight = false;
+        bool done = false;
+    };
+    std::vector<Slot> slots;
+    int current = -1;           // Slot handed to the consumer, if any
+    unsigned in_flight = 0;
+    unsigned pending = 0;       // Queued entries not yet submitted
+
+#ifdef LOB_HAVE_IO_URING
+    int fd = -1;
+    bool fixed = false;         // Buffers registered with the kernel
+    void* sq_ptr = MAP_FAILED;
+    size_t sq_len = 0;
+    void* cq_ptr = MAP_FAILED;
+    size_t cq_len = 0;
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    size_t sqes_len = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_len);
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) munmap(cq_ptr, cq_len);
+        if (sq_ptr != MAP_FAILED) munmap(sq_ptr, sq_len);
+        if (fd >= 0) ::close(fd);
+    }
+
+    bool setup(unsigned entries) {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return false;
+        }
+        
+        sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_len = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_len = cq_len = std::max(sq_len, cq_len);
+        }
+        
+        sq_ptr = mmap(nullptr, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) return false;
+        cq_ptr = single_mmap ? sq_ptr
+                             : mmap(nullptr, cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                    fd, IORING_OFF_CQ_RING);
+        if (cq_ptr == MAP_FAILED) return false;
+        sqes_len = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_len, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED) return false;
+        
+        auto sq = static_cast<char*>(sq_ptr);
+        auto cq = static_cast<char*>(cq_ptr);
+        sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Queue a read; at most one entry per slot is ever outstanding, so the
+    // submission ring (sized to the slot count) cannot overflow
+    void queue_read(int file, size_t slot, char* buf, size_t len, uint64_t offset) {
+        unsigned tail = *sq_tail;
+        unsigned index = tail & *sq_mask;
+        io_uring_sqe& sqe = sqes[index];
+        sqe = io_uring_sqe{};
+        sqe.opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uint64_t>(buf);
+        sqe.len = static_cast<uint32_t>(len);
+        sqe.off = offset;
+        sqe.buf_index = fixed ? static_cast<uint16_t>(slot) : 0;
+        sqe.user_data = slot;
+        sq_array[index] = index;
+        std::atomic_ref<unsigned>(*sq_tail).store(tail + 1, std::memory_order_release);
+        ++pending;
+    }
+
+    // Submit queued entries and wait for at least one completion
+    bool enter(unsigned wait_nr) {
+        while (true) {
+            long ret = syscall(__NR_io_uring_enter, fd, pending, wait_nr,
+                               wait_nr ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (ret >= 0) {
+                pending -= std::min(pending, static_cast<unsigned>(ret));
+                return true;
+            }
+            if (errno != EINTR) return false;
+        }
+    }
+
+    template<typename Fn>
+    void reap(Fn&& on_completion) {
+        unsigned head = *cq_head;
+        unsigned tail = std::atomic_ref<unsigned>(*cq_tail).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes[head & *cq_mask];
+            on_completion(static_cast<size_t>(cqe.user_data), cqe.res);
+        }
+        std::atomic_ref<unsigned>(*cq_head).store(head, std::memory_order_release);
+    }
+#endif
+};
+
+BlockReader::BlockReader() noexcept = default;
+
+BlockReader::~BlockReader() {
+    close();
+}
+
+bool BlockReader::open(const std::string& filename, const BlockReaderOptions& options) {
+    close();
+    failed_ = false;
+    next_offset_ = 0;
+    deliver_offset_ = 0;
+    
+#ifdef LOB_HAVE_PREAD
+    direct_ = false;
+#ifdef O_DIRECT
+    if (options.direct) {
+        fd_ = ::open(filename.c_str(), O_RDONLY | O_DIRECT);
+        direct_ = fd_ >= 0;
+    }
+#endif
+    if (fd_ < 0) {
+        fd_ = ::open(filename.c_str(), O_RDONLY);
+    }
+    if (fd_ < 0) {
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(fd_, &st) != 0) {
+        close();
+        return false;
+    }
+    file_size_ = static_cast<uint64_t>(st.st_size);
+#else
+    stream_ = std::fopen(filename.c_str(), "rb");
+    if (!stream_) {
+        return false;
+    }
+    std::fseek(stream_, 0, SEEK_END);
+    file_size_ = static_cast<uint64_t>(std::ftell(stream_));
+    std::fseek(stream_, 0, SEEK_SET);
+    direct_ = false;
+#endif
+    
+    block_bytes_ = std::max<size_t>(options.block_bytes, 1);
+    if (direct_) {
+        block_bytes_ = round_up(block_bytes_, DIRECT_ALIGN);
+    }
+    
+    bool want_ring = options.backend != ReadBackend::Pread;
+    slots_ = want_ring ? std::max(options.queue_depth, 1u) : 1;
+    buffers_ = static_cast<char*>(
+        std::aligned_alloc(DIRECT_ALIGN, round_up(slots_ * block_bytes_, DIRECT_ALIGN)));
+    if (!buffers_) {
+        close();
+        return false;
+    }
+    ring_ = std::make_unique<Ring>();
+    ring_->slots.resize(slots_);
+    
+    backend_ = ReadBackend::Pread;
+    if (want_ring && start_ring(static_cast<unsigned>(slots_))) {
+        backend_ = ReadBackend::IoUring;
+        return true;
+    }
+    if (options.backend == ReadBackend::IoUring) {
+        close();
+        return false;
+    }
+    
+    // pread fallback: let the kernel read ahead of the consumer
+    ring_ = std::make_unique<Ring>();
+    ring_->slots.resize(1);
+    slots_ = 1;
+#if defined(LOB_HAVE_PREAD) && defined(POSIX_FADV_SEQUENTIAL)
+    (void)posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return true;
+}
+
+void BlockReader::close() noexcept {
+#ifdef LOB_HAVE_IO_URING
+    // Reads still in flight target buffers_, so wait them out first
+    if (ring_ && ring_->fd >= 0) {
+        while (ring_->in_flight > 0 && ring_->enter(1)) {
+            ring_->reap([&](size_t, int) { --ring_->in_flight; });
+        }
+    }
+#endif
+    ring_.reset();
+    std::free(buffers_);
+    buffers_ = nullptr;
+    slots_ = 0;
+#ifdef LOB_HAVE_PREAD
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#else
+    if (stream_) {
+        std::fclose(stream_);
+        stream_ = nullptr;
+    }
+#endif
+}
+
+bool BlockReader::next(const char*& data, size_t& size) {
+    if (!ring_ || failed_) {
+        return false;
+    }
+    return backend_ == ReadBackend::IoUring ? next_ring(data, size) : next_pread(data, size);
+}
+
+bool BlockReader::start_ring(unsigned queue_depth) {
+#ifdef LOB_HAVE_IO_URING
+    if (!ring_->setup(queue_depth)) {
+        return false;
+    }
+    
+    // Registered buffers save the kernel pinning pages on every read; this
+    // can fail under a low RLIMIT_MEMLOCK, in which case plain reads are used
+    std::vector<iovec> iovs(slots_);
+    for (size_t i = 0; i < slots_; ++i) {
+        iovs[i].iov_base = buffers_ + i * block_bytes_;
+        iovs[i].iov_len = block_bytes_;
+    }
+    ring_->fixed = syscall(__NR_io_uring_register, ring_->fd, IORING_REGISTER_BUFFERS,
+                           iovs.data(), static_cast<unsigned>(iovs.size())) == 0;
+    
+    for (size_t i = 0; i < slots_ && next_offset_ < file_size_; ++i) {
+        if (!submit_read(i)) return false;
+    }
+    return ring_->enter(0);
+#else
+    (void)queue_depth;
+    return false;
+#endif
+}
+
+bool BlockReader::submit_read(size_t slot) {
+#ifdef LOB_HAVE_IO_URING
+    Ring::Slot& s = ring_->slots[slot];
+    s.offset = next_offset_;
+    s.needed = static_cast<size_t>(std::min<uint64_t>(block_bytes_, file_size_ - next_offset_));
+    s.filled = 0;
+    s.done = false;
+    s.in_flight = true;
+    next_offset_ += block_bytes_;
+    
+    size_t len = direct_ ? round_up(s.needed, DIRECT_ALIGN) : s.needed;
+    ring_->queue_read(fd_, slot, buffers_ + slot * block_bytes_, len, s.offset);
+    ++ring_->in_flight;
+    return true;
+#else
+    (void)slot;
+    return false;
+#endif
+}
+
+bool BlockReader::next_ring(const char*& data, size_t& size) {
+#ifdef LOB_HAVE_IO_URING
+    Ring& ring = *ring_;
+    
+    // The consumer is done with the previous block; reuse its buffer
+    if (ring.current >= 0) {
+        size_t freed = static_cast<size_t>(ring.current);
+        ring.current = -1;
+        if (next_offset_ < file_size_) {
+            submit_read(freed);
+            if (!ring.enter(0)) {
+                failed_ = true;
+                return false;
+            }
+        }
+    }
+    if (deliver_offset_ >= file_size_) {
+        return false;
+    }
+    
+    size_t slot = static_cast<size_t>(deliver_offset_ / block_bytes_) % slots_;
+    Ring::Slot& want = ring.slots[slot];
+    while (!want.done) {
+        if (!ring.enter(1)) {
+            failed_ = true;
+            return false;
+        }
+        auto read_rest = [&](size_t index, Ring::Slot& s) {
+            size_t len = direct_ ? round_up(s.needed, DIRECT_ALIGN) - s.filled : s.needed - s.filled;
+            ring.queue_read(fd_, index, buffers_ + index * block_bytes_ + s.filled, len,
+                            s.offset + s.filled);
+        };
+        ring.reap([&](size_t index, int res) {
+            Ring::Slot& s = ring.slots[index];
+            if (res == -EINTR || res == -EAGAIN) {
+                read_rest(index, s);
+                return;
+            }
+            --ring.in_flight;
+            s.in_flight = false;
+            if (res < 0) {
+                failed_ = true;
+                s.done = true;
+                return;
+            }
+            const size_t started = s.filled;
+            s.filled += static_cast<size_t>(res);
+            if (res == 0 || s.filled >= s.needed) {
+                s.done = true;
+                return;
+            }
+            // Short read: fetch the rest of the block, from the last whole
+            // sector under O_DIRECT. Less than a sector would never advance.
+            s.filled = resume_point(s.filled, direct_);
+            if (s.filled == started) {
+                failed_ = true;
+                s.done = true;
+                return;
+            }
+            s.in_flight = true;
+            ++ring.in_flight;
+            read_rest(index, s);
+        });
+        if (failed_) {
+            return false;
+        }
+    }
+    
+    data = buffers_ + slot * block_bytes_;
+    size = std::min(want.filled, want.needed);
+    deliver_offset_ += block_bytes_;
+    ring.current = static_cast<int>(slot);
+    return size > 0;
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+bool BlockReader::next_pread(const char*& data, size_t& size) {
+    if (deliver_offset_ >= file_size_) {
+        return false;
+    }
+    
+    size_t needed = static_cast<size_t>(std::min<uint64_t>(block_bytes_, file_size_ - deliver_offset_));
+#ifdef LOB_HAVE_PREAD
+    size_t len = direct_ ? round_up(needed, DIRECT_ALIGN) : needed;
+#ifdef POSIX_FADV_WILLNEED
+    // Start the kernel on the following block while this one is read
+    if (!direct_ && deliver_offset_ + block_bytes_ < file_size_) {
+        (void)posix_fadvise(fd_, static_cast<off_t>(deliver_offset_ + block_bytes_),
+                            static_cast<off_t>(block_bytes_), POSIX_FADV_WILLNEED);
+    }
+#endif
+    
+    size_t filled = 0;
+    while (filled < needed) {
+        ssize_t n = ::pread(fd_, buffers_ + filled, len - filled,
+                            static_cast<off_t>(deliver_offset_ + filled));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            failed_ = true;
+            return false;
+        }
+        if (n == 0) break;
+        const size_t started = filled;
+        filled += static_cast<size_t>(n);
+        if (filled < needed) {
+            // Continue from the last whole sector under O_DIRECT
+            filled = resume_point(filled, direct_);
+            if (filled == started) {
+                failed_ = true;
+                return false;
+            }
+        }
+    }
+    
+#else
+    size_t filled = std::fread(buffers_, 1, needed, stream_);
+#endif
+    
+    data = buffers_;
+    size = std::min(filled, needed);
+    deliver_offset_ += block_bytes_;
+    return size > 0;
+}
+
+} // namespace lob
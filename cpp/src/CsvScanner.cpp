@@ -0,0 +1,118 @@
+#include "lob/CsvScanner.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define LOB_X86_SCAN 1
+#include <immintrin.h>
+#endif
+
+namespace lob {
+
+namespace {
+
+size_t scan_scalar(const char* data, size_t len, uint32_t* out) noexcept {
+    size_t n = 0;
+    for (size_t i = 0; i < len; ++i) {
+        char c = data[i];
+        if (c == ',' || c == '\n') {
+            out[n++] = static_cast<uint32_t>(i);
+        }
+    }
+    return n;
+}
+
+#ifdef LOB_X86_SCAN
+// Append the set bits of mask (offset by base) to out
+inline size_t flatten_bits(uint64_t mask, size_t base, uint32_t* out) noexcept {
+    size_t n = 0;
+    while (mask) {
+        out[n++] = static_cast<uint32_t>(base + __builtin_ctzll(mask));
+        mask &= mask - 1;
+    }
+    return n;
+}
+
+// Scalar scan of the bytes after the last full 64-byte step
+inline size_t scan_tail(const char* data, size_t len, size_t from, uint32_t* out) noexcept {
+    size_t m = scan_scalar(data + from, len - from, out);
+    for (size_t j = 0; j < m; ++j) out[j] += static_cast<uint32_t>(from);
+    return m;
+}
+
+__attribute__((target("sse2")))
+size_t scan_sse2(const char* data, size_t len, uint32_t* out) noexcept {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i newline = _mm_set1_epi8('\n');
+    size_t n = 0;
+    size_t i = 0;
+    // Four vectors per iteration give a 64-bit mask per step
+    for (; i + 64 <= len; i += 64) {
+        uint64_t mask = 0;
+        for (int k = 0; k < 4; ++k) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + k * 16));
+            __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, newline));
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(hit))) << (k * 16);
+        }
+        n += flatten_bits(mask, i, out + n);
+    }
+    return n + scan_tail(data, len, i, out + n);
+}
+
+__attribute__((target("avx2")))
+size_t scan_avx2(const char* data, size_t len, uint32_t* out) noexcept {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i newline = _mm256_set1_epi8('\n');
+    size_t n = 0;
+    size_t i = 0;
+    for (; i + 64 <= len; i += 64) {
+        __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 32));
+        __m256i hit_lo = _mm256_or_si256(_mm256_cmpeq_epi8(lo, comma), _mm256_cmpeq_epi8(lo, newline));
+        __m256i hit_hi = _mm256_or_si256(_mm256_cmpeq_epi8(hi, comma), _mm256_cmpeq_epi8(hi, newline));
+        uint64_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hit_lo)) |
+                        (static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hit_hi))) << 32);
+        n += flatten_bits(mask, i, out + n);
+    }
+    return n + scan_tail(data, len, i, out + n);
+}
+#endif
+
+ScanKernel detect_kernel() noexcept {
+#ifdef LOB_X86_SCAN
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return ScanKernel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return ScanKernel::SSE2;
+#endif
+    return ScanKernel::Scalar;
+}
+
+} // namespace
+
+ScanKernel best_scan_kernel() noexcept {
+    static const ScanKernel kernel = detect_kernel();
+    return kernel;
+}
+
+size_t find_structurals(const char* data, size_t len, uint32_t* out) noexcept {
+    return find_structurals(data, len, out, best_scan_kernel());
+}
+
+size_t find_structurals(const char* data, size_t len, uint32_t* out,
+                        ScanKernel kernel) noexcept {
+#ifdef LOB_X86_SCAN
+    switch (kernel) {
+        case ScanKernel::AVX2:
+            if (best_scan_kernel() == ScanKernel::AVX2) return scan_avx2(data, len, out);
+            [[fallthrough]];
+        case ScanKernel::SSE2:
+            if (best_scan_kernel() != ScanKernel::Scalar) return scan_sse2(data, len, out);
+            break;
+        case ScanKernel::Scalar:
+            break;
+    }
+#else
+    (void)kernel;
+#endif
+    return scan_scalar(data, len, out);
+}
+
+} // namespace lob
@@ -0,0 +1,29 @@
+#include "lob/EventHash.h"
+
+namespace lob {
+
+HashDivergence find_divergence(const std::vector<HashCheckpoint>& a,
+                               const std::vector<HashCheckpoint>& b) noexcept {
+    HashDivergence result;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.size() && j < b.size()) {
+        if (a[i].seq < b[j].seq) {
+            ++i;
+        } else if (b[j].seq < a[i].seq) {
+            ++j;
+        } else {
+            if (a[i].hash != b[j].hash) {
+                result.diverged = true;
+                result.first_diff_seq = a[i].seq;
+                return result;
+            }
+            result.last_match_seq = a[i].seq;
+            ++i;
+            ++j;
+        }
+    }
+    return result;
+}
+
+} // namespace lob
@@ -0,0 +1,248 @@
+#include "lob/ItchDecoder.h"
+#include "lob/MappedFile.h"
+#include <cstdint>
+
+namespace lob {
+
+namespace {
+
+constexpr size_t STOCK_LEN = 8;
+
+constexpr int64_t POW10[] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+    100000000LL, 1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL,
+    10000000000000LL, 100000000000000LL, 1000000000000000LL, 10000000000000000LL,
+    100000000000000000LL, 1000000000000000000LL
+};
+constexpr int MAX_DECIMALS = 18;
+
+// Stock symbols are right-padded with spaces
+SymbolId stock_symbol(const char* p) {
+    size_t len = STOCK_LEN;
+    while (len > 0 && p[len - 1] == ' ') {
+        --len;
+    }
+    return SymbolId(p, len);
+}
+
+size_t required_length(char type) noexcept {
+    switch (type) {
+        case 'R': return itch::STOCK_DIRECTORY_LEN;
+        case 'A': return itch::ADD_ORDER_LEN;
+        case 'F': return itch::ADD_ORDER_MPID_LEN;
+        case 'E': return itch::ORDER_EXECUTED_LEN;
+        case 'C': return itch::EXECUTED_PRICE_LEN;
+        case 'X': return itch::ORDER_CANCEL_LEN;
+        case 'D': return itch::ORDER_DELETE_LEN;
+        case 'U': return itch::ORDER_REPLACE_LEN;
+        default: return 0;
+    }
+}
+
+} // namespace
+
+bool ItchDecoder::decode_file(const std::string& filename) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        return false;
+    }
+    
+    size_t consumed = decode(file.data(), file.size());
+    if (consumed != file.size()) {
+        ++stats_.malformed;  // Truncated final message
+    }
+    return true;
+}
+
+size_t ItchDecoder::decode(const char* data, size_t size) {
+    size_t pos = 0;
+    while (size - pos >= 2) {
+        size_t len = load_be16(data + pos);
+        if (size - pos - 2 < len) {
+            break;
+        }
+        if (len > 0) {
+            on_message(data + pos + 2, len);
+        }
+        pos += 2 + len;
+    }
+    return pos;
+}
+
+const SymbolId& ItchDecoder::symbol(uint16_t locate) const noexcept {
+    static const SymbolId empty;
+    return locate < symbols_.size() ? symbols_[locate] : empty;
+}
+
+Price ItchDecoder::to_price(uint32_t itch_price) const noexcept {
+    // ticks = price / 10^4 / (units / 10^decimals), rounded to nearest.
+    // The powers of ten are cancelled first so the product stays small.
+    if (scale_.units <= 0 || scale_.decimals > MAX_DECIMALS) {
+        return INVALID_PRICE;
+    }
+    int64_t num = itch_price;
+    int64_t den = scale_.units;
+    const int shift = scale_.decimals - itch::PRICE_DECIMALS;
+    if (shift >= 0) {
+        if (num > INT64_MAX / POW10[shift]) {
+            return INVALID_PRICE;   // More ticks than a Price can hold
+        }
+        num *= POW10[shift];
+    } else if (den > INT64_MAX / POW10[-shift]) {
+        return Price(0);            // Tick larger than any ITCH price
+    } else {
+        den *= POW10[-shift];
+    }
+    const int64_t rem = num % den;
+    return Price(num / den + (rem >= den - rem ? 1 : 0));
+}
+
+MatchingEngine* ItchDecoder::book_for(uint16_t locate, const char* stock) {
+    if (locate < books_.size() && books_[locate]) {
+        return books_[locate];
+    }
+    if (!stock) {
+        return nullptr;
+    }
+    
+    SymbolId symbol = stock_symbol(stock);
+    engine_.add_symbol(symbol);  // No-op if already present
+    MatchingEngine* book = engine_.get_engine(symbol);
+    if (locate >= books_.size()) {
+        books_.resize(locate + 1, nullptr);
+        symbols_.resize(locate + 1);
+    }
+    books_[locate] = book;
+    symbols_[locate] = std::move(symbol);
+    return book;
+}
+
+void ItchDecoder::on_message(const char* msg, size_t len) {
+    ++stats_.messages;
+    const char type = msg[0];
+    const size_t required = required_length(type);
+    if (required == 0) {
+        ++stats_.ignored;
+        return;
+    }
+    if (len < required) {
+        ++stats_.malformed;
+        return;
+    }
+    
+    const uint16_t locate = load_be16(msg + 1);
+    const uint64_t ts = load_be48(msg + 5);
+    const uint64_t ref = load_be64(msg + 11);
+    
+    switch (type) {
+        case 'R':
+            ++stats_.directory;
+            (void)book_for(locate, msg + 11);
+            break;
+            
+        case 'A':
+        case 'F': {
+            ++stats_.adds;
+            MatchingEngine* book = book_for(locate, msg + 24);
+            Side side = msg[19] == 'B' ? Side::Buy : Side::Sell;
+            uint32_t shares = load_be32(msg + 20);
+            Price price = to_price(load_be32(msg + 32));
+            if (!book || price == INVALID_PRICE || !book->submit(Order(ref, side, price, shares, ts))) {
+                ++stats_.rejected;
+            } else {
+                orders_[ref] = LiveOrder{book, price, shares, side, locate};
+            }
+            if (book) {
+                drain(locate);
+            }
+            break;
+        }
+        
+        case 'E':
+        case 'C':
+            ++stats_.executes;
+            reduce(ref, load_be32(msg + 19));
+            break;
+            
+        case 'X':
+            ++stats_.cancels;
+            reduce(ref, load_be32(msg + 19));
+            break;
+            
+        case 'D': {
+            ++stats_.deletes;
+            auto it = orders_.find(ref);
+            if (it == orders_.end()) {
+                ++stats_.unknown_orders;
+                break;
+            }
+            const uint16_t order_locate = it->second.locate;
+            if (!it->second.book->cancel(ref)) {
+                ++stats_.rejected;
+            }
+            orders_.erase(it);
+            drain(order_locate);
+            break;
+        }
+        
+        case 'U': {
+            ++stats_.replaces;
+            auto it = orders_.find(ref);
+            if (it == orders_.end()) {
+                ++stats_.unknown_orders;
+                break;
+            }
+            // The replacement carries a new reference number
+            LiveOrder order = it->second;
+            orders_.erase(it);
+            if (!order.book->cancel(ref)) {
+                ++stats_.rejected;
+            }
+            
+            uint64_t new_ref = load_be64(msg + 19);
+            order.shares = load_be32(msg + 27);
+            order.price = to_price(load_be32(msg + 31));
+            if (order.price == INVALID_PRICE || !order.book->submit(Order(new_ref, order.side, order.price, order.shares, ts))) {
+                ++stats_.rejected;
+            } else {
+                orders_[new_ref] = order;
+            }
+            drain(order.locate);
+            break;
+        }
+    }
+}
+
+void ItchDecoder::reduce(uint64_t ref, uint32_t shares) {
+    auto it = orders_.find(ref);
+    if (it == orders_.end()) {
+        ++stats_.unknown_orders;
+        return;
+    }
+    
+    LiveOrder& order = it->second;
+    const uint16_t locate = order.locate;
+    bool ok;
+    if (shares >= order.shares) {
+        ok = order.book->cancel(ref);
+        orders_.erase(it);
+    } else {
+        order.shares -= shares;
+        ok = order.book->replace(ref, order.price, order.shares);
+    }
+    if (!ok) {
+        ++stats_.rejected;
+    }
+    drain(locate);
+}
+
+void ItchDecoder::drain(uint16_t locate) {
+    if (!books_[locate]->poll_sequenced(events_) || !sink_) {
+        return;
+    }
+    for (const SequencedEvent& event : events_) {
+        sink_(symbols_[locate], event);
+    }
+}
+
+} // namespace lob
@@ -0,0 +1,252 @@
+#include "lob/Journal.h"
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LOB_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+namespace {
+
+constexpr char JOURNAL_MAGIC[8] = {'L', 'O', 'B', 'J', 'R', 'N', 'L', '1'};
+constexpr size_t JOURNAL_PAGE = 4096;
+
+constexpr uint64_t align8(uint64_t n) noexcept {
+    return (n + 7) & ~uint64_t(7);
+}
+
+} // namespace
+
+bool Journal::open(const std::string& filename, const JournalConfig& config) {
+    close();
+#ifdef LOB_HAVE_MMAP
+    config_ = config;
+    capacity_ = std::max<size_t>(config.capacity_bytes, JOURNAL_PAGE);
+    capacity_ = (capacity_ + JOURNAL_PAGE - 1) / JOURNAL_PAGE * JOURNAL_PAGE;
+    
+    fd_ = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        return false;
+    }
+    
+    // Reserve the blocks now so appends can never hit ENOSPC via the mapping
+    bool sized = ftruncate(fd_, static_cast<off_t>(capacity_)) == 0;
+#ifdef __linux__
+    sized = sized && posix_fallocate(fd_, 0, static_cast<off_t>(capacity_)) == 0;
+#endif
+    int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+    if (config.prefault) flags |= MAP_POPULATE;
+#endif
+    void* addr = sized ? mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, flags, fd_, 0) : MAP_FAILED;
+    if (addr == MAP_FAILED) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    base_ = static_cast<char*>(addr);
+    
+    JournalFileHeader header{};
+    std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    header.version = JOURNAL_VERSION;
+    header.capacity = capacity_;
+    std::memcpy(base_, &header, sizeof(header));
+    
+    write_pos_ = sizeof(header);
+    command_seq_ = 0;
+    tail_.store(write_pos_, std::memory_order_release);
+    durable_.store(0, std::memory_order_relaxed);
+    records_.store(0, std::memory_order_relaxed);
+    dropped_.store(0, std::memory_order_relaxed);
+    syncs_.store(0, std::memory_order_relaxed);
+    
+    if (config.commit_interval.count() > 0) {
+        stop_ = false;
+        syncer_ = std::thread([this] { sync_loop(); });
+    }
+    return true;
+#else
+    (void)filename;
+    (void)config;
+    return false;
+#endif
+}
+
+void Journal::close() {
+    if (syncer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        syncer_.join();
+    }
+    if (!base_) {
+        return;
+    }
+    
+    (void)flush();
+#ifdef LOB_HAVE_MMAP
+    munmap(base_, capacity_);
+    ::close(fd_);
+#endif
+    base_ = nullptr;
+    fd_ = -1;
+}
+
+bool Journal::append(JournalKind kind, uint8_t type, uint64_t seq,
+                     const void* payload, uint32_t length) noexcept {
+    const uint64_t total = sizeof(JournalRecordHeader) + align8(length);
+    if (!base_ || write_pos_ + total > capacity_) {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+    }
+    
+    char* p = base_ + write_pos_;
+    JournalRecordHeader header{0, kind, type, 0, seq};
+    std::memcpy(p, &header, sizeof(header));
+    std::memcpy(p + sizeof(header), payload, length);
+    
+    // Length goes in last, so a reader never sees a partly written record
+    std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(p)).store(length, std::memory_order_release);
+    write_pos_ += total;
+    tail_.store(write_pos_, std::memory_order_release);
+    records_.store(records_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool Journal::flush() {
+    return sync_to(tail_.load(std::memory_order_acquire));
+}
+
+bool Journal::sync_to(uint64_t end) {
+    std::lock_guard<std::mutex> lock(sync_mutex_);
+    uint64_t durable = durable_.load(std::memory_order_relaxed);
+    if (!base_ || end <= durable) {
+        return true;
+    }
+    
+#ifdef LOB_HAVE_MMAP
+    // msync wants a page-aligned start; the partial page is rewritten
+    uint64_t start = durable / JOURNAL_PAGE * JOURNAL_PAGE;
+    if (msync(base_ + start, end - start, MS_SYNC) != 0) {
+        return false;
+    }
+#endif
+    durable_.store(end, std::memory_order_release);
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void Journal::sync_loop() {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    while (!stop_) {
+        wake_.wait_for(lock, config_.commit_interval, [this] { return stop_; });
+        lock.unlock();
+        (void)flush();
+        lock.lock();
+    }
+}
+
+JournalStats Journal::stats() const noexcept {
+    JournalStats s;
+    s.records = records_.load(std::memory_order_relaxed);
+    s.appended_bytes = tail_.load(std::memory_order_acquire);
+    s.durable_bytes = durable_.load(std::memory_order_acquire);
+    s.dropped = dropped_.load(std::memory_order_relaxed);
+    s.syncs = syncs_.load(std::memory_order_relaxed);
+    return s;
+}
+
+bool JournalRecord::event(EngineEvent& out) const noexcept {
+    if (kind != JournalKind::Event) {
+        return false;
+    }
+    switch (type) {
+        case 0: { TradeEvent e; if (!as(e)) return false; out = e; return true; }
+        case 1: { AcceptEvent e; if (!as(e)) return false; out = e; return true; }
+        case 2: { RejectEvent e; if (!as(e)) return false; out = e; return true; }
+        case 3: { CancelEvent e; if (!as(e)) return false; out = e; return true; }
+        case 4: { ReplaceEvent e; if (!as(e)) return false; out = e; return true; }
+        case 5: { BookTop e; if (!as(e)) return false; out = e; return true; }
+        case 6: { LevelUpdate e; if (!as(e)) return false; out = e; return true; }
+        default: return false;
+    }
+}
+
+bool JournalReader::open(const std::string& filename) {
+    pos_ = 0;
+    if (!file_.open(filename) || file_.size() < sizeof(JournalFileHeader)) {
+        return false;
+    }
+    
+    JournalFileHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        header.version != JOURNAL_VERSION) {
+        return false;
+    }
+    rewind();
+    return true;
+}
+
+bool JournalReader::next(JournalRecord& out) noexcept {
+    if (file_.size() < sizeof(JournalRecordHeader) ||
+        pos_ > file_.size() - sizeof(JournalRecordHeader)) {
+        return false;
+    }
+    
+    JournalRecordHeader header;
+    std::memcpy(&header, file_.data() + pos_, sizeof(header));
+    const size_t body = pos_ + sizeof(header);
+    if (header.length == 0 || header.length > file_.size() - body) {
+        return false;
+    }
+    
+    out.kind = header.kind;
+    out.type = header.type;
+    out.seq = header.seq;
+    out.payload = file_.data() + body;
+    out.length = header.length;
+    pos_ = body + align8(header.length);
+    return true;
+}
+
+size_t replay_journal(JournalReader& reader, MatchingEngine& engine) {
+    size_t accepted = 0;
+    JournalRecord record;
+    while (reader.next(record)) {
+        if (record.kind != JournalKind::Command) {
+            continue;
+        }
+        
+        bool ok = false;
+        switch (static_cast<JournalCommand>(record.type)) {
+            case JournalCommand::Submit: {
+                Order order;
+                ok = record.as(order) && engine.submit(order);
+                break;
+            }
+            case JournalCommand::Cancel: {
+                CancelCommand cmd;
+                ok = record.as(cmd) && engine.cancel(cmd.id);
+                break;
+            }
+            case JournalCommand::Replace: {
+                ReplaceCommand cmd;
+                ok = record.as(cmd) && engine.replace(cmd.id, cmd.price, cmd.qty);
+                break;
+            }
+        }
+        if (ok) {
+            ++accepted;
+        }
+    }
+    return accepted;
+}
+
+} // namespace lob
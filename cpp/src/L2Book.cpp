@@ -0,0 +1,51 @@
+#include "lob/L2Book.h"
+
+namespace lob {
+
+bool L2Book::apply(const LevelUpdate& update) {
+    if (update.kind == LevelUpdateKind::SnapshotStart) {
+        bids_.clear();
+        asks_.clear();
+        seq_ = update.seq;
+        synced_ = true;
+        return true;
+    }
+    if (!synced_ || update.seq != seq_ + 1) {
+        synced_ = false;
+        return false;
+    }
+    seq_ = update.seq;
+    set_level(update);
+    return true;
+}
+
+void L2Book::set_level(const LevelUpdate& update) {
+    if (update.side == Side::Buy) {
+        if (update.qty == 0) {
+            bids_.erase(update.price);
+        } else {
+            bids_[update.price] = Level{update.qty, update.order_count};
+        }
+    } else {
+        if (update.qty == 0) {
+            asks_.erase(update.price);
+        } else {
+            asks_[update.price] = Level{update.qty, update.order_count};
+        }
+    }
+}
+
+void L2Book::get_depth(DepthSnapshot& out, size_t max_levels) const {
+    out.bids.clear();
+    out.asks.clear();
+    for (const auto& [price, level] : bids_) {
+        if (out.bids.size() >= max_levels) break;
+        out.bids.emplace_back(price, level.qty, level.order_count);
+    }
+    for (const auto& [price, level] : asks_) {
+        if (out.asks.size() >= max_levels) break;
+        out.asks.emplace_back(price, level.qty, level.order_count);
+    }
+}
+
+} // namespace lob
@@ -0,0 +1,134 @@
+#include "lob/L3Book.h"
+#include <algorithm>
+
+namespace lob {
+
+bool L3Book::apply(const OrderUpdate& update) {
+    if (update.kind == OrderUpdateKind::Clear) {
+        bids_.clear();
+        asks_.clear();
+        index_.clear();
+        seq_ = update.seq;
+        synced_ = true;
+        return true;
+    }
+    if (!synced_ || update.seq != seq_ + 1) {
+        synced_ = false;
+        return false;
+    }
+    seq_ = update.seq;
+    if (!change(update)) {
+        synced_ = false;
+        return false;
+    }
+    return true;
+}
+
+bool L3Book::change(const OrderUpdate& update) {
+    if (update.kind == OrderUpdateKind::Add) {
+        return insert(update);
+    }
+    
+    auto it = index_.find(update.id);
+    if (it == index_.end()) {
+        return false;
+    }
+    const Location loc = it->second;
+    Queue* queue = find_queue(loc.side, loc.price);
+    if (!queue) {
+        return false;
+    }
+    
+    switch (update.kind) {
+        case OrderUpdateKind::Execute: {
+            Entry& front = queue->front();
+            if (front.id != update.id || front.qty < update.qty) {
+                return false;
+            }
+            front.qty -= update.qty;
+            if (front.qty > 0) {
+                return true;
+            }
+            queue->erase(queue->begin());
+            break;
+        }
+        case OrderUpdateKind::Delete: {
+            if (update.position >= queue->size() || (*queue)[update.position].id != update.id) {
+                return false;
+            }
+            queue->erase(queue->begin() + update.position);
+            break;
+        }
+        case OrderUpdateKind::Modify: {
+            // Only the new position is carried, so look the old one up
+            auto pos = std::find_if(queue->begin(), queue->end(),
+                                    [&](const Entry& e) { return e.id == update.id; });
+            if (pos == queue->end()) {
+                return false;
+            }
+            queue->erase(pos);
+            break;
+        }
+        default:
+            return false;
+    }
+    
+    index_.erase(it);
+    erase_if_empty(loc.side, loc.price);
+    return update.kind != OrderUpdateKind::Modify || insert(update);
+}
+
+bool L3Book::insert(const OrderUpdate& update) {
+    if (update.qty == 0 || !index_.emplace(update.id, Location{update.side, update.price}).second) {
+        return false;
+    }
+    Queue& queue = update.side == Side::Buy ? bids_[update.price] : asks_[update.price];
+    if (update.position != queue.size()) {
+        return false;
+    }
+    queue.push_back(Entry{update.id, update.qty});
+    return true;
+}
+
+const L3Book::Queue* L3Book::queue(Side side, Price price) const noexcept {
+    return const_cast<L3Book*>(this)->find_queue(side, price);
+}
+
+L3Book::Queue* L3Book::find_queue(Side side, Price price) noexcept {
+    if (side == Side::Buy) {
+        auto it = bids_.find(price);
+        return it == bids_.end() ? nullptr : &it->second;
+    }
+    auto it = asks_.find(price);
+    return it == asks_.end() ? nullptr : &it->second;
+}
+
+void L3Book::erase_if_empty(Side side, Price price) {
+    const Queue* queue = find_queue(side, price);
+    if (queue && queue->empty()) {
+        if (side == Side::Buy) {
+            bids_.erase(price);
+        } else {
+            asks_.erase(price);
+        }
+    }
+}
+
+void L3Book::get_depth(DepthSnapshot& out, size_t max_levels) const {
+    out.bids.clear();
+    out.asks.clear();
+    auto add_levels = [max_levels](std::vector<DepthLevel>& side, const auto& levels) {
+        for (const auto& [price, queue] : levels) {
+            if (side.size() >= max_levels) break;
+            uint64_t qty = 0;
+            for (const Entry& entry : queue) {
+                qty += entry.qty;
+            }
+            side.emplace_back(price, qty, queue.size());
+        }
+    };
+    add_levels(out.bids, bids_);
+    add_levels(out.asks, asks_);
+}
+
+} // namespace lob
@@ -1,5 +1,8 @@
 #include "lob/LimitBook.h"
 #include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
 
 namespace lob {
 
@@ -113,10 +116,13 @@ void LimitBook::match_order(Order& order, std::vector<TradeEvent>& out_trades) {
             trade.qty = fill_qty;
             trade.ts = time_source_->now_ns();
             out_trades.push_back(trade);
+            record_order(OrderUpdateKind::Execute, opposite(order.side), trade.maker_id,
+                         best_price, fill_qty, 0);
             
-            // Update quantities
+            // Update quantities (through the level, so its total follows)
             order.qty -= fill_qty;
-            maker_order->remaining_qty -= fill_qty;
+            level.update_front_qty(maker_order->remaining_qty - fill_qty);
+            mark_level(opposite(order.side), best_price);
             
             // Remove maker if fully filled
             if (maker_order->remaining_qty == 0) {
@@ -128,9 +134,6 @@ void LimitBook::match_order(Order& order, std::vector<TradeEvent>& out_trades) {
                 if (level.empty()) {
                     asks_.erase(it);
                 }
-            } else {
-                // Update level quantity
-                level.update_front_qty(maker_order->remaining_qty);
             }
         }
     } else {
@@ -163,10 +166,13 @@ void LimitBook::match_order(Order& order, std::vector<TradeEvent>& out_trades) {
             trade.qty = fill_qty;
             trade.ts = time_source_->now_ns();
             out_trades.push_back(trade);
+            record_order(OrderUpdateKind::Execute, opposite(order.side), trade.maker_id,
+                         best_price, fill_qty, 0);
             
-            // Update quantities
+            // Update quantities (through the level, so its total follows)
             order.qty -= fill_qty;
-            maker_order->remaining_qty -= fill_qty;
+            level.update_front_qty(maker_order->remaining_qty - fill_qty);
+            mark_level(opposite(order.side), best_price);
             
             // Remove maker if fully filled
             if (maker_order->remaining_qty == 0) {
@@ -178,9 +184,6 @@ void LimitBook::match_order(Order& order, std::vector<TradeEvent>& out_trades) {
                 if (level.empty()) {
                     bids_.erase(it);
                 }
-            } else {
-                // Update level quantity
-                level.update_front_qty(maker_order->remaining_qty);
             }
         }
     }
@@ -188,16 +191,24 @@ void LimitBook::match_order(Order& order, std::vector<TradeEvent>& out_trades) {
 
 void LimitBook::add_resting_order(const Order& order) {
     BookOrder book_order(order);
+    size_t position = 0;
     
     // Add to appropriate side
     if (order.side == Side::Buy) {
-        bids_[order.price].add_order(book_order);
+        BookLevel& level = bids_[order.price];
+        position = level.size();
+        level.add_order(book_order);
     } else {
-        asks_[order.price].add_order(book_order);
+        BookLevel& level = asks_[order.price];
+        position = level.size();
+        level.add_order(book_order);
     }
     
     // Index the order
     order_index_[order.id] = {order.side, order.price};
+    mark_level(order.side, order.price);
+    record_order(replacing_ ? OrderUpdateKind::Modify : OrderUpdateKind::Add, order.side,
+                 order.id, order.price, order.qty, position);
 }
 
 bool LimitBook::cancel(OrderId id, CancelEvent& out) {
@@ -206,14 +217,16 @@ bool LimitBook::cancel(OrderId id, CancelEvent& out) {
         return false; // Order not found
     }
     
-    const OrderLocation& loc = it->second;
+    const OrderLocation loc = it->second;
     uint64_t removed_qty = 0;
+    size_t position = 0;
+    mark_level(loc.side, loc.price);
     
     // Remove from appropriate side
     if (loc.side == Side::Buy) {
         auto level_it = bids_.find(loc.price);
         if (level_it != bids_.end()) {
-            level_it->second.remove_order(id, removed_qty);
+            (void)level_it->second.remove_order(id, removed_qty, &position);
             if (level_it->second.empty()) {
                 bids_.erase(level_it);
             }
@@ -221,7 +234,7 @@ bool LimitBook::cancel(OrderId id, CancelEvent& out) {
     } else {
         auto level_it = asks_.find(loc.price);
         if (level_it != asks_.end()) {
-            level_it->second.remove_order(id, removed_qty);
+            (void)level_it->second.remove_order(id, removed_qty, &position);
             if (level_it->second.empty()) {
                 asks_.erase(level_it);
             }
@@ -236,6 +249,10 @@ bool LimitBook::cancel(OrderId id, CancelEvent& out) {
     out.remaining = removed_qty;
     out.ts = time_source_->now_ns();
     
+    if (!replacing_) {
+        record_order(OrderUpdateKind::Delete, loc.side, id, loc.price, removed_qty, position);
+    }
+    
     return true;
 }
 
@@ -270,20 +287,28 @@ bool LimitBook::replace(OrderId id, Price new_price, uint64_t new_qty,
     Order original_order = book_order->order;
     original_order.qty = book_order->remaining_qty;
     
+    // Create new order with replacement details
+    Order new_order = original_order;
+    new_order.price = new_price;
+    new_order.qty = new_qty;
+    
+    // A replacement that goes straight back on the book is one Modify on
+    // the order feed; one that trades is a Delete, Executes and maybe an Add
+    replacing_ = record_orders_ && new_order.is_limit() && new_qty > 0 && !would_cross(new_order);
+    
     // Cancel the original order
     CancelEvent cancel_event;
     if (!cancel(id, cancel_event)) {
+        replacing_ = false;
         return false;
     }
     
-    // Create new order with replacement details
-    Order new_order = original_order;
-    new_order.price = new_price;
-    new_order.qty = new_qty;
     new_order.ts = time_source_->now_ns(); // Update timestamp (loses time priority)
     
     // Add the new order
-    if (!add(new_order, out_trades)) {
+    bool added = add(new_order, out_trades);
+    replacing_ = false;
+    if (!added) {
         // If add fails, we've lost the original order - this is intentional
         // In production, you might want to handle this differently
         return false;
@@ -359,6 +384,67 @@ void LimitBook::cleanup_empty_level(Side side, Price price) {
     }
 }
 
+void LimitBook::collect_level_updates(std::vector<LevelUpdate>& out) {
+    if (changed_levels_.empty()) {
+        return;
+    }
+    const uint64_t ts = time_source_->now_ns();
+    for (const OrderLocation& key : changed_levels_) {
+        uint64_t qty = 0;
+        size_t count = 0;
+        if (key.side == Side::Buy) {
+            auto it = bids_.find(key.price);
+            if (it != bids_.end()) {
+                qty = it->second.total_qty();
+                count = it->second.size();
+            }
+        } else {
+            auto it = asks_.find(key.price);
+            if (it != asks_.end()) {
+                qty = it->second.total_qty();
+                count = it->second.size();
+            }
+        }
+        out.emplace_back(key.side, LevelUpdateKind::Delta, key.price, qty,
+                         static_cast<uint32_t>(count), ts);
+    }
+    changed_levels_.clear();
+}
+
+void LimitBook::snapshot_levels(std::vector<LevelUpdate>& out) {
+    const uint64_t ts = time_source_->now_ns();
+    out.reserve(out.size() + bids_.size() + asks_.size());
+    for (const auto& [price, level] : bids_) {
+        out.emplace_back(Side::Buy, LevelUpdateKind::SnapshotLevel, price, level.total_qty(),
+                         static_cast<uint32_t>(level.size()), ts);
+    }
+    for (const auto& [price, level] : asks_) {
+        out.emplace_back(Side::Sell, LevelUpdateKind::SnapshotLevel, price, level.total_qty(),
+                         static_cast<uint32_t>(level.size()), ts);
+    }
+    changed_levels_.clear();
+}
+
+void LimitBook::snapshot_orders() {
+    if (!record_orders_) {
+        return;
+    }
+    order_updates_.reserve(order_updates_.size() + order_index_.size() + 1);
+    record_order(OrderUpdateKind::Clear, Side::Buy, INVALID_ORDER_ID, INVALID_PRICE,
+                 order_index_.size(), 0);
+    auto record_side = [this](Side side, const auto& levels) {
+        for (const auto& [price, level] : levels) {
+            size_t position = 0;
+            for (const BookOrder& order : level.orders()) {
+                record_order(OrderUpdateKind::Add, side, order.order.id, price,
+                             order.remaining_qty, position++);
+            }
+        }
+    };
+    record_side(Side::Buy, bids_);
+    record_side(Side::Sell, asks_);
+}
+
 void LimitBook::get_depth(DepthSnapshot& out, size_t max_levels) const noexcept {
     out.bids.clear();
     out.asks.clear();
@@ -381,4 +467,135 @@ void LimitBook::get_depth(DepthSnapshot& out, size_t max_levels) const noexcept
     }
 }
 
+void LimitBook::get_depth(FixedDepth& out, size_t max_levels) const noexcept {
+    max_levels = std::min(max_levels, MAX_FIXED_DEPTH);
+    out.ts = time_source_->now_ns();
+    
+    uint32_t count = 0;
+    for (const auto& [price, level] : bids_) {
+        if (count >= max_levels) break;
+        out.bids[count++] = DepthLevel(price, level.total_qty(), level.size());
+    }
+    out.bid_levels = count;
+    
+    count = 0;
+    for (const auto& [price, level] : asks_) {
+        if (count >= max_levels) break;
+        out.asks[count++] = DepthLevel(price, level.total_qty(), level.size());
+    }
+    out.ask_levels = count;
+}
+
+namespace {
+
+constexpr char BOOK_IMAGE_MAGIC[8] = {'L', 'O', 'B', 'B', 'O', 'O', 'K', '1'};
+
+static_assert(std::is_trivially_copyable_v<BookOrder>, "BookOrder is stored as raw bytes");
+
+template<typename T>
+void append_raw(std::vector<char>& out, const T& value) {
+    const char* p = reinterpret_cast<const char*>(&value);
+    out.insert(out.end(), p, p + sizeof(T));
+}
+
+template<typename Levels>
+void save_levels(std::vector<char>& out, const Levels& levels) {
+    for (const auto& [price, level] : levels) {
+        append_raw(out, BookLevelImage{price, level.size()});
+        for (const BookOrder& order : level.orders()) {
+            append_raw(out, order);
+        }
+    }
+}
+
+// Rebuild one side; levels must arrive in the map's own order, so each
+// insert lands at the end
+template<typename Levels, typename Index>
+bool load_levels(const char*& p, const char* end, uint64_t count, Side side,
+                 Levels& levels, Index& index) {
+    typename Levels::key_compare before;
+    for (uint64_t i = 0; i < count; ++i) {
+        BookLevelImage image;
+        if (static_cast<size_t>(end - p) < sizeof(image)) return false;
+        std::memcpy(&image, p, sizeof(image));
+        p += sizeof(image);
+        
+        if (image.order_count == 0 ||
+            image.order_count > static_cast<size_t>(end - p) / sizeof(BookOrder) ||
+            (!levels.empty() && !before(std::prev(levels.end())->first, image.price))) {
+            return false;
+        }
+        
+        BookLevel& level = levels.emplace_hint(levels.end(), image.price, BookLevel())->second;
+        for (uint64_t k = 0; k < image.order_count; ++k) {
+            BookOrder order;
+            std::memcpy(&order, p, sizeof(order));
+            p += sizeof(order);
+            if (order.order.side != side || order.order.price != image.price ||
+                order.remaining_qty == 0 ||
+                !index.emplace(order.order.id, typename Index::mapped_type{side, image.price}).second) {
+                return false;
+            }
+            level.add_order(order);
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void LimitBook::save_image(std::vector<char>& out, uint64_t next_seq) const {
+    BookImageHeader header{};
+    std::memcpy(header.magic, BOOK_IMAGE_MAGIC, sizeof(BOOK_IMAGE_MAGIC));
+    header.version = BOOK_IMAGE_VERSION;
+    header.tick_size = tick_size_;
+    header.order_count = order_index_.size();
+    header.bid_levels = bids_.size();
+    header.ask_levels = asks_.size();
+    header.next_seq = next_seq;
+    
+    out.reserve(out.size() + sizeof(header) +
+                (bids_.size() + asks_.size()) * sizeof(BookLevelImage) +
+                order_index_.size() * sizeof(BookOrder));
+    append_raw(out, header);
+    save_levels(out, bids_);
+    save_levels(out, asks_);
+}
+
+bool LimitBook::load_image(const char* data, size_t size, uint64_t* next_seq) {
+    BookImageHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, BOOK_IMAGE_MAGIC, sizeof(BOOK_IMAGE_MAGIC)) != 0 ||
+        header.version != BOOK_IMAGE_VERSION || header.tick_size != tick_size_ ||
+        header.order_count > size / sizeof(BookOrder)) {
+        return false;
+    }
+    
+    // Build aside and swap in, so a bad image leaves the book as it was
+    decltype(bids_) bids;
+    decltype(asks_) asks;
+    decltype(order_index_) index;
+    index.reserve(header.order_count);
+    
+    const char* p = data + sizeof(header);
+    const char* end = data + size;
+    if (!load_levels(p, end, header.bid_levels, Side::Buy, bids, index) ||
+        !load_levels(p, end, header.ask_levels, Side::Sell, asks, index) ||
+        index.size() != header.order_count || p != end) {
+        return false;
+    }
+    
+    bids_ = std::move(bids);
+    asks_ = std::move(asks);
+    order_index_ = std::move(index);
+    changed_levels_.clear();
+    if (next_seq) {
+        *next_seq = header.next_seq;
+    }
+    return true;
+}
+
 } // namespace lob
@@ -0,0 +1,108 @@
+#include "lob/MappedFile.h"
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LOB_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        open_ = std::exchange(other.open_, false);
+        mapped_ = std::exchange(other.mapped_, false);
+        fallback_ = std::move(other.fallback_);
+        if (!mapped_ && open_) {
+            data_ = fallback_.data();
+        }
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+    
+#ifdef LOB_HAVE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            // Loaders scan front to back
+            madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+            mapped_ = true;
+        }
+    }
+    ::close(fd);
+    
+    if (mapped_ || size_ == 0) {
+        open_ = true;
+        return true;
+    }
+    size_ = 0;
+#endif
+    
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::streamoff length = file.tellg();
+    if (length < 0) {
+        return false;
+    }
+    fallback_.resize(static_cast<size_t>(length));
+    file.seekg(0);
+    
+    // A short read must not pass for the whole file
+    size_t got = 0;
+    while (got < fallback_.size() && file) {
+        file.read(fallback_.data() + got, static_cast<std::streamsize>(fallback_.size() - got));
+        got += static_cast<size_t>(file.gcount());
+    }
+    if (got != fallback_.size()) {
+        fallback_.clear();
+        return false;
+    }
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close() noexcept {
+#ifdef LOB_HAVE_MMAP
+    if (mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+    mapped_ = false;
+    fallback_.clear();
+}
+
+} // namespace lob
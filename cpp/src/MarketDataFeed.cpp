@@ -1,160 +1,94 @@
 #include "lob/MarketDataFeed.h"
+#include "lob/ParallelCsv.h"
+#include "lob/BlockCompression.h"
 #include <algorithm>
 
 namespace lob {
 
-bool MarketDataFeed::parse_csv_line(const std::string& line, 
-                                     std::vector<std::string>& out_fields) {
-    out_fields.clear();
-    std::stringstream ss(line);
-    std::string field;
-    
-    while (std::getline(ss, field, ',')) {
-        // Trim whitespace
-        field.erase(0, field.find_first_not_of(" \t\r\n"));
-        field.erase(field.find_last_not_of(" \t\r\n") + 1);
-        out_fields.push_back(field);
-    }
-    
-    return !out_fields.empty();
-}
+namespace {
 
-bool MarketDataFeed::load_orders(const std::string& filename, 
-                                  std::vector<MDOrder>& out_orders) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+// Shared driver: map the file and parse it in newline-aligned chunks across
+// threads, skipping the header. Rows that fail are counted, not thrown.
+template<typename Record, typename ParseRow>
+bool load_csv(const std::string& filename, std::vector<Record>& out,
+              MDLoadStats& stats, const CsvParseOptions& options, ParseRow&& parse_row) {
+    stats = MDLoadStats{};
+    DecodedFile file;
+    if (!file.open(filename, options.threads)) {
         return false;
     }
     
-    out_orders.clear();
-    std::string line;
-    bool first_line = true;
-    
-    while (std::getline(file, line)) {
-        // Skip header
-        if (first_line) {
-            first_line = false;
-            continue;
-        }
-        
-        if (line.empty()) continue;
-        
-        std::vector<std::string> fields;
-        if (!parse_csv_line(line, fields)) continue;
-        
-        // Expected format: ts_ns,order_id,side,px,qty,type[,new_px,new_qty]
-        if (fields.size() < 6) continue;
-        
-        MDOrder order;
-        try {
-            order.ts_ns = std::stoull(fields[0]);
-            order.order_id = std::stoull(fields[1]);
-            order.side = (fields[2] == "buy" || fields[2] == "Buy" || fields[2] == "BUY") 
-                         ? Side::Buy : Side::Sell;
-            order.price = std::stod(fields[3]);
-            order.qty = std::stoull(fields[4]);
-            order.type = fields[5];
-            
-            if (fields.size() >= 8) {
-                order.new_price = std::stod(fields[6]);
-                order.new_qty = std::stoull(fields[7]);
-            } else {
-                order.new_price = 0.0;
-                order.new_qty = 0;
-            }
-            
-            out_orders.push_back(order);
-        } catch (...) {
-            // Skip malformed lines
-            continue;
-        }
-    }
+    stats.bytes = file.size();
+    CsvParseStats parsed = parse_csv_parallel(file.data(), file.size(), out,
+        [&](const std::string_view* fields, size_t count, bool first_line, Record& record) {
+            if (first_line) return RowStatus::Skip;  // Header
+            if (count == 1 && fields[0].empty()) return RowStatus::Skip;
+            return parse_row(fields, count, record) ? RowStatus::Ok : RowStatus::Bad;
+        }, options);
     
+    stats.lines = parsed.lines;
+    stats.loaded = parsed.loaded;
+    stats.bad_rows = parsed.bad_rows;
+    stats.first_bad_line = parsed.first_bad_line;
     return true;
 }
 
-bool MarketDataFeed::load_quotes(const std::string& filename, 
-                                  std::vector<MDQuote>& out_quotes) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    out_quotes.clear();
-    std::string line;
-    bool first_line = true;
+} // namespace
+
+bool MarketDataFeed::parse_order(const std::string_view* fields, size_t count,
+                                 MDOrder& out) {
+    // Expected format: ts_ns,order_id,side,px,qty,type[,new_px,new_qty]
+    if (count < 6) return false;
+    if (!parse_uint(fields[0], out.ts_ns)) return false;
+    if (!parse_uint(fields[1], out.order_id)) return false;
+    out.side = iequals(fields[2], "buy") ? Side::Buy : Side::Sell;
+    if (!parse_double(fields[3], out.price)) return false;
+    if (!parse_uint(fields[4], out.qty)) return false;
+    out.type.assign(fields[5].data(), fields[5].size());
     
-    while (std::getline(file, line)) {
-        // Skip header
-        if (first_line) {
-            first_line = false;
-            continue;
-        }
-        
-        if (line.empty()) continue;
-        
-        std::vector<std::string> fields;
-        if (!parse_csv_line(line, fields)) continue;
-        
-        // Expected format: ts_ns,bid,ask,bid_qty,ask_qty
-        if (fields.size() < 5) continue;
-        
-        MDQuote quote;
-        try {
-            quote.ts_ns = std::stoull(fields[0]);
-            quote.bid = std::stod(fields[1]);
-            quote.ask = std::stod(fields[2]);
-            quote.bid_qty = std::stoull(fields[3]);
-            quote.ask_qty = std::stoull(fields[4]);
-            
-            out_quotes.push_back(quote);
-        } catch (...) {
-            continue;
-        }
+    if (count >= 8) {
+        if (!parse_double(fields[6], out.new_price)) return false;
+        if (!parse_uint(fields[7], out.new_qty)) return false;
+    } else {
+        out.new_price = 0.0;
+        out.new_qty = 0;
     }
-    
     return true;
 }
 
+bool MarketDataFeed::parse_quote(const std::string_view* fields, size_t count,
+                                 MDQuote& out) noexcept {
+    // Expected format: ts_ns,bid,ask,bid_qty,ask_qty
+    if (count < 5) return false;
+    return parse_uint(fields[0], out.ts_ns) &&
+           parse_double(fields[1], out.bid) &&
+           parse_double(fields[2], out.ask) &&
+           parse_uint(fields[3], out.bid_qty) &&
+           parse_uint(fields[4], out.ask_qty);
+}
+
+bool MarketDataFeed::parse_trade(const std::string_view* fields, size_t count,
+                                 MDTrade& out) noexcept {
+    // Expected format: ts_ns,price,qty
+    if (count < 3) return false;
+    return parse_uint(fields[0], out.ts_ns) &&
+           parse_double(fields[1], out.price) &&
+           parse_uint(fields[2], out.qty);
+}
+
+bool MarketDataFeed::load_orders(const std::string& filename, 
+                                  std::vector<MDOrder>& out_orders) {
+    return load_csv(filename, out_orders, stats_, parse_options_, parse_order);
+}
+
+bool MarketDataFeed::load_quotes(const std::string& filename, 
+                                  std::vector<MDQuote>& out_quotes) {
+    return load_csv(filename, out_quotes, stats_, parse_options_, parse_quote);
+}
+
 bool MarketDataFeed::load_trades(const std::string& filename, 
                                   std::vector<MDTrade>& out_trades) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        return false;
-    }
-    
-    out_trades.clear();
-    std::string line;
-    bool first_line = true;
-    
-    while (std::getline(file, line)) {
-        // Skip header
-        if (first_line) {
-            first_line = false;
-            continue;
-        }
-        
-        if (line.empty()) continue;
-        
-        std::vector<std::string> fields;
-        if (!parse_csv_line(line, fields)) continue;
-        
-        // Expected format: ts_ns,price,qty
-        if (fields.size() < 3) continue;
-        
-        MDTrade trade;
-        try {
-            trade.ts_ns = std::stoull(fields[0]);
-            trade.price = std::stod(fields[1]);
-            trade.qty = std::stoull(fields[2]);
-            
-            out_trades.push_back(trade);
-        } catch (...) {
-            continue;
-        }
-    }
-    
-    return true;
+    return load_csv(filename, out_trades, stats_, parse_options_, parse_trade);
 }
 
 Order MarketDataFeed::to_order(const MDOrder& md_order, double tick_size) {
@@ -1,17 +1,53 @@
 #include "lob/MatchingEngine.h"
+#include "lob/Journal.h"
+#include "lob/Replication.h"
+#include "lob/SharedEventRing.h"
+#include "lob/MappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
 
 namespace lob {
 
 MatchingEngine::MatchingEngine(const EngineConfig& config, 
                                std::shared_ptr<TimeSource> time_source)
     : config_(config)
+    , numa_node_(config.placement.numa_node >= 0
+                     ? config.placement.numa_node
+                     : numa_node_of_cpu(config.placement.matcher_cpu))
+    , numa_scope_(numa_node_)
     , time_source_(time_source ? time_source : std::make_shared<SimulatedTimeSource>())
     , book_(config.tick_size, time_source_)
     , event_buffer_(config.ring_size)
+    , wait_strategy_(std::make_shared<BlockingWait>())
 {
+    numa_scope_.release();
+    book_.set_level_tracking(config_.level_updates);
+    if (config_.order_updates) {
+        book_.set_order_updates(true);
+        order_ring_ = std::make_unique<RingBuffer<OrderUpdate>>(config.ring_size);
+    }
+}
+
+bool MatchingEngine::pin_thread(ThreadRole role) const noexcept {
+    const ThreadPlacement& p = config_.placement;
+    int cpu = -1;
+    switch (role) {
+        case ThreadRole::Matcher:   cpu = p.matcher_cpu; break;
+        case ThreadRole::Publisher: cpu = p.publisher_cpu; break;
+        case ThreadRole::Feed:      cpu = p.feed_cpu; break;
+    }
+    return pin_current_thread(cpu, p.require_isolated);
 }
 
 bool MatchingEngine::submit(const Order& order) {
+    if (journal_) {
+        journal_->append_submit(order);
+    }
+    if (replication_) {
+        replication_->append_submit(order);
+    }
+    
     std::vector<TradeEvent> trades;
     BookTop top;
     
@@ -25,34 +61,54 @@ bool MatchingEngine::submit(const Order& order) {
         for (const auto& trade : trades) {
             emit_event(trade);
         }
+        emit_level_updates();
         
         // Emit book update
         emit_event(top);
+        publish_book(top);
     } else {
         // Emit reject event
         emit_event(RejectEvent(order.id, time_source_->now_ns(), 1));
     }
     
+    publish();
     return success;
 }
 
 bool MatchingEngine::cancel(OrderId id) {
+    if (journal_) {
+        journal_->append_cancel(id);
+    }
+    if (replication_) {
+        replication_->append_cancel(id);
+    }
+    
     CancelEvent cancel_event;
     bool success = book_.cancel(id, cancel_event);
     
     if (success) {
         emit_event(cancel_event);
+        emit_level_updates();
         
         // Emit book update
         BookTop top;
         book_.best_bid_ask(top);
         emit_event(top);
+        publish_book(top);
+        publish();
     }
     
     return success;
 }
 
 bool MatchingEngine::replace(OrderId id, Price new_price, uint64_t new_qty) {
+    if (journal_) {
+        journal_->append_replace(id, new_price, new_qty);
+    }
+    if (replication_) {
+        replication_->append_replace(id, new_price, new_qty);
+    }
+    
     ReplaceEvent replace_event;
     std::vector<TradeEvent> trades;
     
@@ -66,31 +122,286 @@ bool MatchingEngine::replace(OrderId id, Price new_price, uint64_t new_qty) {
         for (const auto& trade : trades) {
             emit_event(trade);
         }
+        emit_level_updates();
         
         // Emit book update
         BookTop top;
         book_.best_bid_ask(top);
         emit_event(top);
+        publish_book(top);
+        publish();
+    } else {
+        // A replacement that failed to re-add still removed the original
+        forward_order_updates();
     }
     
     return success;
 }
 
-bool MatchingEngine::poll_events(std::vector<EngineEvent>& out_events) {
-    out_events.clear();
+void MatchingEngine::restore_book(const LimitBook& book) {
+    const uint64_t order_seq = book_.order_update_seq();
+    book_ = book;
+    book_.set_level_tracking(config_.level_updates);
+    book_.set_order_updates(config_.order_updates, order_seq);
+    if (config_.level_updates) {
+        emit_snapshot_levels();
+    }
+    book_.snapshot_orders();
+    
+    BookTop top;
+    (void)book_.best_bid_ask(top);   // Fills top even when the book is empty
+    emit_event(top);
+    publish_book(top);
+    publish();
+}
+
+bool MatchingEngine::save_snapshot(const std::string& filename) const {
+    std::vector<char> image;
+    book_.save_image(image, next_seq_);
+    
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+bool MatchingEngine::load_snapshot(const std::string& filename) {
+    MappedFile file;
+    uint64_t seq = 0;
+    if (!file.open(filename) || !book_.load_image(file.data(), file.size(), &seq)) {
+        return false;
+    }
+    if (seq > next_seq_) {
+        next_seq_ = seq;
+        emitted_.store(seq - 1, std::memory_order_relaxed);
+    }
+    if (config_.level_updates) {
+        emit_snapshot_levels();
+    }
+    book_.snapshot_orders();
     
-    EngineEvent event;
+    BookTop top;
+    (void)book_.best_bid_ask(top);   // Fills top even when the book is empty
+    emit_event(top);
+    publish_book(top);
+    publish();
+    return true;
+}
+
+template<typename Sink>
+void MatchingEngine::drain_events(Sink&& sink) {
+    // Ring entries are always older than spilled ones, so empty the ring
+    // first and then take the overflow segment in one go
+    SequencedEvent event;
     while (event_buffer_.pop(event)) {
-        out_events.push_back(event);
+        sink(event);
     }
     
+    if (spilling_.load(std::memory_order_acquire)) {
+        // The producer may have refilled the ring after the drain above and
+        // before its first spill. Those entries are older than the spilled
+        // ones; nothing new enters the ring while spilling_ is set.
+        while (event_buffer_.pop(event)) {
+            sink(event);
+        }
+        std::deque<SequencedEvent> spilled;
+        {
+            std::lock_guard<std::mutex> lock(spill_mutex_);
+            spilled.swap(spill_);
+            spilling_.store(false, std::memory_order_release);
+        }
+        for (const auto& e : spilled) {
+            sink(e);
+        }
+    }
+}
+
+bool MatchingEngine::poll_events(std::vector<EngineEvent>& out_events) {
+    out_events.clear();
+    drain_events([&](const SequencedEvent& e) { out_events.push_back(e.event); });
     return !out_events.empty();
 }
 
+bool MatchingEngine::poll_sequenced(std::vector<SequencedEvent>& out_events) {
+    out_events.clear();
+    drain_events([&](const SequencedEvent& e) { out_events.push_back(e); });
+    return !out_events.empty();
+}
+
+bool MatchingEngine::poll_order_updates(std::vector<OrderUpdate>& out_updates) {
+    out_updates.clear();
+    if (order_ring_) {
+        OrderUpdate update;
+        while (order_ring_->pop(update)) {
+            out_updates.push_back(update);
+        }
+    }
+    return !out_updates.empty();
+}
+
+bool MatchingEngine::wait_events(std::vector<EngineEvent>& out_events,
+                                 std::chrono::nanoseconds timeout) {
+    wait_strategy_->wait([this] {
+        return !event_buffer_.empty() || spilling_.load(std::memory_order_acquire);
+    }, timeout);
+    return poll_events(out_events);
+}
+
+EventStats MatchingEngine::event_stats() const noexcept {
+    EventStats stats;
+    stats.emitted = emitted_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.spilled = spilled_.load(std::memory_order_relaxed);
+    stats.blocked = blocked_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(spill_mutex_);
+        stats.spill_depth = spill_.size();
+    }
+    return stats;
+}
+
 void MatchingEngine::emit_event(const EngineEvent& event) {
-    // If buffer is full, events will be dropped
-    // In production, you might want to handle this differently
-    event_buffer_.push(event);
+    SequencedEvent entry(next_seq_++, event);
+    emitted_.store(entry.seq, std::memory_order_relaxed);
+    if (journal_) {
+        journal_->append_event(entry.seq, event);
+    }
+    if (event_ring_) {
+        (void)event_ring_->push(entry);
+    }
+    if (hashing_) {
+        hasher_.update(entry.seq, event);
+        if (hasher_.at_checkpoint()) {
+            std::lock_guard<std::mutex> lock(hash_mutex_);
+            hash_checkpoints_.push_back(hasher_.current());
+        }
+    }
+    
+    // Once spilling has started, keep appending behind the spilled events
+    // until the consumer has drained them, otherwise order would break
+    if (!spilling_.load(std::memory_order_acquire) && event_buffer_.push(entry)) {
+        return;
+    }
+    
+    switch (config_.overflow_policy) {
+        case OverflowPolicy::Drop:
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case OverflowPolicy::Block: {
+            // Requires a consumer on another thread; wake it in case it
+            // is parked waiting for this command to finish
+            blocked_.fetch_add(1, std::memory_order_relaxed);
+            publish();
+            uint32_t spins = 0;
+            while (!event_buffer_.push(entry)) {
+                if (++spins > 64) {
+                    std::this_thread::yield();
+                }
+            }
+            break;
+        }
+        case OverflowPolicy::Spill:
+            spill_event(entry);
+            break;
+    }
+}
+
+void MatchingEngine::emit_level_updates() {
+    if (!config_.level_updates) {
+        return;
+    }
+    if (config_.snapshot_interval != 0 && ++commands_since_snapshot_ >= config_.snapshot_interval) {
+        // The snapshot covers this command's changes too
+        emit_snapshot_levels();
+        return;
+    }
+    level_scratch_.clear();
+    book_.collect_level_updates(level_scratch_);
+    for (LevelUpdate& update : level_scratch_) {
+        update.seq = ++level_seq_;
+        emit_event(update);
+    }
+}
+
+void MatchingEngine::emit_snapshot_levels() {
+    level_scratch_.clear();
+    book_.snapshot_levels(level_scratch_);
+    
+    LevelUpdate start(Side::Buy, LevelUpdateKind::SnapshotStart, INVALID_PRICE, 0,
+                      static_cast<uint32_t>(level_scratch_.size()), time_source_->now_ns());
+    start.seq = ++level_seq_;
+    emit_event(start);
+    for (LevelUpdate& update : level_scratch_) {
+        update.seq = ++level_seq_;
+        emit_event(update);
+    }
+    commands_since_snapshot_ = 0;
+}
+
+void MatchingEngine::emit_depth_snapshot() {
+    emit_snapshot_levels();
+    publish();
+}
+
+void MatchingEngine::emit_order_snapshot() {
+    book_.snapshot_orders();
+    publish();
+}
+
+void MatchingEngine::forward_order_updates() noexcept {
+    if (!order_ring_) {
+        return;
+    }
+    book_.take_order_updates(order_scratch_);
+    for (const OrderUpdate& update : order_scratch_) {
+        if (!order_ring_->push(update)) {
+            order_updates_dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void MatchingEngine::publish_book(const BookTop& top) noexcept {
+    published_top_.write(top);
+    if (config_.published_depth > 0) {
+        book_.get_depth(depth_scratch_, config_.published_depth);
+        published_depth_.write(depth_scratch_);
+    }
+}
+
+void MatchingEngine::publish() noexcept {
+    forward_order_updates();
+    if (hashing_) {
+        published_hash_.write(hasher_.current());
+    }
+    // One wake-up per command rather than per event
+    wait_strategy_->notify();
+}
+
+void MatchingEngine::enable_event_hash(const EventHashConfig& config) {
+    hasher_ = EventHasher(config);
+    published_hash_.write(HashCheckpoint());
+    {
+        std::lock_guard<std::mutex> lock(hash_mutex_);
+        hash_checkpoints_.clear();
+    }
+    hashing_ = true;
+}
+
+std::vector<HashCheckpoint> MatchingEngine::hash_checkpoints(uint64_t from_seq) const {
+    std::lock_guard<std::mutex> lock(hash_mutex_);
+    auto first = std::lower_bound(hash_checkpoints_.begin(), hash_checkpoints_.end(), from_seq,
+                                  [](const HashCheckpoint& c, uint64_t seq) { return c.seq < seq; });
+    return std::vector<HashCheckpoint>(first, hash_checkpoints_.end());
+}
+
+void MatchingEngine::spill_event(const SequencedEvent& event) {
+    std::lock_guard<std::mutex> lock(spill_mutex_);
+    spill_.push_back(event);
+    spilling_.store(true, std::memory_order_release);
+    spilled_.fetch_add(1, std::memory_order_relaxed);
 }
 
 } // namespace lob
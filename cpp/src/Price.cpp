@@ -1,4 +1,141 @@
 #include "lob/Price.h"
+#include <cmath>
 
-// Price implementation is header-only due to constexpr
-// This file exists for potential future extensions
+namespace lob {
+
+namespace {
+
+constexpr int64_t POW10[] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+    100000000LL, 1000000000LL, 10000000000LL, 100000000000LL, 1000000000000LL,
+    10000000000000LL, 100000000000000LL, 1000000000000000LL, 10000000000000000LL,
+    100000000000000000LL, 1000000000000000000LL
+};
+constexpr uint8_t MAX_DECIMALS = 18;
+
+// Parse text as a non-negative fixed-point number with `decimals`
+// fractional digits. Extra digits are cut off; dropped_half is set when they
+// come to at least half a unit, so callers round once. Sets negative on '-'.
+bool parse_fixed(std::string_view text, uint8_t decimals, int64_t& out, bool& negative,
+                 bool& dropped_half) noexcept {
+    size_t i = 0;
+    negative = false;
+    dropped_half = false;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+')) {
+        negative = text[i] == '-';
+        ++i;
+    }
+    
+    uint64_t value = 0;
+    bool any_digit = false;
+    constexpr uint64_t limit = static_cast<uint64_t>(INT64_MAX);
+    
+    for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+        const uint64_t digit = static_cast<uint64_t>(text[i] - '0');
+        if (value > (limit - digit) / 10) return false;
+        value = value * 10 + digit;
+        any_digit = true;
+    }
+    
+    if (value > limit / static_cast<uint64_t>(POW10[decimals])) return false;
+    value *= static_cast<uint64_t>(POW10[decimals]);
+    
+    if (i < text.size() && text[i] == '.') {
+        ++i;
+        uint8_t frac = 0;
+        uint64_t frac_value = 0;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+            any_digit = true;
+            if (frac < decimals) {
+                const uint64_t digit = static_cast<uint64_t>(text[i] - '0');
+                if (frac_value > (limit - digit) / 10) return false;
+                frac_value = frac_value * 10 + digit;
+                ++frac;
+            } else if (frac == decimals) {
+                dropped_half = text[i] >= '5';
+                ++frac;  // The first dropped digit says whether the rest is >= 1/2
+            }
+        }
+        if (frac < decimals) {
+            frac_value *= static_cast<uint64_t>(POW10[decimals - frac]);
+        }
+        if (frac_value > limit - value) return false;
+        value += frac_value;
+    }
+    
+    if (!any_digit || i != text.size()) return false;
+    out = static_cast<int64_t>(value);
+    return true;
+}
+
+} // namespace
+
+bool TickScale::parse(std::string_view text, TickScale& out) noexcept {
+    // Count fractional digits, ignoring trailing zeros
+    size_t dot = text.find('.');
+    size_t end = text.size();
+    if (dot != std::string_view::npos) {
+        while (end > dot + 1 && text[end - 1] == '0') --end;
+    }
+    uint8_t decimals = dot == std::string_view::npos ? 0 
+                                                     : static_cast<uint8_t>(end - dot - 1);
+    if (decimals > MAX_DECIMALS) return false;
+    
+    int64_t units = 0;
+    bool negative = false;
+    bool dropped_half = false;
+    if (!parse_fixed(text.substr(0, end), decimals, units, negative, dropped_half)) return false;
+    if (negative || units <= 0) return false;
+    out = TickScale(units, decimals);
+    return true;
+}
+
+TickScale TickScale::from_double(double tick_size) noexcept {
+    for (uint8_t d = 0; d <= 9; ++d) {
+        double scaled = tick_size * static_cast<double>(POW10[d]);
+        double rounded = std::round(scaled);
+        if (rounded >= 1.0 && std::fabs(scaled - rounded) < 1e-9 * scaled) {
+            return TickScale(static_cast<int64_t>(rounded), d);
+        }
+    }
+    return TickScale(static_cast<int64_t>(std::llround(tick_size * 1e9)), 9);
+}
+
+bool parse_price_ticks(std::string_view text, const TickScale& scale,
+                       int64_t& out_ticks) noexcept {
+    if (scale.units <= 0 || scale.decimals > MAX_DECIMALS) return false;
+    
+    int64_t units = 0;
+    bool negative = false;
+    bool dropped_half = false;
+    if (!parse_fixed(text, scale.decimals, units, negative, dropped_half)) return false;
+    
+    // Nearest tick, half away from zero, rounding the exact value once. The
+    // cut-off digits are under one unit, so they only decide a remainder
+    // that sits right at half of an odd-sized tick.
+    int64_t ticks = units / scale.units;
+    const int64_t rem = units % scale.units;
+    const int64_t half = scale.units / 2;
+    if (rem > half || (rem == half && (scale.units % 2 == 0 || dropped_half))) {
+        ++ticks;
+    }
+    out_ticks = negative ? -ticks : ticks;
+    return true;
+}
+
+size_t parse_price_column(const std::string_view* texts, size_t count,
+                          const TickScale& scale, Price* out) noexcept {
+    size_t failures = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int64_t ticks = 0;
+        if (parse_price_ticks(texts[i], scale, ticks)) {
+            out[i] = Price(ticks);
+        } else {
+            out[i] = INVALID_PRICE;
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+} // namespace lob
@@ -0,0 +1,740 @@
+#include "lob/Replication.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LOB_HAVE_POSIX_IPC 1
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#ifdef LOB_HAVE_POSIX_IPC
+
+// Advance an iovec array past done bytes
+void skip_bytes(iovec*& next, int& remaining, size_t done) {
+    while (remaining > 0 && done >= next->iov_len) {
+        done -= next->iov_len;
+        ++next;
+        --remaining;
+    }
+    if (remaining > 0) {
+        next->iov_base = static_cast<char*>(next->iov_base) + done;
+        next->iov_len -= done;
+    }
+}
+
+// Write a length-prefixed message starting `written` bytes in (prefix
+// included), resuming after partial writes. Socket sends never block: a
+// full socket buffer returns false with `written` recording the progress,
+// and the same message must be offered again to finish it.
+bool write_message(int fd, const char* data, size_t size, bool socket, size_t& written) {
+    uint32_t length = static_cast<uint32_t>(size);
+    iovec iov[2] = {
+        {&length, sizeof(length)},
+        {const_cast<char*>(data), size}
+    };
+    iovec* next = iov;
+    int remaining = 2;
+    skip_bytes(next, remaining, written);
+    while (remaining > 0) {
+        ssize_t n;
+        if (socket) {
+            msghdr msg{};
+            msg.msg_iov = next;
+            msg.msg_iovlen = remaining;
+            int flags = MSG_DONTWAIT;
+#ifdef MSG_NOSIGNAL
+            flags |= MSG_NOSIGNAL;
+#endif
+            n = sendmsg(fd, &msg, flags);
+        } else {
+            n = writev(fd, next, remaining);
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        written += static_cast<size_t>(n);
+        skip_bytes(next, remaining, static_cast<size_t>(n));
+    }
+    return true;
+}
+
+bool read_full(int fd, void* dst, size_t size) {
+    char* p = static_cast<char*>(dst);
+    while (size > 0) {
+        ssize_t n = ::read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// poll() takes milliseconds; round up so short waits still wait
+int poll_millis(std::chrono::microseconds timeout) {
+    return static_cast<int>((timeout.count() + 999) / 1000);
+}
+
+bool wait_readable(int fd, int millis) {
+    pollfd pfd{fd, POLLIN, 0};
+    int rc;
+    do {
+        rc = ::poll(&pfd, 1, millis);
+    } while (rc < 0 && errno == EINTR);
+    return rc > 0;
+}
+
+#endif
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// UnixSocketTransport
+
+bool UnixSocketTransport::listen(const std::string& path) {
+    close();
+#ifdef LOB_HAVE_POSIX_IPC
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        return false;
+    }
+    ::unlink(path.c_str());
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 1) != 0) {
+        close();
+        return false;
+    }
+    path_ = path;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool UnixSocketTransport::accept(std::chrono::milliseconds timeout) {
+#ifdef LOB_HAVE_POSIX_IPC
+    if (listen_fd_ < 0 || !wait_readable(listen_fd_, static_cast<int>(timeout.count()))) {
+        return false;
+    }
+    int fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+        return false;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    fd_ = fd;
+    return true;
+#else
+    (void)timeout;
+    return false;
+#endif
+}
+
+bool UnixSocketTransport::connect(const std::string& path) {
+    close();
+#ifdef LOB_HAVE_POSIX_IPC
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool UnixSocketTransport::make_pair(std::shared_ptr<UnixSocketTransport>& a,
+                                    std::shared_ptr<UnixSocketTransport>& b) {
+#ifdef LOB_HAVE_POSIX_IPC
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        return false;
+    }
+    a = std::make_shared<UnixSocketTransport>();
+    b = std::make_shared<UnixSocketTransport>();
+    a->fd_ = fds[0];
+    b->fd_ = fds[1];
+    return true;
+#else
+    (void)a;
+    (void)b;
+    return false;
+#endif
+}
+
+void UnixSocketTransport::close() noexcept {
+#ifdef LOB_HAVE_POSIX_IPC
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(path_.c_str());
+    }
+#endif
+    fd_ = -1;
+    listen_fd_ = -1;
+    sent_ = 0;
+    path_.clear();
+}
+
+bool UnixSocketTransport::send(const char* data, size_t size) {
+#ifdef LOB_HAVE_POSIX_IPC
+    if (fd_ < 0 || !write_message(fd_, data, size, true, sent_)) {
+        return false;
+    }
+    sent_ = 0;
+    return true;
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+bool UnixSocketTransport::receive(std::vector<char>& out, std::chrono::microseconds timeout) {
+#ifdef LOB_HAVE_POSIX_IPC
+    if (fd_ < 0 || failed_ || !wait_readable(fd_, poll_millis(timeout))) {
+        return false;
+    }
+    // Once the prefix is in, the sender has committed to the whole message
+    uint32_t length = 0;
+    if (!read_full(fd_, &length, sizeof(length))) {
+        return false;
+    }
+    if (length > max_message_size()) {
+        failed_ = true;
+        return false;
+    }
+    out.resize(length);
+    return read_full(fd_, out.data(), length);
+#else
+    (void)out;
+    (void)timeout;
+    return false;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// SharedMemoryTransport
+
+struct SharedMemoryTransport::Control {
+    std::atomic<uint64_t> magic;
+    uint64_t capacity;
+    alignas(64) std::atomic<uint64_t> head;     // Bytes written (producer)
+    alignas(64) std::atomic<uint64_t> tail;     // Bytes read (consumer)
+};
+
+namespace {
+
+constexpr uint64_t SHM_MAGIC = 0x314d48534c504552ULL;  // "REPLSHM1"
+
+std::string shm_name(const std::string& name) {
+    return name.empty() || name[0] != '/' ? "/" + name : name;
+}
+
+} // namespace
+
+bool SharedMemoryTransport::create(const std::string& name, size_t capacity) {
+    close();
+#ifdef LOB_HAVE_POSIX_IPC
+    size_t cap = 4096;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+    name_ = shm_name(name);
+    int fd = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    mapped_ = sizeof(Control) + cap;
+    void* addr = ::ftruncate(fd, static_cast<off_t>(mapped_)) == 0
+        ? ::mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+        : MAP_FAILED;
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        ::shm_unlink(name_.c_str());
+        mapped_ = 0;
+        return false;
+    }
+    control_ = new (addr) Control();
+    control_->capacity = cap;
+    control_->head.store(0, std::memory_order_relaxed);
+    control_->tail.store(0, std::memory_order_relaxed);
+    control_->magic.store(SHM_MAGIC, std::memory_order_release);
+    ring_ = static_cast<char*>(addr) + sizeof(Control);
+    mask_ = cap - 1;
+    owner_ = true;
+    return true;
+#else
+    (void)name;
+    (void)capacity;
+    return false;
+#endif
+}
+
+bool SharedMemoryTransport::open(const std::string& name) {
+    close();
+#ifdef LOB_HAVE_POSIX_IPC
+    name_ = shm_name(name);
+    int fd = ::shm_open(name_.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    void* addr = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) > sizeof(Control)) {
+        mapped_ = static_cast<size_t>(st.st_size);
+        addr = ::mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        mapped_ = 0;
+        return false;
+    }
+    control_ = static_cast<Control*>(addr);
+    if (control_->magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+        sizeof(Control) + control_->capacity != mapped_) {
+        close();
+        return false;
+    }
+    ring_ = static_cast<char*>(addr) + sizeof(Control);
+    mask_ = control_->capacity - 1;
+    return true;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void SharedMemoryTransport::close() noexcept {
+#ifdef LOB_HAVE_POSIX_IPC
+    if (control_) {
+        ::munmap(control_, mapped_);
+    }
+    if (owner_) {
+        ::shm_unlink(name_.c_str());
+    }
+#endif
+    control_ = nullptr;
+    ring_ = nullptr;
+    mapped_ = 0;
+    mask_ = 0;
+    owner_ = false;
+    name_.clear();
+}
+
+void SharedMemoryTransport::copy_in(uint64_t pos, const void* src, size_t size) noexcept {
+    size_t offset = pos & mask_;
+    size_t first = std::min<size_t>(size, mask_ + 1 - offset);
+    std::memcpy(ring_ + offset, src, first);
+    std::memcpy(ring_, static_cast<const char*>(src) + first, size - first);
+}
+
+void SharedMemoryTransport::copy_out(uint64_t pos, void* dst, size_t size) const noexcept {
+    size_t offset = pos & mask_;
+    size_t first = std::min<size_t>(size, mask_ + 1 - offset);
+    std::memcpy(dst, ring_ + offset, first);
+    std::memcpy(static_cast<char*>(dst) + first, ring_, size - first);
+}
+
+bool SharedMemoryTransport::send(const char* data, size_t size) {
+    if (!control_) {
+        return false;
+    }
+    const uint64_t need = sizeof(uint32_t) + size;
+    const uint64_t head = control_->head.load(std::memory_order_relaxed);
+    const uint64_t tail = control_->tail.load(std::memory_order_acquire);
+    if (need > mask_ + 1 - (head - tail)) {
+        return false;
+    }
+    uint32_t length = static_cast<uint32_t>(size);
+    copy_in(head, &length, sizeof(length));
+    copy_in(head + sizeof(length), data, size);
+    control_->head.store(head + need, std::memory_order_release);
+    return true;
+}
+
+size_t SharedMemoryTransport::max_message_size() const noexcept {
+    return control_ ? std::min<size_t>(mask_ + 1 - sizeof(uint32_t), REPLICATION_MAX_MESSAGE) : 0;
+}
+
+bool SharedMemoryTransport::receive(std::vector<char>& out, std::chrono::microseconds timeout) {
+    if (!control_ || failed_) {
+        return false;
+    }
+    const uint64_t tail = control_->tail.load(std::memory_order_relaxed);
+    const auto deadline = Clock::now() + timeout;
+    uint32_t spins = 0;
+    while (control_->head.load(std::memory_order_acquire) == tail) {
+        if (++spins > 64) {
+            if (Clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+    // The producer publishes a whole message at once, so a length running
+    // past the head means the ring is corrupt
+    const uint64_t head = control_->head.load(std::memory_order_acquire);
+    uint32_t length = 0;
+    copy_out(tail, &length, sizeof(length));
+    if (length > max_message_size() || sizeof(length) + length > head - tail) {
+        failed_ = true;
+        return false;
+    }
+    out.resize(length);
+    copy_out(tail + sizeof(length), out.data(), length);
+    control_->tail.store(tail + sizeof(length) + length, std::memory_order_release);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// FileTransport
+
+bool FileTransport::create(const std::string& path) {
+    close();
+#ifdef LOB_HAVE_POSIX_IPC
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    return fd_ >= 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool FileTransport::open(const std::string& path) {
+    close();
+#ifdef LOB_HAVE_POSIX_IPC
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    read_pos_ = 0;
+    return fd_ >= 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+void FileTransport::close() noexcept {
+#ifdef LOB_HAVE_POSIX_IPC
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    fd_ = -1;
+    read_pos_ = 0;
+}
+
+bool FileTransport::send(const char* data, size_t size) {
+#ifdef LOB_HAVE_POSIX_IPC
+    size_t written = 0;
+    return fd_ >= 0 && write_message(fd_, data, size, false, written);
+#else
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+bool FileTransport::receive(std::vector<char>& out, std::chrono::microseconds timeout) {
+#ifdef LOB_HAVE_POSIX_IPC
+    if (fd_ < 0 || failed_) {
+        return false;
+    }
+    // The writer may be mid-append; only consume whole messages
+    const auto deadline = Clock::now() + timeout;
+    while (true) {
+        uint32_t length = 0;
+        off_t pos = static_cast<off_t>(read_pos_);
+        if (::pread(fd_, &length, sizeof(length), pos) == static_cast<ssize_t>(sizeof(length))) {
+            if (length > max_message_size()) {
+                failed_ = true;
+                return false;
+            }
+            out.resize(length);
+            if (length == 0 ||
+                ::pread(fd_, out.data(), length, pos + static_cast<off_t>(sizeof(length))) ==
+                    static_cast<ssize_t>(length)) {
+                read_pos_ += sizeof(length) + length;
+                return true;
+            }
+        }
+        if (Clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+#else
+    (void)out;
+    (void)timeout;
+    return false;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// ReplicationPrimary
+
+ReplicationPrimary::ReplicationPrimary(const MatchingEngine& engine,
+                                       std::shared_ptr<ReplicationTransport> transport,
+                                       const ReplicationConfig& config)
+    : engine_(engine)
+    , transport_(std::move(transport))
+    , latch_(std::dynamic_pointer_cast<LatchedTimeSource>(engine.time_source()))
+    , config_(config)
+{
+    // A frame the transport can never take would block every later one
+    config_.batch_bytes = std::min(config_.batch_bytes, transport_->max_message_size());
+    batch_.reserve(config_.batch_bytes + sizeof(ReplicationCommandHeader) + sizeof(Order));
+    batch_.resize(sizeof(ReplicationFrameHeader));
+}
+
+void ReplicationPrimary::append(JournalCommand type, const void* payload, size_t length) noexcept {
+    const uint64_t stamp = latch_ ? latch_->latch() : engine_.now();
+
+    // Every command already in the batch has executed, so the engine's
+    // hash now is the one the replica should reach after the batch
+    if (batch_count_ > 0 &&
+        batch_.size() + sizeof(ReplicationCommandHeader) + length > config_.batch_bytes) {
+        flush();
+    }
+    if (batch_count_ == 0) {
+        batch_first_seq_ = next_seq_;
+        batch_started_ = Clock::now();
+    }
+
+    ReplicationCommandHeader header{};
+    header.type = type;
+    header.stamp = stamp;
+    const size_t pos = batch_.size();
+    batch_.resize(pos + sizeof(header) + length);
+    std::memcpy(batch_.data() + pos, &header, sizeof(header));
+    std::memcpy(batch_.data() + pos + sizeof(header), payload, length);
+    ++batch_count_;
+    ++next_seq_;
+    commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ReplicationPrimary::seal_batch() {
+    ReplicationFrameHeader header{};
+    header.magic = REPLICATION_MAGIC;
+    header.count = batch_count_;
+    header.first_seq = batch_first_seq_;
+    HashCheckpoint hash = engine_.event_hash();
+    header.hash_seq = hash.seq;
+    header.hash = hash.hash;
+    std::memcpy(batch_.data(), &header, sizeof(header));
+
+    pending_.push_back({std::move(batch_), batch_first_seq_ + batch_count_ - 1});
+    if (spare_.empty()) {
+        batch_ = std::vector<char>();
+        batch_.reserve(config_.batch_bytes + sizeof(ReplicationCommandHeader) + sizeof(Order));
+    } else {
+        batch_ = std::move(spare_.back());
+        spare_.pop_back();
+        batch_.clear();
+    }
+    batch_.resize(sizeof(ReplicationFrameHeader));
+    batch_count_ = 0;
+}
+
+bool ReplicationPrimary::flush() {
+    if (batch_count_ > 0) {
+        seal_batch();
+    }
+    // Frames go out strictly in order; a refused one blocks the rest
+    // until the transport has room again
+    while (!pending_.empty()) {
+        PendingFrame& frame = pending_.front();
+        if (!transport_->send(frame.bytes.data(), frame.bytes.size())) {
+            send_failures_.fetch_add(1, std::memory_order_relaxed);
+            pending_frames_.store(pending_.size(), std::memory_order_relaxed);
+            return false;
+        }
+        sent_seq_.store(frame.last_seq, std::memory_order_relaxed);
+        frames_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(frame.bytes.size(), std::memory_order_relaxed);
+        spare_.push_back(std::move(frame.bytes));
+        pending_.pop_front();
+    }
+    pending_frames_.store(0, std::memory_order_relaxed);
+    return true;
+}
+
+bool ReplicationPrimary::maybe_flush() {
+    if (pending_.empty() &&
+        (batch_count_ == 0 || Clock::now() - batch_started_ < config_.max_delay)) {
+        return true;
+    }
+    return flush();
+}
+
+PrimaryStats ReplicationPrimary::stats() const noexcept {
+    PrimaryStats stats;
+    stats.commands = commands_.load(std::memory_order_relaxed);
+    stats.sent_seq = sent_seq_.load(std::memory_order_relaxed);
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.send_failures = send_failures_.load(std::memory_order_relaxed);
+    stats.pending_frames = pending_frames_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ---------------------------------------------------------------------------
+// ReplicationReplica
+
+ReplicationReplica::ReplicationReplica(MatchingEngine& engine,
+                                       std::shared_ptr<ReplicationTransport> transport)
+    : engine_(engine)
+    , transport_(std::move(transport))
+    , clock_(std::dynamic_pointer_cast<SimulatedTimeSource>(engine.time_source()))
+{
+    ok_.store(clock_ != nullptr, std::memory_order_relaxed);
+}
+
+size_t ReplicationReplica::poll(std::chrono::microseconds timeout) {
+    if (!ok()) {
+        return 0;
+    }
+    if (!transport_->receive(frame_, timeout)) {
+        if (transport_->failed()) {
+            ok_.store(false, std::memory_order_release);
+        }
+        return 0;
+    }
+    ReplicationFrameHeader header;
+    if (frame_.size() < sizeof(header)) {
+        ok_.store(false, std::memory_order_release);
+        return 0;
+    }
+    std::memcpy(&header, frame_.data(), sizeof(header));
+    if (header.magic != REPLICATION_MAGIC ||
+        header.first_seq != applied_seq_.load(std::memory_order_relaxed) + 1 ||
+        !apply(frame_.data() + sizeof(header), frame_.size() - sizeof(header), header.count)) {
+        ok_.store(false, std::memory_order_release);
+        return 0;
+    }
+
+    const uint64_t last = header.first_seq + header.count - 1;
+    frames_.fetch_add(1, std::memory_order_relaxed);
+
+    HashCheckpoint mine = engine_.event_hash();
+    if (header.hash_seq != 0 && mine.seq != 0) {
+        if (mine.seq == header.hash_seq && mine.hash == header.hash) {
+            verified_seq_.store(mine.seq, std::memory_order_relaxed);
+        } else {
+            if (hash_mismatches_.fetch_add(1, std::memory_order_relaxed) == 0) {
+                first_mismatch_seq_.store(header.hash_seq, std::memory_order_relaxed);
+            }
+        }
+    }
+    applied_seq_.store(last, std::memory_order_release);
+    return header.count;
+}
+
+bool ReplicationReplica::apply(const char* data, size_t size, uint32_t expected_count) {
+    // Validate the whole frame before touching the engine
+    size_t pos = 0;
+    size_t count = 0;
+    while (pos < size) {
+        ReplicationCommandHeader header;
+        if (size - pos < sizeof(header)) return false;
+        std::memcpy(&header, data + pos, sizeof(header));
+        pos += sizeof(header);
+        size_t length = 0;
+        switch (header.type) {
+            case JournalCommand::Submit:  length = sizeof(Order); break;
+            case JournalCommand::Cancel:  length = sizeof(CancelCommand); break;
+            case JournalCommand::Replace: length = sizeof(ReplaceCommand); break;
+            default: return false;
+        }
+        if (size - pos < length) return false;
+        pos += length;
+        ++count;
+    }
+    if (count != expected_count) {
+        return false;
+    }
+
+    pos = 0;
+    uint64_t stamp = 0;
+    while (pos < size) {
+        ReplicationCommandHeader header;
+        std::memcpy(&header, data + pos, sizeof(header));
+        pos += sizeof(header);
+        stamp = header.stamp;
+        clock_->set(stamp);
+        switch (header.type) {
+            case JournalCommand::Submit: {
+                Order order;
+                std::memcpy(&order, data + pos, sizeof(order));
+                pos += sizeof(order);
+                (void)engine_.submit(order);
+                break;
+            }
+            case JournalCommand::Cancel: {
+                CancelCommand cmd;
+                std::memcpy(&cmd, data + pos, sizeof(cmd));
+                pos += sizeof(cmd);
+                (void)engine_.cancel(cmd.id);
+                break;
+            }
+            case JournalCommand::Replace: {
+                ReplaceCommand cmd;
+                std::memcpy(&cmd, data + pos, sizeof(cmd));
+                pos += sizeof(cmd);
+                (void)engine_.replace(cmd.id, cmd.price, cmd.qty);
+                break;
+            }
+        }
+    }
+    applied_stamp_.store(stamp, std::memory_order_relaxed);
+    return true;
+}
+
+ReplicaStats ReplicationReplica::stats() const noexcept {
+    ReplicaStats stats;
+    stats.frames = frames_.load(std::memory_order_relaxed);
+    stats.applied_seq = applied_seq_.load(std::memory_order_acquire);
+    stats.applied_stamp = applied_stamp_.load(std::memory_order_relaxed);
+    stats.verified_seq = verified_seq_.load(std::memory_order_relaxed);
+    stats.hash_mismatches = hash_mismatches_.load(std::memory_order_relaxed);
+    stats.first_mismatch_seq = first_mismatch_seq_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace lob
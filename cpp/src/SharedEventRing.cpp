@@ -0,0 +1,244 @@
+#include "lob/SharedEventRing.h"
+#include <new>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define LOB_HAVE_SHM 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+namespace {
+
+constexpr char SHARED_RING_MAGIC[8] = {'L', 'O', 'B', 'S', 'H', 'M', 'R', '1'};
+
+template<typename T>
+bool load_payload(const SharedEventSlot& slot, EngineEvent& out) noexcept {
+    T e;
+    std::memcpy(&e, slot.payload, sizeof(T));
+    out = e;
+    return true;
+}
+
+uint64_t ring_slots(size_t capacity) noexcept {
+    uint64_t n = 1;
+    while (n < capacity) {
+        n <<= 1;
+    }
+    return n;
+}
+
+} // namespace
+
+void encode_event(const SequencedEvent& event, SharedEventSlot& slot) noexcept {
+    slot.seq = event.seq;
+    slot.type = static_cast<uint8_t>(event.event.index());
+    std::visit([&slot](const auto& e) {
+        static_assert(sizeof(e) <= sizeof(slot.payload), "event does not fit a shared slot");
+        std::memcpy(slot.payload, &e, sizeof(e));
+    }, event.event);
+}
+
+bool decode_event(const SharedEventSlot& slot, SequencedEvent& out) noexcept {
+    out.seq = slot.seq;
+    switch (slot.type) {
+        case 0: return load_payload<TradeEvent>(slot, out.event);
+        case 1: return load_payload<AcceptEvent>(slot, out.event);
+        case 2: return load_payload<RejectEvent>(slot, out.event);
+        case 3: return load_payload<CancelEvent>(slot, out.event);
+        case 4: return load_payload<ReplaceEvent>(slot, out.event);
+        case 5: return load_payload<BookTop>(slot, out.event);
+        case 6: return load_payload<LevelUpdate>(slot, out.event);
+        default: return false;
+    }
+}
+
+bool SharedEventRing::create(const std::string& name, size_t capacity) {
+    close();
+#ifdef LOB_HAVE_SHM
+    std::string shm = name.empty() || name[0] != '/' ? "/" + name : name;
+    int fd = ::shm_open(shm.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = create_on(fd, capacity);
+    ::close(fd);
+    if (!ok) {
+        ::shm_unlink(shm.c_str());
+        return false;
+    }
+    name_ = shm;
+    return true;
+#else
+    (void)name;
+    (void)capacity;
+    return false;
+#endif
+}
+
+bool SharedEventRing::create_anonymous(size_t capacity) {
+    close();
+#if defined(LOB_HAVE_SHM) && defined(__linux__) && defined(MFD_CLOEXEC)
+    int fd = ::memfd_create("lob-event-ring", MFD_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (!create_on(fd, capacity)) {
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    return true;
+#else
+    (void)capacity;
+    return false;
+#endif
+}
+
+bool SharedEventRing::create_on(int fd, size_t capacity) {
+#ifdef LOB_HAVE_SHM
+    const uint64_t slots = ring_slots(capacity);
+    const size_t bytes = sizeof(SharedRingHeader) + slots * sizeof(SharedEventSlot);
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        return false;
+    }
+    void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    header_ = new (addr) SharedRingHeader();
+    header_->version = SHARED_RING_VERSION;
+    header_->slot_size = sizeof(SharedEventSlot);
+    header_->capacity = slots;
+    header_->head.store(0, std::memory_order_relaxed);
+    header_->tail.store(0, std::memory_order_relaxed);
+    header_->dropped.store(0, std::memory_order_relaxed);
+    // Magic last, so a consumer that maps early rejects a half-built header
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, SHARED_RING_MAGIC, sizeof(SHARED_RING_MAGIC));
+
+    slots_ = reinterpret_cast<SharedEventSlot*>(static_cast<char*>(addr) + sizeof(SharedRingHeader));
+    mapped_ = bytes;
+    capacity_ = slots;
+    mask_ = slots - 1;
+    return true;
+#else
+    (void)fd;
+    (void)capacity;
+    return false;
+#endif
+}
+
+bool SharedEventRing::open(const std::string& name) {
+    close();
+#ifdef LOB_HAVE_SHM
+    std::string shm = name.empty() || name[0] != '/' ? "/" + name : name;
+    int fd = ::shm_open(shm.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = map(fd);
+    ::close(fd);
+    return ok;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+bool SharedEventRing::attach(int fd) {
+    close();
+    return map(fd);
+}
+
+bool SharedEventRing::map(int fd) {
+#ifdef LOB_HAVE_SHM
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SharedRingHeader)) {
+        return false;
+    }
+    const size_t bytes = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    auto* header = static_cast<SharedRingHeader*>(addr);
+    const uint64_t slots = header->capacity;
+    if (std::memcmp(header->magic, SHARED_RING_MAGIC, sizeof(SHARED_RING_MAGIC)) != 0 ||
+        header->version != SHARED_RING_VERSION ||
+        header->slot_size != sizeof(SharedEventSlot) ||
+        slots == 0 || (slots & (slots - 1)) != 0 ||
+        sizeof(SharedRingHeader) + slots * sizeof(SharedEventSlot) != bytes) {
+        ::munmap(addr, bytes);
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    header_ = header;
+    slots_ = reinterpret_cast<SharedEventSlot*>(static_cast<char*>(addr) + sizeof(SharedRingHeader));
+    mapped_ = bytes;
+    capacity_ = slots;
+    mask_ = slots - 1;
+    head_cache_ = header_->head.load(std::memory_order_acquire);
+    tail_cache_ = header_->tail.load(std::memory_order_acquire);
+    return true;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+void SharedEventRing::close() noexcept {
+#ifdef LOB_HAVE_SHM
+    if (header_) {
+        ::munmap(header_, mapped_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    if (!name_.empty()) {
+        ::shm_unlink(name_.c_str());
+    }
+#endif
+    header_ = nullptr;
+    slots_ = nullptr;
+    mapped_ = 0;
+    capacity_ = 0;
+    mask_ = 0;
+    fd_ = -1;
+    name_.clear();
+    head_cache_ = 0;
+    tail_cache_ = 0;
+    undecodable_ = 0;
+}
+
+size_t SharedEventRing::poll(std::vector<SequencedEvent>& out, size_t max_events) {
+    out.clear();
+    SequencedEvent event;
+    while (out.size() < max_events && front()) {
+        if (pop(event)) {
+            out.push_back(event);
+        }
+    }
+    return out.size();
+}
+
+bool SharedEventRing::wait(std::chrono::nanoseconds timeout) noexcept {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    uint32_t spins = 0;
+    while (!front()) {
+        if (++spins > 256) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+} // namespace lob
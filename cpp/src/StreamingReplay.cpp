@@ -0,0 +1,196 @@
+#include "lob/StreamingReplay.h"
+#include "lob/CsvScanner.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace lob {
+
+namespace {
+
+bool probe_compressed(const std::string& filename) {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    char header[sizeof(CompressedHeader)];
+    size_t n = std::fread(header, 1, sizeof(header), file);
+    std::fclose(file);
+    return is_compressed(header, n);
+}
+
+} // namespace
+
+bool CsvStreamSource::open(const std::string& filename, double tick_size, size_t block_bytes) {
+    BlockReaderOptions options;
+    options.block_bytes = block_bytes ? block_bytes : DEFAULT_STREAM_BLOCK;
+    return open(filename, tick_size, options);
+}
+
+bool CsvStreamSource::open(const std::string& filename, double tick_size,
+                           const BlockReaderOptions& options) {
+    close();
+    
+    // Compressed containers are decoded block by block in memory
+    if (probe_compressed(filename)) {
+        zblocks_ = std::make_unique<CompressedBlockStream>();
+        if (!zblocks_->open(filename)) {
+            zblocks_.reset();
+            return false;
+        }
+    } else if (!blocks_.open(filename, options)) {
+        return false;
+    }
+    
+    scale_ = TickScale::from_double(tick_size);
+    full_[0] = full_[1] = false;
+    read_slot_ = 0;
+    done_ = false;
+    stop_ = false;
+    failed_.store(false, std::memory_order_relaxed);
+    bad_rows_.store(0, std::memory_order_relaxed);
+    reader_ = std::thread([this] { reader_loop(); });
+    return true;
+}
+
+void CsvStreamSource::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+    blocks_.close();
+    zblocks_.reset();
+}
+
+bool CsvStreamSource::next_batch(std::vector<MarketDataMessage>& batch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return full_[read_slot_] || done_ || stop_; });
+    if (!full_[read_slot_]) {
+        batch.clear();
+        return false;
+    }
+    
+    // Hand the filled slot over and give the reader our old buffer to reuse
+    batch.swap(slots_[read_slot_]);
+    full_[read_slot_] = false;
+    read_slot_ ^= 1;
+    lock.unlock();
+    cv_.notify_all();
+    return true;
+}
+
+void CsvStreamSource::reader_loop() {
+    std::string carry;          // Unfinished line from the end of the last block
+    size_t write_slot = 0;
+    bool first_block = true;
+    const size_t block_bytes = zblocks_ ? zblocks_->block_bytes() : blocks_.block_bytes();
+    buffer_capacity_.store(block_bytes, std::memory_order_relaxed);
+    
+    // Claim the write slot, parse into it, and hand it to the consumer
+    auto fill_slot = [&](auto&& fill) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] { return !full_[write_slot] || stop_; });
+            if (stop_) return false;
+        }
+        
+        // The slot is ours until it is marked full
+        std::vector<MarketDataMessage>& slot = slots_[write_slot];
+        slot.clear();
+        fill(slot);
+        if (!slot.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                full_[write_slot] = true;
+            }
+            cv_.notify_all();
+            write_slot ^= 1;
+        }
+        return true;
+    };
+    
+    const char* data;
+    size_t size;
+    while (zblocks_ ? zblocks_->next(data, size) : blocks_.next(data, size)) {
+        // Finish the carried line first, then parse whole lines in place
+        size_t start = 0;
+        if (!carry.empty()) {
+            const char* nl = static_cast<const char*>(std::memchr(data, '\n', size));
+            if (!nl) {
+                carry.append(data, size);
+                buffer_capacity_.store(std::max(block_bytes, carry.capacity()),
+                                       std::memory_order_relaxed);
+                continue;
+            }
+            start = static_cast<size_t>(nl - data) + 1;
+            carry.append(data, start);
+        }
+        
+        size_t last = size;
+        while (last > start && data[last - 1] != '\n') {
+            --last;
+        }
+        
+        bool ok = fill_slot([&](std::vector<MarketDataMessage>& slot) {
+            if (!carry.empty()) {
+                parse_block(carry.data(), carry.size(), first_block, slot);
+                first_block = false;
+            }
+            if (last > start) {
+                parse_block(data + start, last - start, first_block, slot);
+                first_block = false;
+            }
+        });
+        if (!ok) return;
+        
+        carry.assign(data + last, size - last);
+    }
+    
+    // A read error is not the end of the file: the carried text is a
+    // fragment, not a last line
+    if (zblocks_ ? zblocks_->failed() : blocks_.failed()) {
+        failed_.store(true, std::memory_order_release);
+        carry.clear();
+    }
+    
+    // Last line without a trailing newline
+    if (!carry.empty()) {
+        bool ok = fill_slot([&](std::vector<MarketDataMessage>& slot) {
+            parse_block(carry.data(), carry.size(), first_block, slot);
+        });
+        if (!ok) return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+    }
+    cv_.notify_all();
+}
+
+void CsvStreamSource::parse_block(const char* data, size_t size, bool first_block,
+                                  std::vector<MarketDataMessage>& out) {
+    size_t bad = 0;
+    for_each_csv_row(data, size, [&](const std::string_view* fields, size_t count, size_t line_no) {
+        // Skip header if present
+        if (first_block && line_no == 1 &&
+            fields[0].find("timestamp") != std::string_view::npos) {
+            return;
+        }
+        if (count == 1 && fields[0].empty()) return;
+        
+        auto msg = MarketDataReplay::parse_fields(fields, count, scale_);
+        if (msg) {
+            out.push_back(*msg);
+        } else if (fields[0].empty() || fields[0][0] != '#') {
+            ++bad;
+        }
+    });
+    bad_rows_.fetch_add(bad, std::memory_order_relaxed);
+}
+
+} // namespace lob
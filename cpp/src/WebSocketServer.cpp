@@ -0,0 +1,667 @@
+#include "lob/WebSocketServer.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <deque>
+
+#ifdef __linux__
+#define LOB_HAVE_EPOLL 1
+#include <arpa/inet.h>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+namespace {
+
+constexpr char WEBSOCKET_GUID[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+constexpr size_t MAX_REQUEST_BYTES = 8192;      // Upgrade request headers
+constexpr size_t MAX_CLIENT_FRAME = 64 << 10;   // Clients only send control frames
+constexpr size_t MAX_IOV = 64;
+constexpr size_t MAX_POOLED_BLOCKS = 64;
+
+constexpr uint8_t OP_TEXT = 0x1;
+constexpr uint8_t OP_CLOSE = 0x8;
+constexpr uint8_t OP_PING = 0x9;
+constexpr uint8_t OP_PONG = 0xA;
+
+uint32_t rotl32(uint32_t v, int r) noexcept {
+    return (v << r) | (v >> (32 - r));
+}
+
+std::array<uint8_t, 20> sha1(std::string_view data) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    std::string msg(data);
+    msg.push_back(static_cast<char>(0x80));
+    while (msg.size() % 64 != 56) {
+        msg.push_back(0);
+    }
+    const uint64_t bits = static_cast<uint64_t>(data.size()) * 8;
+    for (int i = 7; i >= 0; --i) {
+        msg.push_back(static_cast<char>(bits >> (i * 8)));
+    }
+
+    for (size_t chunk = 0; chunk < msg.size(); chunk += 64) {
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            const auto* p = reinterpret_cast<const unsigned char*>(msg.data() + chunk + i * 4);
+            w[i] = uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+        }
+        for (int i = 16; i < 80; ++i) {
+            w[i] = rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = rotl32(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rotl32(b, 30);
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    std::array<uint8_t, 20> out;
+    for (int i = 0; i < 5; ++i) {
+        out[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+    return out;
+}
+
+std::string base64(const uint8_t* data, size_t size) {
+    static constexpr char TABLE[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((size + 2) / 3 * 4);
+    for (size_t i = 0; i < size; i += 3) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (i + 1 < size) v |= uint32_t(data[i + 1]) << 8;
+        if (i + 2 < size) v |= data[i + 2];
+        out.push_back(TABLE[(v >> 18) & 63]);
+        out.push_back(TABLE[(v >> 12) & 63]);
+        out.push_back(i + 1 < size ? TABLE[(v >> 6) & 63] : '=');
+        out.push_back(i + 2 < size ? TABLE[v & 63] : '=');
+    }
+    return out;
+}
+
+void append_frame_header(std::string& out, uint8_t opcode, size_t length) {
+    out.push_back(static_cast<char>(0x80 | opcode));   // FIN, never fragmented
+    if (length < 126) {
+        out.push_back(static_cast<char>(length));
+    } else if (length <= 0xFFFF) {
+        out.push_back(126);
+        out.push_back(static_cast<char>(length >> 8));
+        out.push_back(static_cast<char>(length));
+    } else {
+        out.push_back(127);
+        for (int i = 7; i >= 0; --i) {
+            out.push_back(static_cast<char>(static_cast<uint64_t>(length) >> (i * 8)));
+        }
+    }
+}
+
+bool iequals(std::string_view a, std::string_view b) noexcept {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+bool icontains(std::string_view haystack, std::string_view needle) noexcept {
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (iequals(haystack.substr(i, needle.size()), needle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string_view trim(std::string_view s) noexcept {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+} // namespace
+
+std::string websocket_accept_key(std::string_view client_key) {
+    std::string text(client_key);
+    text += WEBSOCKET_GUID;
+    const auto digest = sha1(text);
+    return base64(digest.data(), digest.size());
+}
+
+// Encoded frames shared by every client they are queued on
+struct WebSocketServer::FrameBlock {
+    std::string bytes;
+    bool conflatable = true;    // Broadcast data (handshake/control replies are not)
+};
+
+struct WebSocketServer::Client {
+    struct Pending {
+        std::shared_ptr<FrameBlock> block;
+        size_t offset;
+    };
+
+    int fd = -1;
+    bool open = false;          // Handshake done; receives broadcasts
+    bool closing = false;       // Close once the send queue drains
+    bool writable_watch = false;
+    std::string in;             // Unparsed input
+    std::deque<Pending> out;
+    size_t out_bytes = 0;       // Unsent bytes across out
+};
+
+WebSocketServer::WebSocketServer(const WebSocketConfig& config)
+    : WebSocketFeed(config)
+    , read_buf_(std::max<size_t>(config.buffer_size, 4096))
+{
+}
+
+WebSocketServer::~WebSocketServer() {
+    stop();
+}
+
+WebSocketServerStats WebSocketServer::stats() const noexcept {
+    WebSocketServerStats s;
+    s.accepted = accepted_.load(std::memory_order_relaxed);
+    s.clients = open_clients_.load(std::memory_order_relaxed);
+    s.rejected = rejected_.load(std::memory_order_relaxed);
+    s.slow_disconnects = slow_disconnects_.load(std::memory_order_relaxed);
+    s.conflated = conflated_.load(std::memory_order_relaxed);
+    s.frames = frames_.load(std::memory_order_relaxed);
+    s.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+    return s;
+}
+
+#ifdef LOB_HAVE_EPOLL
+
+bool WebSocketServer::start() {
+    if (is_running()) {
+        return false;
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(config().port);
+    const std::string& host = config().host;
+    if (host == "localhost") {
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    } else if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        return false;
+    }
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int one = 1;
+    socklen_t len = sizeof(addr);
+    epoll_event ev{};
+    if (listen_fd_ < 0 ||
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0 ||
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, SOMAXCONN) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0 ||
+        (epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC)) < 0 ||
+        (wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+        close_sockets();
+        return false;
+    }
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd_;
+    bool ok = ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev) == 0;
+    ev.data.fd = wake_fd_;
+    ok = ok && ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) == 0;
+    if (!ok || !WebSocketFeed::start()) {
+        close_sockets();
+        return false;
+    }
+    port_.store(ntohs(addr.sin_port), std::memory_order_release);
+    return true;
+}
+
+void WebSocketServer::stop() {
+    WebSocketFeed::stop();
+    close_sockets();
+}
+
+void WebSocketServer::close_sockets() noexcept {
+    for (auto& [fd, client] : clients_) {
+        ::close(fd);
+    }
+    clients_.clear();
+    open_clients_.store(0, std::memory_order_relaxed);
+    for (int* fd : {&listen_fd_, &epoll_fd_, &wake_fd_}) {
+        if (*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+    port_.store(0, std::memory_order_release);
+}
+
+void WebSocketServer::notify_worker() noexcept {
+    // Pairs with the fence in worker_loop: either the feed thread sees the
+    // new message before parking, or this sees it parked
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) &&
+        !wake_pending_.exchange(true, std::memory_order_acq_rel)) {
+        uint64_t one = 1;
+        (void)!::write(wake_fd_, &one, sizeof(one));
+    }
+}
+
+void WebSocketServer::worker_loop() {
+    std::vector<WebSocketMessage> batch(std::max<size_t>(config().batch_size, 1));
+    epoll_event events[256];
+
+    while (is_running()) {
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int timeout = has_messages() ? 0 : 100;
+        const int n = ::epoll_wait(epoll_fd_, events, 256, timeout);
+        sleeping_.store(false, std::memory_order_relaxed);
+
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == listen_fd_) {
+                accept_clients();
+                continue;
+            }
+            if (fd == wake_fd_) {
+                uint64_t count;
+                (void)!::read(wake_fd_, &count, sizeof(count));
+                wake_pending_.exchange(false, std::memory_order_acq_rel);
+                continue;
+            }
+            auto it = clients_.find(fd);
+            if (it == clients_.end()) {
+                continue;
+            }
+            Client& client = *it->second;
+            bool keep = !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (keep && (events[i].events & (EPOLLIN | EPOLLRDHUP))) {
+                keep = on_readable(client);
+            }
+            if (keep && (events[i].events & EPOLLOUT)) {
+                keep = flush(client);
+            }
+            if (!keep) {
+                close_client(fd);
+            }
+        }
+
+        size_t count;
+        while ((count = take_messages(batch.data(), batch.size())) > 0) {
+            deliver(batch.data(), count);
+        }
+    }
+}
+
+void WebSocketServer::accept_clients() {
+    for (;;) {
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;     // EAGAIN, or an error on a connection that is already gone
+        }
+        accepted_.fetch_add(1, std::memory_order_relaxed);
+        if (clients_.size() >= config().max_connections) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            ::close(fd);
+            continue;
+        }
+        int one = 1;
+        (void)::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = fd;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            continue;
+        }
+        auto client = std::make_unique<Client>();
+        client->fd = fd;
+        clients_[fd] = std::move(client);
+    }
+}
+
+bool WebSocketServer::on_readable(Client& client) {
+    for (;;) {
+        ssize_t n = ::recv(client.fd, read_buf_.data(), read_buf_.size(), 0);
+        if (n > 0) {
+            client.in.append(read_buf_.data(), static_cast<size_t>(n));
+            if (client.in.size() > MAX_CLIENT_FRAME + MAX_REQUEST_BYTES) {
+                return false;
+            }
+            continue;
+        }
+        if (n == 0) {
+            return false;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            return false;
+        }
+        break;
+    }
+
+    if (!client.open) {
+        size_t end = client.in.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            return client.in.size() <= MAX_REQUEST_BYTES;
+        }
+        if (!handshake(client, end)) {
+            return flush(client);   // Sends the 400, then closes
+        }
+    }
+    return read_frames(client);
+}
+
+bool WebSocketServer::handshake(Client& client, size_t header_end) {
+    std::string_view request(client.in.data(), header_end);
+    std::string_view key;
+    bool upgrade = false;
+
+    size_t line_end = request.find("\r\n");
+    if (request.substr(0, 4) != "GET " || line_end == std::string_view::npos) {
+        line_end = std::string_view::npos;
+    }
+    while (line_end != std::string_view::npos && line_end < request.size()) {
+        size_t next = request.find("\r\n", line_end + 2);
+        std::string_view line = request.substr(line_end + 2, next == std::string_view::npos
+                                                             ? std::string_view::npos
+                                                             : next - line_end - 2);
+        size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            std::string_view name = trim(line.substr(0, colon));
+            std::string_view value = trim(line.substr(colon + 1));
+            if (iequals(name, "sec-websocket-key")) {
+                key = value;
+            } else if (iequals(name, "upgrade")) {
+                upgrade = icontains(value, "websocket");
+            }
+        }
+        line_end = next;
+    }
+
+    auto block = std::make_shared<FrameBlock>();
+    block->conflatable = false;
+    if (key.empty() || !upgrade) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        block->bytes = "HTTP/1.1 400 Bad Request\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+        client.closing = true;
+        enqueue_block(client, block);
+        return false;
+    }
+
+    block->bytes = "HTTP/1.1 101 Switching Protocols\r\n"
+                   "Upgrade: websocket\r\n"
+                   "Connection: Upgrade\r\n"
+                   "Sec-WebSocket-Accept: ";
+    block->bytes += websocket_accept_key(key);
+    block->bytes += "\r\n\r\n";
+    client.in.erase(0, header_end + 4);
+    client.open = true;
+    open_clients_.fetch_add(1, std::memory_order_relaxed);
+    enqueue_block(client, block);
+    return true;
+}
+
+bool WebSocketServer::read_frames(Client& client) {
+    size_t pos = 0;
+    while (!client.closing) {
+        const size_t avail = client.in.size() - pos;
+        if (avail < 2) {
+            break;
+        }
+        auto* p = reinterpret_cast<unsigned char*>(&client.in[pos]);
+        const uint8_t opcode = p[0] & 0x0f;
+        uint64_t length = p[1] & 0x7f;
+        size_t header = 2;
+        if (length == 126) {
+            if (avail < 4) break;
+            length = uint64_t(p[2]) << 8 | p[3];
+            header = 4;
+        } else if (length == 127) {
+            if (avail < 10) break;
+            length = 0;
+            for (int i = 0; i < 8; ++i) {
+                length = length << 8 | p[2 + i];
+            }
+            header = 10;
+        }
+        // Client frames must be masked (RFC 6455 5.1)
+        if (!(p[1] & 0x80) || length > MAX_CLIENT_FRAME) {
+            return false;
+        }
+        if (avail < header + 4 + length) {
+            break;
+        }
+        const unsigned char* mask = p + header;
+        char* payload = reinterpret_cast<char*>(p + header + 4);
+        for (size_t i = 0; i < length; ++i) {
+            payload[i] = static_cast<char>(payload[i] ^ mask[i & 3]);
+        }
+
+        if (opcode == OP_CLOSE) {
+            // Echo the status code and close once it is sent
+            send_control(client, OP_CLOSE, payload, std::min<size_t>(length, 2));
+            client.closing = true;
+        } else if (opcode == OP_PING) {
+            send_control(client, OP_PONG, payload, std::min<size_t>(length, 125));
+        }
+        pos += header + 4 + length;
+    }
+    client.in.erase(0, pos);
+    return flush(client);
+}
+
+void WebSocketServer::send_control(Client& client, uint8_t opcode, const char* payload, size_t size) {
+    auto block = std::make_shared<FrameBlock>();
+    block->conflatable = false;
+    append_frame_header(block->bytes, opcode, size);
+    block->bytes.append(payload, size);
+    enqueue_block(client, block);
+}
+
+void WebSocketServer::deliver(const WebSocketMessage* messages, size_t count) {
+    WebSocketFeed::deliver(messages, count);
+    frames_.fetch_add(count, std::memory_order_relaxed);
+    if (open_clients_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    // Encode the batch once; every client's queue points at the same bytes
+    std::shared_ptr<FrameBlock> block = acquire_block();
+    std::string& out = block->bytes;
+    for (size_t i = 0; i < count; ++i) {
+        const WebSocketMessage& msg = messages[i];
+        const std::string_view data = msg.data.empty() ? std::string_view("null") : msg.data;
+        append_frame_header(out, OP_TEXT, 9 + msg.type.size() + 9 + data.size() + 1);
+        out += "{\"type\":\"";
+        out += msg.type;
+        out += "\",\"data\":";
+        out += data;
+        out += '}';
+    }
+
+    dead_.clear();
+    for (auto& [fd, client] : clients_) {
+        if (!client->open || client->closing) {
+            continue;
+        }
+        if (!enqueue_block(*client, block)) {
+            slow_disconnects_.fetch_add(1, std::memory_order_relaxed);
+            dead_.push_back(fd);
+        } else if (!client->writable_watch && !flush(*client)) {
+            dead_.push_back(fd);
+        }
+    }
+    for (int fd : dead_) {
+        close_client(fd);
+    }
+}
+
+bool WebSocketServer::enqueue_block(Client& client, const std::shared_ptr<FrameBlock>& block) {
+    const size_t size = block->bytes.size();
+    if (block->conflatable && client.out_bytes + size > config().max_client_backlog) {
+        if (config().slow_client == SlowClientPolicy::Disconnect) {
+            return false;
+        }
+        // Skip this client ahead: drop batches it has not started on,
+        // keeping a partly written one and any protocol replies
+        auto keep = client.out.begin();
+        for (auto it = client.out.begin(); it != client.out.end(); ++it) {
+            if (it->offset > 0 || !it->block->conflatable) {
+                *keep++ = std::move(*it);
+            } else {
+                client.out_bytes -= it->block->bytes.size();
+                conflated_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        client.out.erase(keep, client.out.end());
+    }
+    client.out.push_back({block, 0});
+    client.out_bytes += size;
+    return true;
+}
+
+bool WebSocketServer::flush(Client& client) {
+    while (!client.out.empty()) {
+        iovec iov[MAX_IOV];
+        size_t n = 0;
+        for (auto it = client.out.begin(); it != client.out.end() && n < MAX_IOV; ++it, ++n) {
+            iov[n].iov_base = it->block->bytes.data() + it->offset;
+            iov[n].iov_len = it->block->bytes.size() - it->offset;
+        }
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = n;
+        ssize_t sent = ::sendmsg(client.fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                watch_writable(client, true);
+                return true;
+            }
+            return false;
+        }
+        bytes_sent_.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+        client.out_bytes -= static_cast<size_t>(sent);
+        size_t left = static_cast<size_t>(sent);
+        while (left > 0) {
+            auto& front = client.out.front();
+            const size_t remaining = front.block->bytes.size() - front.offset;
+            if (left < remaining) {
+                front.offset += left;
+                break;
+            }
+            left -= remaining;
+            client.out.pop_front();
+        }
+    }
+    watch_writable(client, false);
+    // A closing client is dropped once its last bytes are out
+    return !client.closing;
+}
+
+void WebSocketServer::watch_writable(Client& client, bool on) {
+    if (client.writable_watch == on) {
+        return;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP | (on ? EPOLLOUT : 0u);
+    ev.data.fd = client.fd;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, client.fd, &ev) == 0) {
+        client.writable_watch = on;
+    }
+}
+
+void WebSocketServer::close_client(int fd) {
+    auto it = clients_.find(fd);
+    if (it == clients_.end()) {
+        return;
+    }
+    if (it->second->open) {
+        open_clients_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    ::close(fd);    // Also drops it from the epoll set
+    clients_.erase(it);
+}
+
+std::shared_ptr<WebSocketServer::FrameBlock> WebSocketServer::acquire_block() {
+    // A block is free again once no client queue references it
+    for (auto& block : block_pool_) {
+        if (block.use_count() == 1) {
+            block->bytes.clear();
+            return block;
+        }
+    }
+    auto block = std::make_shared<FrameBlock>();
+    if (block_pool_.size() < MAX_POOLED_BLOCKS) {
+        block_pool_.push_back(block);
+    }
+    return block;
+}
+
+#else
+
+bool WebSocketServer::start() {
+    return false;
+}
+
+void WebSocketServer::stop() {
+    WebSocketFeed::stop();
+}
+
+void WebSocketServer::notify_worker() noexcept {
+    WebSocketFeed::notify_worker();
+}
+
+void WebSocketServer::worker_loop() {
+    WebSocketFeed::worker_loop();
+}
+
+void WebSocketServer::deliver(const WebSocketMessage* messages, size_t count) {
+    WebSocketFeed::deliver(messages, count);
+}
+
+#endif
+
+} // namespace lob
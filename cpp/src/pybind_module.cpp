@@ -7,6 +7,7 @@
 #include "lob/Events.h"
 #include "lob/TimeSource.h"
 #include "lob/MarketDataFeed.h"
+#include "lob/BlockCompression.h"
 
 namespace py = pybind11;
 
@@ -33,6 +34,13 @@ PYBIND11_MODULE(lobsim, m) {
         .value("OrderCanceled", lob::EventType::OrderCanceled)
         .value("OrderReplaced", lob::EventType::OrderReplaced)
         .value("BookUpdate", lob::EventType::BookUpdate)
+        .value("LevelUpdate", lob::EventType::LevelUpdate)
+        .export_values();
+
+    py::enum_<lob::OverflowPolicy>(m, "OverflowPolicy")
+        .value("Drop", lob::OverflowPolicy::Drop)
+        .value("Block", lob::OverflowPolicy::Block)
+        .value("Spill", lob::OverflowPolicy::Spill)
         .export_values();
 
     // Price
@@ -117,14 +125,83 @@ PYBIND11_MODULE(lobsim, m) {
         .def_readwrite("ask_qty", &lob::BookTop::ask_qty)
         .def_readwrite("ts", &lob::BookTop::ts);
 
+    py::enum_<lob::LevelUpdateKind>(m, "LevelUpdateKind")
+        .value("Delta", lob::LevelUpdateKind::Delta)
+        .value("SnapshotStart", lob::LevelUpdateKind::SnapshotStart)
+        .value("SnapshotLevel", lob::LevelUpdateKind::SnapshotLevel)
+        .export_values();
+
+    py::class_<lob::LevelUpdate>(m, "LevelUpdate")
+        .def(py::init<>())
+        .def_readwrite("type", &lob::LevelUpdate::type)
+        .def_readwrite("side", &lob::LevelUpdate::side)
+        .def_readwrite("kind", &lob::LevelUpdate::kind)
+        .def_readwrite("order_count", &lob::LevelUpdate::order_count)
+        .def_readwrite("price", &lob::LevelUpdate::price)
+        .def_readwrite("qty", &lob::LevelUpdate::qty)
+        .def_readwrite("seq", &lob::LevelUpdate::seq)
+        .def_readwrite("ts", &lob::LevelUpdate::ts);
+
+    py::enum_<lob::OrderUpdateKind>(m, "OrderUpdateKind")
+        .value("Add", lob::OrderUpdateKind::Add)
+        .value("Modify", lob::OrderUpdateKind::Modify)
+        .value("Delete", lob::OrderUpdateKind::Delete)
+        .value("Execute", lob::OrderUpdateKind::Execute)
+        .value("Clear", lob::OrderUpdateKind::Clear)
+        .export_values();
+
+    py::class_<lob::OrderUpdate>(m, "OrderUpdate")
+        .def(py::init<>())
+        .def_readwrite("seq", &lob::OrderUpdate::seq)
+        .def_readwrite("ts", &lob::OrderUpdate::ts)
+        .def_readwrite("id", &lob::OrderUpdate::id)
+        .def_readwrite("price", &lob::OrderUpdate::price)
+        .def_readwrite("qty", &lob::OrderUpdate::qty)
+        .def_readwrite("position", &lob::OrderUpdate::position)
+        .def_readwrite("kind", &lob::OrderUpdate::kind)
+        .def_readwrite("side", &lob::OrderUpdate::side);
+
     // Config
+    py::class_<lob::ThreadPlacement>(m, "ThreadPlacement")
+        .def(py::init<>())
+        .def_readwrite("matcher_cpu", &lob::ThreadPlacement::matcher_cpu)
+        .def_readwrite("publisher_cpu", &lob::ThreadPlacement::publisher_cpu)
+        .def_readwrite("feed_cpu", &lob::ThreadPlacement::feed_cpu)
+        .def_readwrite("numa_node", &lob::ThreadPlacement::numa_node)
+        .def_readwrite("require_isolated", &lob::ThreadPlacement::require_isolated);
+
     py::class_<lob::EngineConfig>(m, "EngineConfig")
         .def(py::init<>())
         .def(py::init<size_t, size_t, double>(),
              py::arg("max_orders"), py::arg("ring_size"), py::arg("tick_size"))
         .def_readwrite("max_orders", &lob::EngineConfig::max_orders)
         .def_readwrite("ring_size", &lob::EngineConfig::ring_size)
-        .def_readwrite("tick_size", &lob::EngineConfig::tick_size);
+        .def_readwrite("tick_size", &lob::EngineConfig::tick_size)
+        .def_readwrite("overflow_policy", &lob::EngineConfig::overflow_policy)
+        .def_readwrite("placement", &lob::EngineConfig::placement)
+        .def_readwrite("published_depth", &lob::EngineConfig::published_depth)
+        .def_readwrite("level_updates", &lob::EngineConfig::level_updates)
+        .def_readwrite("snapshot_interval", &lob::EngineConfig::snapshot_interval)
+        .def_readwrite("order_updates", &lob::EngineConfig::order_updates);
+
+    py::class_<lob::EventStats>(m, "EventStats")
+        .def(py::init<>())
+        .def_readonly("emitted", &lob::EventStats::emitted)
+        .def_readonly("dropped", &lob::EventStats::dropped)
+        .def_readonly("spilled", &lob::EventStats::spilled)
+        .def_readonly("blocked", &lob::EventStats::blocked)
+        .def_readonly("spill_depth", &lob::EventStats::spill_depth);
+
+    py::class_<lob::EventHashConfig>(m, "EventHashConfig")
+        .def(py::init<>())
+        .def_readwrite("checkpoint_interval", &lob::EventHashConfig::checkpoint_interval)
+        .def_readwrite("include_timestamps", &lob::EventHashConfig::include_timestamps);
+
+    py::class_<lob::HashCheckpoint>(m, "HashCheckpoint")
+        .def(py::init<>())
+        .def_readonly("seq", &lob::HashCheckpoint::seq)
+        .def_readonly("hash", &lob::HashCheckpoint::hash)
+        .def("__eq__", &lob::HashCheckpoint::operator==);
 
     // TimeSource
     py::class_<lob::TimeSource, std::shared_ptr<lob::TimeSource>>(m, "TimeSource")
@@ -168,15 +245,33 @@ PYBIND11_MODULE(lobsim, m) {
                     result.append(std::get<lob::ReplaceEvent>(event));
                 } else if (std::holds_alternative<lob::BookTop>(event)) {
                     result.append(std::get<lob::BookTop>(event));
+                } else if (std::holds_alternative<lob::LevelUpdate>(event)) {
+                    result.append(std::get<lob::LevelUpdate>(event));
                 }
             }
             return result;
         })
+        .def("poll_order_updates", [](lob::MatchingEngine& engine) {
+            std::vector<lob::OrderUpdate> updates;
+            (void)engine.poll_order_updates(updates);
+            return updates;
+        })
+        .def("emit_order_snapshot", &lob::MatchingEngine::emit_order_snapshot)
         .def("best_bid_ask", [](const lob::MatchingEngine& engine) {
             lob::BookTop top;
             engine.best_bid_ask(top);
             return top;
         })
+        .def("snapshot_top", [](const lob::MatchingEngine& engine) {
+            lob::BookTop top;
+            engine.snapshot_top(top);
+            return top;
+        })
+        .def("event_stats", &lob::MatchingEngine::event_stats)
+        .def("enable_event_hash", &lob::MatchingEngine::enable_event_hash,
+             py::arg("config") = lob::EventHashConfig())
+        .def("event_hash", &lob::MatchingEngine::event_hash)
+        .def("hash_checkpoints", &lob::MatchingEngine::hash_checkpoints, py::arg("from_seq") = 0)
         .def("now", &lob::MatchingEngine::now)
         .def("config", &lob::MatchingEngine::config);
 
@@ -192,11 +287,28 @@ PYBIND11_MODULE(lobsim, m) {
         .def_readwrite("new_price", &lob::MDOrder::new_price)
         .def_readwrite("new_qty", &lob::MDOrder::new_qty);
 
+    py::class_<lob::MDLoadStats>(m, "MDLoadStats")
+        .def(py::init<>())
+        .def_readonly("bytes", &lob::MDLoadStats::bytes)
+        .def_readonly("lines", &lob::MDLoadStats::lines)
+        .def_readonly("loaded", &lob::MDLoadStats::loaded)
+        .def_readonly("bad_rows", &lob::MDLoadStats::bad_rows)
+        .def_readonly("first_bad_line", &lob::MDLoadStats::first_bad_line);
+
     py::class_<lob::MarketDataFeed>(m, "MarketDataFeed")
         .def(py::init<>())
         .def("load_orders", &lob::MarketDataFeed::load_orders)
         .def("load_quotes", &lob::MarketDataFeed::load_quotes)
         .def("load_trades", &lob::MarketDataFeed::load_trades)
+        .def("last_load_stats", &lob::MarketDataFeed::last_load_stats)
         .def_static("to_order", &lob::MarketDataFeed::to_order)
         .def_static("parse_order_type", &lob::MarketDataFeed::parse_order_type);
+
+    m.def("compress_file", [](const std::string& input, const std::string& output,
+                              size_t block_bytes, size_t threads) {
+              return lob::compress_file(input, output, block_bytes, threads);
+          },
+          py::arg("input"), py::arg("output"),
+          py::arg("block_bytes") = lob::DEFAULT_COMPRESSED_BLOCK, py::arg("threads") = 0,
+          "Write a block-compressed copy of a capture readable by the loaders");
 }
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "lob/MatchingEngine.h"
 #include "lob/TimeSource.h"
+#include <atomic>
+#include <thread>
 
 using namespace lob;
 
@@ -220,3 +222,170 @@ TEST_F(MatchingEngineTest, Determinism) {
     EXPECT_EQ(top.best_bid.to_double(0.01), 100.0);
     EXPECT_EQ(top.best_ask.to_double(0.01), 100.5);
 }
+
+// Event ring overflow handling
+class EventOverflowTest : public ::testing::Test {
+protected:
+    std::unique_ptr<MatchingEngine> make_engine(OverflowPolicy policy) {
+        // Ring of 8 slots holds 7 events
+        EngineConfig config(1000, 8, 0.01, policy);
+        time_source = std::make_shared<SimulatedTimeSource>(1000000);
+        return std::make_unique<MatchingEngine>(config, time_source);
+    }
+
+    // Each resting limit order emits an accept and a book update
+    void submit_resting(MatchingEngine& engine, int count) {
+        for (int i = 0; i < count; i++) {
+            Order order(i + 1, Side::Buy, Price::from_double(100.0 - i * 0.01, 0.01),
+                        10, 1000000 + i, OrderType::Limit);
+            EXPECT_TRUE(engine.submit(order));
+        }
+    }
+
+    std::shared_ptr<SimulatedTimeSource> time_source;
+};
+
+TEST_F(EventOverflowTest, DropCountsLossAndLeavesSequenceGap) {
+    auto engine = make_engine(OverflowPolicy::Drop);
+    submit_resting(*engine, 10);
+    
+    EventStats stats = engine->event_stats();
+    EXPECT_EQ(stats.emitted, 20);
+    EXPECT_EQ(stats.dropped, 13);
+    
+    std::vector<SequencedEvent> events;
+    EXPECT_TRUE(engine->poll_sequenced(events));
+    ASSERT_EQ(events.size(), 7);
+    for (size_t i = 0; i < events.size(); i++) {
+        EXPECT_EQ(events[i].seq, i + 1);
+    }
+    
+    // After draining, the next event reveals the gap
+    Order order(100, Side::Sell, Price::from_double(101.0, 0.01), 10, 1000100, OrderType::Limit);
+    EXPECT_TRUE(engine->submit(order));
+    EXPECT_TRUE(engine->poll_sequenced(events));
+    ASSERT_FALSE(events.empty());
+    EXPECT_EQ(events.front().seq, 21);
+}
+
+TEST_F(EventOverflowTest, SpillPreservesEveryEventInOrder) {
+    auto engine = make_engine(OverflowPolicy::Spill);
+    submit_resting(*engine, 10);
+    
+    EventStats stats = engine->event_stats();
+    EXPECT_EQ(stats.dropped, 0);
+    EXPECT_EQ(stats.spilled, 13);
+    EXPECT_EQ(stats.spill_depth, 13);
+    
+    std::vector<SequencedEvent> events;
+    EXPECT_TRUE(engine->poll_sequenced(events));
+    ASSERT_EQ(events.size(), 20);
+    for (size_t i = 0; i < events.size(); i++) {
+        EXPECT_EQ(events[i].seq, i + 1);
+    }
+    EXPECT_TRUE(std::holds_alternative<AcceptEvent>(events[14].event));
+    EXPECT_EQ(std::get<AcceptEvent>(events[14].event).id, 8);
+    EXPECT_EQ(engine->event_stats().spill_depth, 0);
+    
+    // Ring is used again once the overflow segment has been drained
+    Order order(100, Side::Sell, Price::from_double(101.0, 0.01), 10, 1000100, OrderType::Limit);
+    EXPECT_TRUE(engine->submit(order));
+    EXPECT_EQ(engine->event_stats().spilled, 13);
+}
+
+TEST_F(EventOverflowTest, BlockWaitsForConsumer) {
+    auto engine = make_engine(OverflowPolicy::Block);
+    
+    std::atomic<bool> done{false};
+    std::vector<SequencedEvent> received;
+    std::thread consumer([&] {
+        std::vector<SequencedEvent> batch;
+        for (;;) {
+            bool finished = done.load();
+            if (engine->poll_sequenced(batch)) {
+                received.insert(received.end(), batch.begin(), batch.end());
+            } else if (finished) {
+                break;
+            }
+        }
+    });
+    
+    submit_resting(*engine, 50);
+    done.store(true);
+    consumer.join();
+    
+    ASSERT_EQ(received.size(), 100);
+    for (size_t i = 0; i < received.size(); i++) {
+        EXPECT_EQ(received[i].seq, i + 1);
+    }
+    EXPECT_EQ(engine->event_stats().dropped, 0);
+}
+
+TEST_F(EventOverflowTest, SpillKeepsOrderWithConcurrentConsumer) {
+    auto engine = make_engine(OverflowPolicy::Spill);
+    
+    std::atomic<bool> done{false};
+    std::vector<SequencedEvent> received;
+    std::thread consumer([&] {
+        std::vector<SequencedEvent> batch;
+        for (;;) {
+            bool finished = done.load();
+            if (engine->poll_sequenced(batch)) {
+                received.insert(received.end(), batch.begin(), batch.end());
+            } else if (finished) {
+                break;
+            }
+        }
+    });
+    
+    // The tiny ring fills and empties constantly, so the producer keeps
+    // switching between it and the overflow segment under the consumer
+    submit_resting(*engine, 900);
+    done.store(true);
+    consumer.join();
+    
+    ASSERT_EQ(received.size(), 1800);
+    for (size_t i = 0; i < received.size(); i++) {
+        ASSERT_EQ(received[i].seq, i + 1);
+    }
+    EXPECT_EQ(engine->event_stats().dropped, 0);
+}
+
+// Consumer wait strategies
+class WaitStrategyTest : public ::testing::TestWithParam<WaitKind> {
+protected:
+    void SetUp() override {
+        EngineConfig config(1000, 1024, 0.01);
+        time_source = std::make_shared<SimulatedTimeSource>(1000000);
+        engine = std::make_unique<MatchingEngine>(config, time_source);
+        engine->set_wait_strategy(make_wait_strategy(GetParam()));
+    }
+
+    std::shared_ptr<SimulatedTimeSource> time_source;
+    std::unique_ptr<MatchingEngine> engine;
+};
+
+TEST_P(WaitStrategyTest, TimesOutWhenIdle) {
+    std::vector<EngineEvent> events;
+    EXPECT_FALSE(engine->wait_events(events, std::chrono::milliseconds(5)));
+    EXPECT_TRUE(events.empty());
+}
+
+TEST_P(WaitStrategyTest, WakesOnSubmitFromAnotherThread) {
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        Order order(1, Side::Buy, Price::from_double(100.0, 0.01), 10, 1000000, OrderType::Limit);
+        EXPECT_TRUE(engine->submit(order));
+    });
+    
+    std::vector<EngineEvent> events;
+    EXPECT_TRUE(engine->wait_events(events, std::chrono::seconds(5)));
+    producer.join();
+    
+    ASSERT_FALSE(events.empty());
+    EXPECT_TRUE(std::holds_alternative<AcceptEvent>(events[0]));
+}
+
+INSTANTIATE_TEST_SUITE_P(AllKinds, WaitStrategyTest,
+                         ::testing::Values(WaitKind::BusySpin, WaitKind::SpinYield,
+                                           WaitKind::Blocking, WaitKind::Backoff));
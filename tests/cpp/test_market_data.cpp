@@ -0,0 +1,988 @@
+#include <gtest/gtest.h>
+#include "lob/MarketDataFeed.h"
+#include "lob/CsvScanner.h"
+#include "lob/MappedFile.h"
+#include "lob/MarketDataReplay.h"
+#include "lob/ParallelReplay.h"
+#include "lob/StreamingReplay.h"
+#include "lob/BlockCompression.h"
+#include "lob/BlockReader.h"
+#include "lob/ItchDecoder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <unordered_map>
+
+using namespace lob;
+
+// Scratch file named after the running test, so tests can run as parallel
+// processes (ctest -j) without rewriting a file another test has mapped
+static std::string temp_path(const std::string& suffix) {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = std::string(info->test_suite_name()) + "_" + info->name();
+    std::replace(name.begin(), name.end(), '/', '_');
+    return "/tmp/lob_" + name + suffix;
+}
+
+// Test fixture for CSV market data loading
+class MarketDataFeedTest : public ::testing::Test {
+protected:
+    void write_file(const std::string& contents) {
+        std::ofstream file(test_file, std::ios::binary);
+        file << contents;
+    }
+
+    void TearDown() override {
+        std::remove(test_file.c_str());
+    }
+
+    std::string test_file = temp_path(".csv");
+    MarketDataFeed feed;
+};
+
+TEST_F(MarketDataFeedTest, LoadOrders) {
+    write_file("ts_ns,order_id,side,px,qty,type,new_px,new_qty\n"
+               "1000,1,buy,100.25,10,limit\n"
+               "1001, 2 ,SELL,100.50,20,ioc\r\n"
+               "\n"
+               "1002,3,Buy,100.00,5,replace,100.10,7\n");
+    
+    std::vector<MDOrder> orders;
+    ASSERT_TRUE(feed.load_orders(test_file, orders));
+    ASSERT_EQ(orders.size(), 3);
+    
+    EXPECT_EQ(orders[0].ts_ns, 1000);
+    EXPECT_EQ(orders[0].side, Side::Buy);
+    EXPECT_DOUBLE_EQ(orders[0].price, 100.25);
+    EXPECT_EQ(orders[0].type, "limit");
+    EXPECT_EQ(orders[0].new_qty, 0);
+    
+    EXPECT_EQ(orders[1].order_id, 2);
+    EXPECT_EQ(orders[1].side, Side::Sell);
+    EXPECT_EQ(orders[1].type, "ioc");
+    
+    EXPECT_DOUBLE_EQ(orders[2].new_price, 100.10);
+    EXPECT_EQ(orders[2].new_qty, 7);
+    
+    EXPECT_EQ(feed.last_load_stats().loaded, 3);
+    EXPECT_EQ(feed.last_load_stats().bad_rows, 0);
+}
+
+TEST_F(MarketDataFeedTest, BadRowsAreReportedNotThrown) {
+    write_file("ts_ns,order_id,side,px,qty,type\n"
+               "1000,1,buy,100.25,10,limit\n"
+               "abc,2,buy,100.25,10,limit\n"
+               "1002,3,buy,1x0.0,10,limit\n"
+               "1003,4,buy\n"
+               "1004,5,sell,101.00,10,limit");  // No trailing newline
+    
+    std::vector<MDOrder> orders;
+    ASSERT_TRUE(feed.load_orders(test_file, orders));
+    ASSERT_EQ(orders.size(), 2);
+    EXPECT_EQ(orders[1].order_id, 5);
+    
+    const MDLoadStats& stats = feed.last_load_stats();
+    EXPECT_EQ(stats.lines, 6);
+    EXPECT_EQ(stats.bad_rows, 3);
+    EXPECT_EQ(stats.first_bad_line, 3);
+}
+
+TEST_F(MarketDataFeedTest, LoadQuotesAndTrades) {
+    write_file("ts_ns,bid,ask,bid_qty,ask_qty\n"
+               "1000,99.99,100.01,300,400\n");
+    std::vector<MDQuote> quotes;
+    ASSERT_TRUE(feed.load_quotes(test_file, quotes));
+    ASSERT_EQ(quotes.size(), 1);
+    EXPECT_DOUBLE_EQ(quotes[0].ask, 100.01);
+    EXPECT_EQ(quotes[0].ask_qty, 400);
+    
+    write_file("ts_ns,price,qty\n"
+               "1000,100.00,25\n"
+               "1001,100.01,30\n");
+    std::vector<MDTrade> trades;
+    ASSERT_TRUE(feed.load_trades(test_file, trades));
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[1].qty, 30);
+}
+
+TEST_F(MarketDataFeedTest, MissingFile) {
+    std::vector<MDOrder> orders;
+    EXPECT_FALSE(feed.load_orders("/tmp/nonexistent_feed.csv", orders));
+}
+
+TEST(CsvParserTest, SplitAndConvert) {
+    std::string_view fields[MAX_CSV_FIELDS];
+    size_t count = split_csv_line(" a , b,,c ", fields);
+    ASSERT_EQ(count, 4);
+    EXPECT_EQ(fields[0], "a");
+    EXPECT_EQ(fields[2], "");
+    EXPECT_EQ(fields[3], "c");
+    
+    uint64_t u = 0;
+    EXPECT_TRUE(parse_uint("18446744073709551615", u));
+    EXPECT_EQ(u, UINT64_MAX);
+    EXPECT_FALSE(parse_uint("18446744073709551616", u));
+    EXPECT_FALSE(parse_uint("12a", u));
+    EXPECT_FALSE(parse_uint("", u));
+    
+    double d = 0;
+    EXPECT_TRUE(parse_double("100.0500", d));
+    EXPECT_DOUBLE_EQ(d, 100.05);
+    EXPECT_FALSE(parse_double("1.2.3", d));
+}
+
+TEST(MappedFileTest, MapsWholeFile) {
+    const std::string path = temp_path(".bin");
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "hello\nworld";
+    }
+    MappedFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(file.view(), "hello\nworld");
+    
+    MappedFile moved(std::move(file));
+    EXPECT_FALSE(file.is_open());
+    EXPECT_EQ(moved.size(), 11);
+    std::remove(path.c_str());
+    
+    EXPECT_FALSE(MappedFile().open("/tmp/nonexistent_mapped_file.bin"));
+}
+
+// Structural scanner kernels must agree with the scalar reference
+class CsvScannerTest : public ::testing::TestWithParam<ScanKernel> {};
+
+TEST_P(CsvScannerTest, MatchesScalarKernel) {
+    std::string data;
+    uint32_t state = 12345;
+    for (int i = 0; i < 1000; i++) {
+        state = state * 1103515245 + 12345;
+        char c = "abc,\n 0123456789.\t,"[(state >> 16) % 19];
+        data.push_back(c);
+    }
+    
+    for (size_t len : {0, 1, 63, 64, 65, 127, 500, 1000}) {
+        std::vector<uint32_t> expected(len + 1), actual(len + 1);
+        size_t n_expected = find_structurals(data.data(), len, expected.data(), ScanKernel::Scalar);
+        size_t n_actual = find_structurals(data.data(), len, actual.data(), GetParam());
+        ASSERT_EQ(n_actual, n_expected) << "len " << len;
+        for (size_t i = 0; i < n_expected; i++) {
+            EXPECT_EQ(actual[i], expected[i]);
+        }
+    }
+}
+
+TEST_P(CsvScannerTest, RowsSpanBlockBoundaries) {
+    // ~200KB so rows straddle the scanner's 64KB blocks
+    std::string data;
+    for (int i = 0; i < 10000; i++) {
+        data += std::to_string(1000 + i) + ", " + std::to_string(i) + ",buy,100.25,10,limit\n";
+    }
+    data += "last,row";
+    
+    size_t rows = 0;
+    bool ok = true;
+    for_each_csv_row(data.data(), data.size(),
+                     [&](const std::string_view* fields, size_t count, size_t line_no) {
+        ++rows;
+        if (line_no <= 10000) {
+            uint64_t id = 0;
+            ok &= count == 6 && parse_uint(fields[1], id) && id == line_no - 1;
+            ok &= fields[5] == "limit";
+        } else {
+            ok &= count == 2 && fields[1] == "row";
+        }
+    }, GetParam());
+    EXPECT_EQ(rows, 10001);
+    EXPECT_TRUE(ok);
+}
+
+INSTANTIATE_TEST_SUITE_P(Kernels, CsvScannerTest,
+                         ::testing::Values(ScanKernel::Scalar, ScanKernel::SSE2, ScanKernel::AVX2));
+
+TEST(ParallelCsvTest, ChunksSplitOnNewlines) {
+    std::string data = "aaa\nbb\nc\ndddd\n";
+    auto chunks = split_at_newlines(data.data(), data.size(), 4);
+    ASSERT_FALSE(chunks.empty());
+    EXPECT_EQ(chunks.front().first, 0);
+    EXPECT_EQ(chunks.back().second, data.size());
+    for (size_t i = 0; i < chunks.size(); i++) {
+        EXPECT_EQ(data[chunks[i].second - 1], '\n');
+        if (i > 0) {
+            EXPECT_EQ(chunks[i].first, chunks[i - 1].second);
+        }
+    }
+}
+
+TEST_F(MarketDataFeedTest, ParallelLoadMatchesFileOrder) {
+    std::string contents = "ts_ns,order_id,side,px,qty,type\n";
+    for (int i = 0; i < 5000; i++) {
+        if (i == 1234) contents += "garbage\n";
+        contents += std::to_string(1000 + i) + "," + std::to_string(i + 1) +
+                    ",buy,100.25," + std::to_string(i % 50 + 1) + ",limit\n";
+    }
+    write_file(contents);
+    
+    CsvParseOptions options;
+    options.threads = 4;
+    options.min_chunk_bytes = 4096;  // Force many chunks on a small file
+    feed.set_parse_options(options);
+    
+    std::vector<MDOrder> orders;
+    ASSERT_TRUE(feed.load_orders(test_file, orders));
+    ASSERT_EQ(orders.size(), 5000);
+    for (size_t i = 0; i < orders.size(); i++) {
+        ASSERT_EQ(orders[i].order_id, i + 1);
+    }
+    
+    const MDLoadStats& stats = feed.last_load_stats();
+    EXPECT_EQ(stats.lines, 5002);
+    EXPECT_EQ(stats.bad_rows, 1);
+    EXPECT_EQ(stats.first_bad_line, 1236);
+}
+
+TEST_F(MarketDataFeedTest, ParallelReplayLoadKeepsOrder) {
+    std::string contents = "timestamp,action,order_id,side,price,qty,order_type\n";
+    for (int i = 0; i < 3000; i++) {
+        contents += std::to_string(1000000 + i) + ",ADD," + std::to_string(i + 1) +
+                    (i % 2 ? ",SELL,101.00,10,LIMIT\n" : ",BUY,99.00,10,LIMIT\n");
+    }
+    write_file(contents);
+    
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine engine(EngineConfig(100000, 10000, 0.01), time_source);
+    MarketDataReplay replay(engine);
+    
+    CsvParseOptions options;
+    options.threads = 3;
+    options.min_chunk_bytes = 2048;
+    ASSERT_TRUE(replay.load_from_csv(test_file, 0.01, options));
+    EXPECT_EQ(replay.message_count(), 3000);
+    EXPECT_EQ(replay.replay_all(), 3000);
+    EXPECT_EQ(engine.book().total_orders(), 3000);
+}
+
+TEST(DecimalPriceTest, TickScaleFromTextAndDouble) {
+    TickScale scale;
+    ASSERT_TRUE(TickScale::parse("0.01", scale));
+    EXPECT_EQ(scale.units, 1);
+    EXPECT_EQ(scale.decimals, 2);
+    ASSERT_TRUE(TickScale::parse("0.0025", scale));
+    EXPECT_EQ(scale.units, 25);
+    EXPECT_EQ(scale.decimals, 4);
+    ASSERT_TRUE(TickScale::parse("0.050", scale));
+    EXPECT_EQ(scale.units, 5);
+    EXPECT_EQ(scale.decimals, 2);
+    EXPECT_FALSE(TickScale::parse("0", scale));
+    EXPECT_FALSE(TickScale::parse("abc", scale));
+    
+    TickScale from_double = TickScale::from_double(0.01);
+    EXPECT_EQ(from_double.units, 1);
+    EXPECT_EQ(from_double.decimals, 2);
+    from_double = TickScale::from_double(0.0025);
+    EXPECT_EQ(from_double.units, 25);
+    EXPECT_EQ(from_double.decimals, 4);
+    
+    EXPECT_EQ(TickScale(10, 3), TickScale(1, 2));
+    EXPECT_FALSE(TickScale(5, 2) == TickScale(1, 2));
+}
+
+TEST(DecimalPriceTest, ParsesStraightToTicks) {
+    TickScale cents(1, 2);
+    int64_t ticks = 0;
+    ASSERT_TRUE(parse_price_ticks("100.0500", cents, ticks));
+    EXPECT_EQ(ticks, 10005);
+    ASSERT_TRUE(parse_price_ticks("100", cents, ticks));
+    EXPECT_EQ(ticks, 10000);
+    ASSERT_TRUE(parse_price_ticks(".5", cents, ticks));
+    EXPECT_EQ(ticks, 50);
+    ASSERT_TRUE(parse_price_ticks("-1.25", cents, ticks));
+    EXPECT_EQ(ticks, -125);
+    
+    // Exact half rounds up; the double path gets this one wrong
+    ASSERT_TRUE(parse_price_ticks("1.015", cents, ticks));
+    EXPECT_EQ(ticks, 102);
+    EXPECT_EQ(Price::from_double(1.015, 0.01).ticks, 101);
+    
+    // Non-unit ticks round to the nearest tick
+    TickScale nickels(5, 2);
+    ASSERT_TRUE(parse_price_ticks("100.07", nickels, ticks));
+    EXPECT_EQ(ticks, 2001);
+    ASSERT_TRUE(parse_price_ticks("100.08", nickels, ticks));
+    EXPECT_EQ(ticks, 2002);
+    
+    // Digits beyond the scale are rounded together with the tick, not first
+    // to the scale: 1.006 is 50.3 two-cent ticks, 1.0099 is 50.495
+    TickScale two_cents(2, 2);
+    ASSERT_TRUE(parse_price_ticks("1.006", two_cents, ticks));
+    EXPECT_EQ(ticks, 50);
+    ASSERT_TRUE(parse_price_ticks("1.0051", two_cents, ticks));
+    EXPECT_EQ(ticks, 50);
+    ASSERT_TRUE(parse_price_ticks("1.0099", two_cents, ticks));
+    EXPECT_EQ(ticks, 50);
+    ASSERT_TRUE(parse_price_ticks("-1.006", two_cents, ticks));
+    EXPECT_EQ(ticks, -50);
+    ASSERT_TRUE(parse_price_ticks("1.01", two_cents, ticks));
+    EXPECT_EQ(ticks, 51);
+    ASSERT_TRUE(parse_price_ticks("1.0249", nickels, ticks));
+    EXPECT_EQ(ticks, 20);
+    ASSERT_TRUE(parse_price_ticks("1.025", nickels, ticks));
+    EXPECT_EQ(ticks, 21);
+    ASSERT_TRUE(parse_price_ticks("1.0199", cents, ticks));
+    EXPECT_EQ(ticks, 102);
+    
+    EXPECT_FALSE(parse_price_ticks("", cents, ticks));
+    EXPECT_FALSE(parse_price_ticks(".", cents, ticks));
+    EXPECT_FALSE(parse_price_ticks("1.2.3", cents, ticks));
+    EXPECT_FALSE(parse_price_ticks("1e5", cents, ticks));
+    EXPECT_FALSE(parse_price_ticks("99999999999999999999", cents, ticks));
+}
+
+TEST(DecimalPriceTest, RejectsIntegerPartsThatWouldWrap) {
+    // 2^64 + 1: a wrapping multiply leaves 1, which passes a later limit check
+    TickScale units(1, 0);
+    int64_t ticks = 0;
+    EXPECT_FALSE(parse_price_ticks("18446744073709551617", units, ticks));
+    EXPECT_FALSE(parse_price_ticks("18446744073709551617", TickScale(1, 2), ticks));
+    EXPECT_FALSE(parse_price_ticks("9223372036854775808", units, ticks));
+    ASSERT_TRUE(parse_price_ticks("9223372036854775807", units, ticks));
+    EXPECT_EQ(ticks, INT64_MAX);
+    
+    TickScale scale;
+    EXPECT_FALSE(TickScale::parse("18446744073709551617", scale));
+}
+
+TEST(DecimalPriceTest, ConvertsWholeColumns) {
+    std::string_view column[] = {"100.00", "100.01", "bad", "99.99"};
+    Price out[4];
+    EXPECT_EQ(parse_price_column(column, 4, TickScale(1, 2), out), 1);
+    EXPECT_EQ(out[0].ticks, 10000);
+    EXPECT_EQ(out[1].ticks, 10001);
+    EXPECT_EQ(out[2], INVALID_PRICE);
+    EXPECT_EQ(out[3].ticks, 9999);
+}
+
+TEST_F(MarketDataFeedTest, CaptureRoundTripMatchesCsvReplay) {
+    std::string contents = "timestamp,action,order_id,side,price,qty,order_type\n";
+    for (int i = 0; i < 500; i++) {
+        contents += std::to_string(1000000 + i) + ",ADD," + std::to_string(i + 1) +
+                    (i % 2 ? ",SELL,100.05,10,LIMIT\n" : ",BUY,100.05,7,LIMIT\n");
+    }
+    contents += "1000600,CANCEL,2,SELL,0,0,LIMIT\n";
+    contents += "1000601,REPLACE,4,SELL,100.10,5,LIMIT\n";
+    contents += "1000602,BOGUS,not_a_number\n";
+    write_file(contents);
+    
+    const std::string capture_file = temp_path(".bin");
+    CaptureConvertStats stats;
+    ASSERT_TRUE(convert_csv_to_capture(test_file, capture_file, TickScale(1, 2), "XYZ", &stats));
+    EXPECT_EQ(stats.rows, 502);
+    EXPECT_EQ(stats.bad_rows, 1);
+    EXPECT_EQ(stats.symbols, 1);
+    
+    CaptureReader capture;
+    ASSERT_TRUE(capture.open(capture_file));
+    ASSERT_EQ(capture.size(), 502);
+    ASSERT_EQ(capture.symbols().size(), 1);
+    EXPECT_EQ(capture.symbols()[0], "XYZ");
+    EXPECT_EQ(capture.tick_scale().units, 1);
+    EXPECT_EQ(capture.tick_scale().decimals, 2);
+    EXPECT_EQ(capture.records()[0].price, 10005);
+    EXPECT_EQ(capture.records()[501].action, MDAction::Replace);
+    
+    auto csv_time = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine csv_engine(EngineConfig(100000, 10000, 0.01), csv_time);
+    MarketDataReplay csv_replay(csv_engine);
+    ASSERT_TRUE(csv_replay.load_from_csv(test_file, 0.01));
+    std::vector<EngineEvent> csv_events;
+    size_t csv_processed = csv_replay.replay_all(&csv_events);
+    
+    auto bin_time = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine bin_engine(EngineConfig(100000, 10000, 0.01), bin_time);
+    MarketDataReplay bin_replay(bin_engine);
+    std::vector<EngineEvent> bin_events;
+    EXPECT_EQ(bin_replay.replay_capture(capture, &bin_events), csv_processed);
+    EXPECT_EQ(bin_events.size(), csv_events.size());
+    EXPECT_EQ(bin_engine.book().total_orders(), csv_engine.book().total_orders());
+    BookTop csv_top, bin_top;
+    ASSERT_TRUE(csv_engine.book().best_bid_ask(csv_top));
+    ASSERT_TRUE(bin_engine.book().best_bid_ask(bin_top));
+    EXPECT_EQ(bin_top.best_bid, csv_top.best_bid);
+    EXPECT_EQ(bin_top.bid_qty, csv_top.bid_qty);
+    EXPECT_EQ(bin_top.best_ask, csv_top.best_ask);
+    EXPECT_EQ(bin_top.ask_qty, csv_top.ask_qty);
+    
+    EXPECT_EQ(bin_replay.replay_capture(capture, nullptr, "MISSING"), 0);
+    std::remove(capture_file.c_str());
+}
+
+TEST_F(MarketDataFeedTest, CaptureKeepsSymbolTable) {
+    write_file("timestamp,symbol,action,order_id,side,price,qty,order_type\n"
+               "1000,AAPL,ADD,1,BUY,150.00,100,LIMIT\n"
+               "1001,MSFT,ADD,2,SELL,300.25,50,LIMIT\n"
+               "1002,AAPL,ADD,3,SELL,150.50,100,LIMIT\n");
+    
+    const std::string capture_file = temp_path(".bin");
+    ASSERT_TRUE(convert_csv_to_capture(test_file, capture_file, TickScale(1, 2)));
+    
+    CaptureReader capture;
+    ASSERT_TRUE(capture.open(capture_file));
+    ASSERT_EQ(capture.symbols().size(), 2);
+    EXPECT_EQ(capture.symbols()[capture.records()[1].symbol], "MSFT");
+    EXPECT_EQ(capture.records()[2].symbol, capture.records()[0].symbol);
+    
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000);
+    MatchingEngine engine(EngineConfig(1000, 1000, 0.01), time_source);
+    MarketDataReplay replay(engine);
+    EXPECT_EQ(replay.replay_capture(capture, nullptr, "AAPL"), 2);
+    EXPECT_EQ(engine.book().total_orders(), 2);
+    
+    MultiSymbolEngine multi(EngineConfig(1000, 1000, 0.01), time_source);
+    ParallelReplay parallel(multi, 2);
+    ASSERT_TRUE(parallel.load_from_capture(capture));
+    EXPECT_EQ(parallel.symbol_count(), 2);
+    EXPECT_EQ(parallel.replay_all(), 3);
+    
+    // A truncated file is rejected rather than read past its end
+    write_file(std::string(40, 'x'));
+    EXPECT_FALSE(capture.open(test_file));
+    std::remove(capture_file.c_str());
+}
+
+TEST_F(MarketDataFeedTest, CaptureAtAnotherTickSizeIsRefused) {
+    write_file("timestamp,symbol,action,order_id,side,price,qty,order_type\n"
+               "1000,AAPL,ADD,1,BUY,150.05,100,LIMIT\n"
+               "1001,MSFT,ADD,2,SELL,300.25,50,LIMIT\n");
+    
+    // Nickel ticks: 150.05 is stored as 3001, which would be 30.01 in cents
+    const std::string capture_file = temp_path(".bin");
+    ASSERT_TRUE(convert_csv_to_capture(test_file, capture_file, TickScale(5, 2)));
+    CaptureReader capture;
+    ASSERT_TRUE(capture.open(capture_file));
+    
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000);
+    MatchingEngine cents(EngineConfig(1000, 1000, 0.01), time_source);
+    MarketDataReplay cents_replay(cents);
+    EXPECT_EQ(cents_replay.replay_capture(capture), 0);
+    EXPECT_EQ(cents.book().total_orders(), 0);
+    
+    MatchingEngine nickels(EngineConfig(1000, 1000, 0.05), time_source);
+    MarketDataReplay nickels_replay(nickels);
+    EXPECT_EQ(nickels_replay.replay_capture(capture), 2);
+    
+    MultiSymbolEngine multi(EngineConfig(1000, 1000, 0.01), time_source);
+    ParallelReplay parallel(multi, 2);
+    EXPECT_FALSE(parallel.load_from_capture(capture));
+    EXPECT_EQ(parallel.replay_all(), 0);
+    
+    // A symbol with its own config must match too
+    MultiSymbolEngine mixed(EngineConfig(1000, 1000, 0.05), time_source);
+    EngineConfig cent_config(1000, 1000, 0.01);
+    ASSERT_TRUE(mixed.add_symbol("MSFT", &cent_config));
+    ParallelReplay mixed_replay(mixed, 2);
+    EXPECT_FALSE(mixed_replay.load_from_capture(capture));
+    
+    MultiSymbolEngine matching(EngineConfig(1000, 1000, 0.05), time_source);
+    ParallelReplay matching_replay(matching, 2);
+    ASSERT_TRUE(matching_replay.load_from_capture(capture));
+    EXPECT_EQ(matching_replay.replay_all(), 2);
+    std::remove(capture_file.c_str());
+}
+
+TEST_F(MarketDataFeedTest, StreamingReplayMatchesLoadedReplay) {
+    std::string contents = "timestamp,action,order_id,side,price,qty,order_type\n";
+    for (int i = 0; i < 2000; i++) {
+        contents += std::to_string(1000000 + i) + ",ADD," + std::to_string(i + 1) +
+                    (i % 3 ? ",SELL,101.00,10,LIMIT\n" : ",BUY,100.50,25,LIMIT\n");
+    }
+    contents += "1002000,oops\n";
+    contents += "1002001,CANCEL,2,SELL,0,0,LIMIT";  // No trailing newline
+    write_file(contents);
+    
+    auto loaded_time = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine loaded_engine(EngineConfig(100000, 10000, 0.01), loaded_time);
+    MarketDataReplay loaded(loaded_engine);
+    ASSERT_TRUE(loaded.load_from_csv(test_file, 0.01));
+    std::vector<EngineEvent> loaded_events;
+    size_t loaded_processed = loaded.replay_all(&loaded_events);
+    
+    // Blocks much smaller than the file force many handoffs and split lines
+    auto streamed_time = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine streamed_engine(EngineConfig(100000, 10000, 0.01), streamed_time);
+    MarketDataReplay streamed(streamed_engine);
+    auto source = std::make_unique<CsvStreamSource>();
+    ASSERT_TRUE(source->open(test_file, 0.01, 1000));
+    CsvStreamSource* raw = source.get();
+    streamed.set_source(std::move(source));
+    
+    std::vector<EngineEvent> streamed_events;
+    size_t streamed_processed = streamed.replay_until(1000999, &streamed_events);
+    EXPECT_EQ(streamed_processed, 1000);
+    streamed_processed += streamed.replay_all(&streamed_events);
+    
+    EXPECT_EQ(streamed_processed, loaded_processed);
+    EXPECT_EQ(streamed_events.size(), loaded_events.size());
+    EXPECT_EQ(streamed_engine.book().total_orders(), loaded_engine.book().total_orders());
+    EXPECT_EQ(raw->bad_rows(), 1);
+    EXPECT_EQ(raw->buffer_capacity(), 1000);
+    EXPECT_EQ(streamed.replay_all(), 0);
+    EXPECT_FALSE(raw->failed());
+    EXPECT_FALSE(streamed.stream_failed());
+}
+
+TEST_F(MarketDataFeedTest, StreamingSourceGrowsForLongLines) {
+    write_file("1,ADD,1,BUY,100.00,5,LIMIT" + std::string(300, ' ') + "\n"
+               "2,ADD,2,SELL,101.00,5,LIMIT\n");
+    
+    CsvStreamSource source;
+    ASSERT_TRUE(source.open(test_file, 0.01, 64));
+    std::vector<MarketDataMessage> batch;
+    size_t total = 0;
+    while (source.next_batch(batch)) {
+        total += batch.size();
+    }
+    EXPECT_EQ(total, 2);
+    EXPECT_GT(source.buffer_capacity(), 300);
+    
+    // Closing mid-stream must not hang the reader
+    ASSERT_TRUE(source.open(test_file, 0.01, 16));
+    source.close();
+}
+
+// Builds length-prefixed ITCH 5.0 messages for decoder tests
+class ItchWriter {
+public:
+    void stock_directory(uint16_t locate, const std::string& stock) {
+        begin('R', locate, 0);
+        put_stock(stock);
+        buf_.append(itch::STOCK_DIRECTORY_LEN - 19, '\0');
+        end();
+    }
+
+    void add(uint16_t locate, uint64_t ts, uint64_t ref, char side, uint32_t shares,
+             const std::string& stock, uint32_t price) {
+        begin('A', locate, ts);
+        put(ref, 8);
+        buf_ += side;
+        put(shares, 4);
+        put_stock(stock);
+        put(price, 4);
+        end();
+    }
+
+    void executed(uint16_t locate, uint64_t ts, uint64_t ref, uint32_t shares) {
+        begin('E', locate, ts);
+        put(ref, 8);
+        put(shares, 4);
+        put(0, 8);
+        end();
+    }
+
+    void cancel(uint16_t locate, uint64_t ts, uint64_t ref, uint32_t shares) {
+        begin('X', locate, ts);
+        put(ref, 8);
+        put(shares, 4);
+        end();
+    }
+
+    void remove(uint16_t locate, uint64_t ts, uint64_t ref) {
+        begin('D', locate, ts);
+        put(ref, 8);
+        end();
+    }
+
+    void replace(uint16_t locate, uint64_t ts, uint64_t ref, uint64_t new_ref,
+                 uint32_t shares, uint32_t price) {
+        begin('U', locate, ts);
+        put(ref, 8);
+        put(new_ref, 8);
+        put(shares, 4);
+        put(price, 4);
+        end();
+    }
+
+    void system_event(uint64_t ts) {
+        begin('S', 0, ts);
+        buf_ += 'O';
+        end();
+    }
+
+    const std::string& bytes() const { return buf_; }
+
+private:
+    void put(uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; --i) {
+            buf_ += static_cast<char>((value >> (8 * i)) & 0xFF);
+        }
+    }
+
+    void put_stock(const std::string& stock) {
+        std::string padded = stock;
+        padded.resize(8, ' ');
+        buf_ += padded;
+    }
+
+    void begin(char type, uint16_t locate, uint64_t ts) {
+        start_ = buf_.size();
+        buf_.append(2, '\0');
+        buf_ += type;
+        put(locate, 2);
+        put(0, 2);
+        put(ts, 6);
+    }
+
+    void end() {
+        size_t len = buf_.size() - start_ - 2;
+        buf_[start_] = static_cast<char>(len >> 8);
+        buf_[start_ + 1] = static_cast<char>(len & 0xFF);
+    }
+
+    std::string buf_;
+    size_t start_ = 0;
+};
+
+TEST(ItchDecoderTest, BigEndianLoads) {
+    const char bytes[] = {'\x01', '\x02', '\x03', '\x04', '\x05', '\x06', '\x07', '\x08'};
+    EXPECT_EQ(load_be16(bytes), 0x0102);
+    EXPECT_EQ(load_be32(bytes), 0x01020304u);
+    EXPECT_EQ(load_be48(bytes), 0x010203040506ull);
+    EXPECT_EQ(load_be64(bytes), 0x0102030405060708ull);
+}
+
+TEST(ItchDecoderTest, PricesAtAnyScale) {
+    MultiSymbolEngine multi(EngineConfig(16, 16, 0.01));
+    EXPECT_EQ(ItchDecoder(multi, TickScale(1, 2)).to_price(1500500), Price(15005));
+    EXPECT_EQ(ItchDecoder(multi, TickScale(5, 2)).to_price(1500250), Price(3001));
+    EXPECT_EQ(ItchDecoder(multi, TickScale(1, 0)).to_price(1505000), Price(151));
+    EXPECT_EQ(ItchDecoder(multi, TickScale(1, 12)).to_price(1500000), Price(150000000000000LL));
+    
+    // 150 at 18 decimals is more ticks than a Price holds
+    EXPECT_EQ(ItchDecoder(multi, TickScale(1, 18)).to_price(1500000), INVALID_PRICE);
+    EXPECT_EQ(ItchDecoder(multi, TickScale(1, 18)).to_price(0), Price(0));
+}
+
+TEST_F(MarketDataFeedTest, ItchDecoderBuildsBooks) {
+    ItchWriter w;
+    w.system_event(1);
+    w.stock_directory(7, "AAPL");
+    w.stock_directory(9, "MSFT");
+    w.add(7, 100, 1, 'B', 100, "AAPL", 1500000);   // 150.0000
+    w.add(7, 101, 2, 'S', 200, "AAPL", 1500500);   // 150.0500
+    w.add(9, 102, 3, 'B', 50, "MSFT", 3000000);
+    w.add(9, 103, 4, 'S', 70, "MSFT", 3001000);
+    w.executed(7, 104, 1, 40);                     // 60 left
+    w.cancel(7, 105, 2, 50);                       // 150 left
+    w.remove(9, 106, 3);
+    w.replace(9, 107, 4, 5, 80, 3000500);          // New ref 5 at 300.05
+    w.executed(9, 108, 99, 10);                    // Unknown order
+    write_file(w.bytes());
+    
+    MultiSymbolEngine multi(EngineConfig(10000, 4096, 0.01));
+    ItchDecoder decoder(multi, TickScale(1, 2));
+    ASSERT_TRUE(decoder.decode_file(test_file));
+    
+    const ItchStats& stats = decoder.stats();
+    EXPECT_EQ(stats.messages, 12);
+    EXPECT_EQ(stats.ignored, 1);
+    EXPECT_EQ(stats.directory, 2);
+    EXPECT_EQ(stats.adds, 4);
+    EXPECT_EQ(stats.executes, 2);
+    EXPECT_EQ(stats.unknown_orders, 1);
+    EXPECT_EQ(stats.rejected, 0);
+    EXPECT_EQ(stats.malformed, 0);
+    EXPECT_EQ(decoder.symbol(7), "AAPL");
+    EXPECT_EQ(decoder.symbol(9), "MSFT");
+    
+    BookTop top;
+    ASSERT_TRUE(multi.best_bid_ask("AAPL", top));
+    EXPECT_EQ(top.best_bid, Price(15000));
+    EXPECT_EQ(top.bid_qty, 60);
+    EXPECT_EQ(top.best_ask, Price(15005));
+    EXPECT_EQ(top.ask_qty, 150);
+    
+    ASSERT_TRUE(multi.best_bid_ask("MSFT", top));
+    EXPECT_EQ(top.best_bid, INVALID_PRICE);
+    EXPECT_EQ(top.best_ask, Price(30005));
+    EXPECT_EQ(top.ask_qty, 80);
+}
+
+TEST_F(MarketDataFeedTest, ItchDecoderCarriesPartialMessages) {
+    ItchWriter w;
+    w.add(3, 100, 1, 'S', 10, "IBM", 1234567);     // Rounds to 123.46
+    w.add(3, 101, 2, 'S', 10, "IBM", 1234000);
+    const std::string& bytes = w.bytes();
+    
+    MultiSymbolEngine multi(EngineConfig(1000, 1024, 0.01));
+    ItchDecoder decoder(multi, TickScale(1, 2));
+    size_t split = bytes.size() - 5;
+    size_t consumed = decoder.decode(bytes.data(), split);
+    EXPECT_EQ(consumed, bytes.size() / 2);
+    std::string rest = bytes.substr(consumed);
+    EXPECT_EQ(decoder.decode(rest.data(), rest.size()), rest.size());
+    
+    EXPECT_EQ(decoder.stats().adds, 2);
+    EXPECT_EQ(decoder.to_price(1234567), Price(12346));
+    BookTop top;
+    ASSERT_TRUE(multi.best_bid_ask("IBM", top));
+    EXPECT_EQ(top.best_ask, Price(12340));
+    
+    // A truncated file is decoded up to the cut and flagged
+    write_file(bytes.substr(0, split));
+    MultiSymbolEngine other(EngineConfig(1000, 1024, 0.01));
+    ItchDecoder truncated(other, TickScale(1, 2));
+    ASSERT_TRUE(truncated.decode_file(test_file));
+    EXPECT_EQ(truncated.stats().adds, 1);
+    EXPECT_EQ(truncated.stats().malformed, 1);
+}
+
+TEST(ItchDecoderTest, DrainsBooksItDrives) {
+    // Far more events than a 16-slot ring holds, across two books
+    ItchWriter w;
+    for (uint32_t i = 0; i < 400; ++i) {
+        const bool aapl = i % 2 == 0;
+        w.add(aapl ? 1 : 2, 100 + i, i + 1, i % 4 < 2 ? 'B' : 'S', 10,
+              aapl ? "AAPL" : "MSFT", i % 4 < 2 ? 1000000 - i * 100 : 2000000 + i * 100);
+    }
+    for (uint32_t i = 0; i < 400; i += 3) {
+        w.remove(i % 2 == 0 ? 1 : 2, 1000 + i, i + 1);
+    }
+    
+    std::unordered_map<SymbolId, uint64_t> last_seq;
+    size_t gaps = 0;
+    size_t events = 0;
+    auto sink = [&](const SymbolId& symbol, const SequencedEvent& event) {
+        if (event.seq != last_seq[symbol] + 1) {
+            ++gaps;
+        }
+        last_seq[symbol] = event.seq;
+        ++events;
+    };
+    
+    MultiSymbolEngine dropping(EngineConfig(1000, 16, 0.01, OverflowPolicy::Drop));
+    ItchDecoder decoder(dropping, TickScale(1, 2), sink);
+    EXPECT_EQ(decoder.decode(w.bytes().data(), w.bytes().size()), w.bytes().size());
+    EXPECT_EQ(decoder.stats().rejected, 0);
+    EXPECT_EQ(gaps, 0);
+    EXPECT_GT(events, 800);
+    for (const char* symbol : {"AAPL", "MSFT"}) {
+        const EventStats stats = dropping.get_engine(symbol)->event_stats();
+        EXPECT_EQ(stats.dropped, 0) << symbol;
+        EXPECT_EQ(stats.emitted, last_seq[symbol]) << symbol;
+    }
+    
+    // A blocking ring with no other consumer would otherwise never drain
+    MultiSymbolEngine blocking(EngineConfig(1000, 16, 0.01, OverflowPolicy::Block));
+    ItchDecoder no_sink(blocking, TickScale(1, 2));
+    EXPECT_EQ(no_sink.decode(w.bytes().data(), w.bytes().size()), w.bytes().size());
+    EXPECT_EQ(blocking.get_engine("AAPL")->book().total_orders(),
+              dropping.get_engine("AAPL")->book().total_orders());
+}
+
+class BlockReaderTest : public ::testing::TestWithParam<std::tuple<ReadBackend, bool>> {
+protected:
+    void TearDown() override {
+        std::remove(test_file.c_str());
+    }
+
+    std::string test_file = temp_path(".bin");
+};
+
+TEST_P(BlockReaderTest, ReadsWholeFileInOrder) {
+    auto [backend, direct] = GetParam();
+    
+    // Not a multiple of the block size, so the last block is short
+    std::string contents;
+    for (int i = 0; i < 50000; i++) {
+        contents += std::to_string(i * 7919) + (i % 11 ? "," : "\n");
+    }
+    {
+        std::ofstream file(test_file, std::ios::binary);
+        file << contents;
+    }
+    
+    BlockReaderOptions options;
+    options.block_bytes = 8192;
+    options.queue_depth = 3;
+    options.direct = direct;
+    options.backend = backend;
+    
+    BlockReader reader;
+    if (!reader.open(test_file, options)) {
+        ASSERT_EQ(backend, ReadBackend::IoUring);
+        GTEST_SKIP() << "io_uring unavailable";
+    }
+    if (backend == ReadBackend::Pread) {
+        EXPECT_EQ(reader.backend(), ReadBackend::Pread);
+    }
+    EXPECT_EQ(reader.file_size(), contents.size());
+    
+    std::string read_back;
+    const char* data;
+    size_t size;
+    size_t blocks = 0;
+    while (reader.next(data, size)) {
+        read_back.append(data, size);
+        ++blocks;
+    }
+    EXPECT_FALSE(reader.failed());
+    EXPECT_EQ(blocks, (contents.size() + reader.block_bytes() - 1) / reader.block_bytes());
+    EXPECT_TRUE(read_back == contents);
+    
+    // Streaming replay reads through the same backend
+    CsvStreamSource source;
+    ASSERT_TRUE(source.open(test_file, 0.01, options));
+    std::vector<MarketDataMessage> batch;
+    while (source.next_batch(batch)) {}
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, BlockReaderTest,
+    ::testing::Combine(::testing::Values(ReadBackend::Auto, ReadBackend::IoUring, ReadBackend::Pread),
+                       ::testing::Bool()));
+
+TEST(BlockCompressionTest, RoundTripsAssortedInputs) {
+    std::mt19937 rng(7);
+    std::string random(10000, '\0');
+    for (auto& c : random) c = static_cast<char>(rng());
+    std::string text;
+    for (int i = 0; i < 2000; i++) {
+        text += std::to_string(1000000 + i * 37) + ",ADD," + std::to_string(i) + ",BUY,100.25,10,LIMIT\n";
+    }
+    
+    for (const std::string& input : {std::string(), std::string("abc"), std::string(70000, 'x'),
+                                     std::string("abcabcabcabcabcab"), random, text}) {
+        std::vector<char> coded(block_compress_bound(input.size()));
+        size_t n = block_compress(input.data(), input.size(), coded.data());
+        ASSERT_LE(n, coded.size());
+        
+        std::string decoded(input.size(), '\0');
+        ASSERT_TRUE(block_decompress(coded.data(), n, decoded.data(), decoded.size())) << input.size();
+        EXPECT_TRUE(decoded == input) << input.size();
+        
+        // Truncated or mis-sized input is rejected, not overrun
+        if (!input.empty()) {
+            EXPECT_FALSE(block_decompress(coded.data(), n / 2, decoded.data(), decoded.size()));
+        }
+        std::string bigger(input.size() + 1, '\0');
+        EXPECT_FALSE(block_decompress(coded.data(), n, bigger.data(), bigger.size()));
+    }
+    
+    std::vector<char> coded(block_compress_bound(text.size()));
+    EXPECT_LT(block_compress(text.data(), text.size(), coded.data()), text.size() / 3);
+}
+
+// Hand-built container with stored (uncompressed) blocks of the given sizes
+static std::string build_container(uint32_t block_bytes, const std::vector<uint32_t>& sizes) {
+    CompressedHeader header{};
+    std::memcpy(header.magic, "LOBZBLK1", sizeof(header.magic));
+    header.version = COMPRESSED_VERSION;
+    header.block_bytes = block_bytes;
+    header.block_count = sizes.size();
+    
+    std::string payload;
+    std::vector<CompressedBlock> index;
+    for (uint32_t size : sizes) {
+        index.push_back({sizeof(header) + payload.size(), size, size});
+        payload.append(size, static_cast<char>('a' + index.size()));
+        header.raw_size += size;
+    }
+    payload.resize((payload.size() + 7) & ~size_t(7));
+    header.index_offset = sizeof(header) + payload.size();
+    
+    std::string out(reinterpret_cast<const char*>(&header), sizeof(header));
+    out += payload;
+    out.append(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(CompressedBlock));
+    return out;
+}
+
+TEST_F(MarketDataFeedTest, CompressedIndexMustTileTheOutput) {
+    write_file(build_container(10, {10, 9}));
+    {
+        CompressedFile container;
+        DecodedFile decoded;
+        ASSERT_TRUE(container.open(test_file));
+        ASSERT_TRUE(decoded.open(test_file, 2));
+        EXPECT_EQ(decoded.view(), std::string(10, 'b') + std::string(9, 'c'));
+    }
+    
+    // Same total, but a short block before the last would place the last
+    // one past the end of the output
+    write_file(build_container(10, {9, 10}));
+    CompressedFile container;
+    DecodedFile decoded;
+    EXPECT_FALSE(container.open(test_file));
+    EXPECT_FALSE(decoded.open(test_file, 2));
+}
+
+TEST_F(MarketDataFeedTest, LoadersReadCompressedCaptures) {
+    std::string contents = "timestamp,action,order_id,side,price,qty,order_type\n";
+    for (int i = 0; i < 3000; i++) {
+        contents += std::to_string(1000000 + i) + ",ADD," + std::to_string(i + 1) +
+                    (i % 2 ? ",SELL,101.00,10,LIMIT\n" : ",BUY,99.00,10,LIMIT\n");
+    }
+    write_file(contents);
+    
+    const std::string packed = test_file + ".lobz";
+    CompressStats stats;
+    ASSERT_TRUE(compress_file(test_file, packed, 4096, 2, &stats));
+    EXPECT_EQ(stats.raw_bytes, contents.size());
+    EXPECT_EQ(stats.blocks, (contents.size() + 4095) / 4096);
+    EXPECT_LT(stats.stored_bytes * 3, stats.raw_bytes);
+    
+    DecodedFile decoded;
+    ASSERT_TRUE(decoded.open(packed, 2));
+    EXPECT_TRUE(decoded.compressed());
+    EXPECT_TRUE(decoded.view() == contents);
+    
+    CompressedFile container;
+    ASSERT_TRUE(container.open(packed));
+    std::string block(container.block(1).raw_size, '\0');
+    ASSERT_TRUE(container.decode_block(1, block.data()));
+    EXPECT_TRUE(block == contents.substr(4096, 4096));
+    
+    // Whole-file and streaming replay both accept the container
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine engine(EngineConfig(100000, 10000, 0.01), time_source);
+    MarketDataReplay replay(engine);
+    ASSERT_TRUE(replay.load_from_csv(packed, 0.01));
+    EXPECT_EQ(replay.message_count(), 3000);
+    
+    MatchingEngine streamed_engine(EngineConfig(100000, 10000, 0.01), time_source);
+    MarketDataReplay streamed(streamed_engine);
+    auto source = std::make_unique<CsvStreamSource>();
+    ASSERT_TRUE(source->open(packed, 0.01));
+    streamed.set_source(std::move(source));
+    EXPECT_EQ(streamed.replay_all(), 3000);
+    EXPECT_EQ(streamed_engine.book().total_orders(), 3000);
+    EXPECT_FALSE(streamed.stream_failed());
+    
+    std::string bad;
+    {
+        std::ifstream in(packed, std::ios::binary);
+        bad.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    
+    // A block that fails to decode mid-stream stops the replay as an error,
+    // not as a clean end of file
+    std::string damaged = bad;
+    const CompressedBlock& victim = container.block(container.block_count() / 2);
+    std::fill_n(damaged.begin() + static_cast<std::ptrdiff_t>(victim.offset), victim.stored_size, '\xff');
+    write_file(damaged);
+    MatchingEngine cut_engine(EngineConfig(100000, 10000, 0.01), time_source);
+    MarketDataReplay cut(cut_engine);
+    auto cut_source = std::make_unique<CsvStreamSource>();
+    ASSERT_TRUE(cut_source->open(test_file, 0.01));
+    CsvStreamSource* cut_raw = cut_source.get();
+    cut.set_source(std::move(cut_source));
+    EXPECT_LT(cut.replay_all(), 3000);
+    EXPECT_TRUE(cut_raw->failed());
+    EXPECT_TRUE(cut.stream_failed());
+    
+    // A corrupt index is refused
+    bad.resize(bad.size() - 8);
+    write_file(bad);
+    EXPECT_FALSE(container.open(test_file));
+    std::remove(packed.c_str());
+}
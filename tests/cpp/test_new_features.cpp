@@ -3,11 +3,57 @@
 #include "lob/MatchingEngine.h"
 #include "lob/MultiSymbolEngine.h"
 #include "lob/MarketDataReplay.h"
+#include "lob/ParallelReplay.h"
+#include "lob/Journal.h"
+#include "lob/L2Book.h"
+#include "lob/L3Book.h"
+#include "lob/MpscRing.h"
+#include "lob/Replication.h"
+#include "lob/SharedEventRing.h"
 #include "lob/TimeSource.h"
+#include "lob/WebSocketFeed.h"
+#include "lob/WebSocketServer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
 #include <fstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <linux/mempolicy.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
 
 using namespace lob;
 
+// Scratch file named after the running test, so tests can run as parallel
+// processes (ctest -j) without rewriting a file another test has mapped
+static std::string temp_path(const std::string& suffix) {
+    const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::string name = std::string(info->test_suite_name()) + "_" + info->name();
+    std::replace(name.begin(), name.end(), '/', '_');
+    return "/tmp/lob_" + name + suffix;
+}
+
+// Shared memory and socket names are global too; tag them with the pid
+static std::string ipc_name(const std::string& base) {
+#if defined(__unix__) || defined(__APPLE__)
+    return base + "_" + std::to_string(::getpid());
+#else
+    return base;
+#endif
+}
+
 // Test fixture for depth snapshot functionality
 class DepthSnapshotTest : public ::testing::Test {
 protected:
@@ -264,7 +310,7 @@ protected:
         replay = std::make_unique<MarketDataReplay>(*engine);
         
         // Create temporary CSV file
-        test_file = "/tmp/test_market_data.csv";
+        test_file = temp_path(".csv");
         std::ofstream file(test_file);
         file << "timestamp,action,order_id,side,price,qty,order_type\n";
         file << "1000000,ADD,1,BUY,100.00,50,LIMIT\n";
@@ -324,6 +370,1789 @@ TEST_F(MarketDataReplayTest, ClearMessages) {
     EXPECT_EQ(replay->message_count(), 0);
 }
 
+TEST_F(MarketDataReplayTest, ReplayUntilResumesFromCursor) {
+    replay->load_from_csv(test_file, 0.01);
+    
+    EXPECT_EQ(replay->replay_until(1000500), 1);
+    EXPECT_EQ(replay->replay_until(1001500), 1);
+    EXPECT_EQ(replay->position(), 2);
+    EXPECT_EQ(engine->book().total_orders(), 2);
+    EXPECT_EQ(replay->replay_all(), 1);
+    EXPECT_EQ(engine->book().total_orders(), 1);
+}
+
+TEST_F(MarketDataReplayTest, SeekRestoresNearestCheckpoint) {
+    {
+        std::ofstream file(test_file);
+        file << "timestamp,action,order_id,side,price,qty,order_type\n";
+        for (int i = 0; i < 1000; i++) {
+            uint64_t ts = 1000000 + i * 10;
+            if (i % 5 == 4) {
+                file << ts << ",CANCEL," << i - 2 << ",BUY,0,0,LIMIT\n";
+            } else {
+                file << ts << ",ADD," << i + 1 << (i % 2 ? ",SELL," : ",BUY,")
+                     << (i % 2 ? 100.50 + (i % 7) * 0.01 : 99.50 - (i % 7) * 0.01)
+                     << "," << 10 + i % 3 << ",LIMIT\n";
+            }
+        }
+    }
+    
+    auto book_at = [&](uint64_t ts) {
+        MatchingEngine fresh(config, time_source);
+        MarketDataReplay fresh_replay(fresh);
+        EXPECT_TRUE(fresh_replay.load_from_csv(test_file, 0.01));
+        fresh_replay.replay_until(ts);
+        BookTop top;
+        EXPECT_TRUE(fresh.best_bid_ask(top));
+        return std::make_pair(fresh.book().total_orders(), top.bid_qty + top.ask_qty);
+    };
+    auto current = [&]() {
+        BookTop top;
+        EXPECT_TRUE(engine->best_bid_ask(top));
+        return std::make_pair(engine->book().total_orders(), top.bid_qty + top.ask_qty);
+    };
+    
+    ASSERT_TRUE(replay->load_from_csv(test_file, 0.01));
+    replay->set_checkpoint_interval(100);
+    
+    ASSERT_TRUE(replay->seek(1009990));
+    EXPECT_EQ(replay->position(), 1000);
+    EXPECT_EQ(replay->checkpoint_count(), 10);
+    EXPECT_EQ(current(), book_at(1009990));
+    
+    // Backward seeks restore a checkpoint instead of replaying from the start
+    for (uint64_t ts : {1004555u, 1000005u, 1007000u, 1002345u}) {
+        ASSERT_TRUE(replay->seek(ts));
+        EXPECT_EQ(current(), book_at(ts)) << ts;
+    }
+    EXPECT_EQ(replay->position(), 235);
+    EXPECT_EQ(replay->checkpoint_count(), 10);
+    
+    // Without checkpoints only forward seeks are possible
+    replay->set_checkpoint_interval(0);
+    EXPECT_TRUE(replay->seek(1003000));
+    EXPECT_FALSE(replay->seek(1001000));
+}
+
+TEST(JournalTest, RecordsCommandsAndEventsInOrder) {
+    const std::string path = "/tmp/test_engine_journal.bin";
+    auto journal = std::make_shared<Journal>();
+    JournalConfig jconfig;
+    jconfig.capacity_bytes = 1 << 20;
+    jconfig.commit_interval = std::chrono::microseconds(200);
+    ASSERT_TRUE(journal->open(path, jconfig));
+    
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000);
+    EngineConfig config(1000, 1024, 0.01);
+    MatchingEngine engine(config, time_source);
+    engine.set_journal(journal);
+    
+    ASSERT_TRUE(engine.submit(Order(1, Side::Sell, Price(10050), 100, 1000)));
+    ASSERT_TRUE(engine.submit(Order(2, Side::Buy, Price(10050), 40, 1001)));
+    ASSERT_TRUE(engine.submit(Order(3, Side::Buy, Price(10000), 25, 1002)));
+    ASSERT_TRUE(engine.replace(3, Price(10010), 30));
+    ASSERT_TRUE(engine.cancel(1));
+    EXPECT_FALSE(engine.cancel(99));
+    
+    std::vector<SequencedEvent> events;
+    ASSERT_TRUE(engine.poll_sequenced(events));
+    ASSERT_TRUE(journal->flush());
+    JournalStats stats = journal->stats();
+    EXPECT_EQ(stats.records, 6 + events.size());
+    EXPECT_EQ(stats.durable_bytes, stats.appended_bytes);
+    EXPECT_EQ(stats.dropped, 0);
+    
+    JournalReader reader;
+    ASSERT_TRUE(reader.open(path));
+    JournalRecord record;
+    size_t commands = 0;
+    size_t next_event = 0;
+    while (reader.next(record)) {
+        if (record.kind == JournalKind::Command) {
+            EXPECT_EQ(record.seq, ++commands);
+            continue;
+        }
+        ASSERT_LT(next_event, events.size());
+        EXPECT_EQ(record.seq, events[next_event].seq);
+        EngineEvent decoded;
+        ASSERT_TRUE(record.event(decoded));
+        EXPECT_EQ(decoded.index(), events[next_event].event.index());
+        ++next_event;
+    }
+    EXPECT_EQ(commands, 6);
+    EXPECT_EQ(next_event, events.size());
+    
+    // Replaying the commands rebuilds the same book
+    MatchingEngine rebuilt(config, time_source);
+    reader.rewind();
+    EXPECT_EQ(replay_journal(reader, rebuilt), 5);
+    BookTop original_top, rebuilt_top;
+    ASSERT_TRUE(engine.best_bid_ask(original_top));
+    ASSERT_TRUE(rebuilt.best_bid_ask(rebuilt_top));
+    EXPECT_EQ(rebuilt_top.best_bid, original_top.best_bid);
+    EXPECT_EQ(rebuilt_top.bid_qty, original_top.bid_qty);
+    EXPECT_EQ(rebuilt.book().total_orders(), engine.book().total_orders());
+    
+    journal->close();
+    std::remove(path.c_str());
+}
+
+TEST(JournalTest, FullJournalDropsInsteadOfBlocking) {
+    const std::string path = "/tmp/test_engine_journal_full.bin";
+    Journal journal;
+    JournalConfig jconfig;
+    jconfig.capacity_bytes = 4096;
+    jconfig.commit_interval = std::chrono::microseconds(0);
+    ASSERT_TRUE(journal.open(path, jconfig));
+    
+    // 24 bytes a record, so about 168 fit
+    for (OrderId id = 1; id <= 300; ++id) {
+        journal.append_cancel(id);
+    }
+    JournalStats stats = journal.stats();
+    EXPECT_EQ(stats.records + stats.dropped, 300);
+    EXPECT_GT(stats.dropped, 0);
+    EXPECT_LE(stats.appended_bytes, 4096);
+    EXPECT_EQ(stats.syncs, 0);
+    
+    journal.close();
+    JournalReader reader;
+    ASSERT_TRUE(reader.open(path));
+    JournalRecord record;
+    size_t count = 0;
+    CancelCommand cmd;
+    while (reader.next(record)) {
+        ASSERT_TRUE(record.as(cmd));
+        EXPECT_EQ(cmd.id, ++count);
+    }
+    EXPECT_EQ(count, stats.records);
+    std::remove(path.c_str());
+}
+
+TEST(BookSnapshotTest, ImagePreservesQueueOrder) {
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000);
+    LimitBook book(0.01, time_source);
+    std::vector<TradeEvent> trades;
+    ASSERT_TRUE(book.add(Order(1, Side::Buy, Price(10000), 10, 1), trades));
+    ASSERT_TRUE(book.add(Order(2, Side::Buy, Price(10000), 20, 2), trades));
+    ASSERT_TRUE(book.add(Order(3, Side::Buy, Price(9990), 30, 3), trades));
+    ASSERT_TRUE(book.add(Order(4, Side::Sell, Price(10010), 40, 4), trades));
+    ASSERT_TRUE(book.add(Order(5, Side::Sell, Price(10020), 50, 5), trades));
+    ASSERT_TRUE(book.add(Order(6, Side::Sell, Price(10010), 60, 6), trades));
+    
+    std::vector<char> image;
+    book.save_image(image, 42);
+    
+    LimitBook restored(0.01, time_source);
+    uint64_t next_seq = 0;
+    ASSERT_TRUE(restored.load_image(image.data(), image.size(), &next_seq));
+    EXPECT_EQ(next_seq, 42);
+    EXPECT_EQ(restored.total_orders(), 6);
+    
+    DepthSnapshot before, after;
+    book.get_depth(before, 5);
+    restored.get_depth(after, 5);
+    ASSERT_EQ(after.bids.size(), before.bids.size());
+    ASSERT_EQ(after.asks.size(), before.asks.size());
+    for (size_t i = 0; i < before.asks.size(); ++i) {
+        EXPECT_EQ(after.asks[i].price, before.asks[i].price);
+        EXPECT_EQ(after.asks[i].qty, before.asks[i].qty);
+        EXPECT_EQ(after.asks[i].order_count, before.asks[i].order_count);
+    }
+    
+    // Time priority survives: a sweep fills 4 before 6, and 1 before 2
+    trades.clear();
+    ASSERT_TRUE(restored.add(Order(7, Side::Buy, Price(10010), 100, 7), trades));
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].maker_id, 4);
+    EXPECT_EQ(trades[1].maker_id, 6);
+    trades.clear();
+    ASSERT_TRUE(restored.add(Order(8, Side::Sell, Price(10000), 15, 8), trades));
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].maker_id, 1);
+    EXPECT_EQ(trades[1].maker_id, 2);
+    
+    // The order index came back too
+    CancelEvent cancel;
+    EXPECT_TRUE(restored.cancel(3, cancel));
+    EXPECT_FALSE(restored.cancel(4, cancel));
+}
+
+TEST(BookSnapshotTest, RejectsBadImages) {
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000);
+    LimitBook book(0.01, time_source);
+    std::vector<TradeEvent> trades;
+    ASSERT_TRUE(book.add(Order(1, Side::Buy, Price(10000), 10, 1), trades));
+    ASSERT_TRUE(book.add(Order(2, Side::Sell, Price(10010), 10, 2), trades));
+    std::vector<char> image;
+    book.save_image(image);
+    
+    LimitBook target(0.01, time_source);
+    ASSERT_TRUE(target.add(Order(9, Side::Buy, Price(9000), 5, 1), trades));
+    EXPECT_FALSE(target.load_image(image.data(), image.size() - 1));
+    EXPECT_FALSE(target.load_image(image.data(), 10));
+    
+    std::vector<char> corrupt = image;
+    corrupt[0] = 'X';
+    EXPECT_FALSE(target.load_image(corrupt.data(), corrupt.size()));
+    
+    LimitBook other_tick(0.05, time_source);
+    EXPECT_FALSE(other_tick.load_image(image.data(), image.size()));
+    
+    // Failed loads leave the existing book alone
+    CancelEvent cancel;
+    EXPECT_EQ(target.total_orders(), 1);
+    EXPECT_TRUE(target.cancel(9, cancel));
+}
+
+TEST(BookSnapshotTest, EngineWarmStartResumesSequence) {
+    const std::string path = "/tmp/test_engine_snapshot.bin";
+    auto time_source = std::make_shared<SimulatedTimeSource>(1000);
+    EngineConfig config(1000, 1024, 0.01);
+    MatchingEngine engine(config, time_source);
+    for (OrderId id = 1; id <= 50; ++id) {
+        Side side = id % 2 ? Side::Buy : Side::Sell;
+        Price price = side == Side::Buy ? Price(10000 - id) : Price(10100 + id);
+        ASSERT_TRUE(engine.submit(Order(id, side, price, id * 10, id)));
+    }
+    std::vector<SequencedEvent> events;
+    ASSERT_TRUE(engine.poll_sequenced(events));
+    const uint64_t last_seq = events.back().seq;
+    ASSERT_TRUE(engine.save_snapshot(path));
+    
+    MatchingEngine warm(config, time_source);
+    ASSERT_TRUE(warm.load_snapshot(path));
+    EXPECT_EQ(warm.book().total_orders(), 50);
+    
+    // The restored top of book continues the original event sequence
+    events.clear();
+    ASSERT_TRUE(warm.poll_sequenced(events));
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].seq, last_seq + 1);
+    ASSERT_TRUE(std::holds_alternative<BookTop>(events[0].event));
+    BookTop original, restored = std::get<BookTop>(events[0].event);
+    ASSERT_TRUE(engine.best_bid_ask(original));
+    EXPECT_EQ(restored.best_bid, original.best_bid);
+    EXPECT_EQ(restored.ask_qty, original.ask_qty);
+    
+    EXPECT_FALSE(warm.load_snapshot("/tmp/nonexistent_snapshot.bin"));
+    std::remove(path.c_str());
+}
+
+class EventHashTest : public ::testing::Test {
+protected:
+    // Deterministic mixed flow: resting orders, crosses, replaces, cancels
+    static void run_flow(MatchingEngine& engine, size_t orders, OrderId tweak_id = 0) {
+        for (OrderId id = 1; id <= orders; ++id) {
+            Side side = id % 3 ? Side::Buy : Side::Sell;
+            Price price(10000 + static_cast<int64_t>(id % 7) - 3);
+            uint64_t qty = 10 + id % 5 + (id == tweak_id ? 1 : 0);
+            (void)engine.submit(Order(id, side, price, qty, id));
+            if (id % 11 == 0) {
+                (void)engine.cancel(id - 4);
+            }
+            if (id % 13 == 0) {
+                (void)engine.replace(id - 2, Price(10001), 12);
+            }
+        }
+    }
+    
+    static EngineConfig config() {
+        return EngineConfig(10000, 1 << 16, 0.01);
+    }
+};
+
+TEST_F(EventHashTest, IdenticalRunsHashIdentically) {
+    EventHashConfig hconfig;
+    hconfig.checkpoint_interval = 64;
+    
+    MatchingEngine a(config(), std::make_shared<SimulatedTimeSource>(1000));
+    MatchingEngine b(config(), std::make_shared<SimulatedTimeSource>(1000));
+    a.enable_event_hash(hconfig);
+    b.enable_event_hash(hconfig);
+    run_flow(a, 500);
+    run_flow(b, 500);
+    
+    HashCheckpoint ha = a.event_hash();
+    EXPECT_EQ(ha.seq, a.event_stats().emitted);
+    EXPECT_EQ(ha, b.event_hash());
+    EXPECT_NE(ha.hash, EventHasher::SEED);
+    
+    std::vector<HashCheckpoint> checkpoints = a.hash_checkpoints();
+    ASSERT_EQ(checkpoints.size(), ha.seq / 64);
+    EXPECT_EQ(checkpoints, b.hash_checkpoints());
+    EXPECT_EQ(checkpoints.front().seq, 64);
+    EXPECT_EQ(a.hash_checkpoints(129).front().seq, 192);
+    EXPECT_FALSE(find_divergence(checkpoints, b.hash_checkpoints()).diverged);
+    
+    // Hashing the drained events offline reproduces the engine's value
+    std::vector<SequencedEvent> events;
+    ASSERT_TRUE(a.poll_sequenced(events));
+    EventHasher offline(hconfig);
+    for (const auto& e : events) {
+        offline.update(e.seq, e.event);
+    }
+    EXPECT_EQ(offline.current(), ha);
+}
+
+TEST_F(EventHashTest, DivergenceIsBracketedByCheckpoints) {
+    EventHashConfig hconfig;
+    hconfig.checkpoint_interval = 32;
+    
+    MatchingEngine a(config(), std::make_shared<SimulatedTimeSource>(1000));
+    MatchingEngine b(config(), std::make_shared<SimulatedTimeSource>(1000));
+    a.enable_event_hash(hconfig);
+    b.enable_event_hash(hconfig);
+    run_flow(a, 400);
+    run_flow(b, 400, 250);
+    EXPECT_NE(a.event_hash().hash, b.event_hash().hash);
+    
+    // Find the first differing event the slow way and check it falls in
+    // the window the checkpoints point at
+    std::vector<SequencedEvent> ea, eb;
+    ASSERT_TRUE(a.poll_sequenced(ea));
+    ASSERT_TRUE(b.poll_sequenced(eb));
+    EventHasher ha(hconfig), hb(hconfig);
+    uint64_t first_bad = 0;
+    for (size_t i = 0; i < std::min(ea.size(), eb.size()) && first_bad == 0; ++i) {
+        ha.update(ea[i].seq, ea[i].event);
+        hb.update(eb[i].seq, eb[i].event);
+        if (ha.current() != hb.current()) {
+            first_bad = ea[i].seq;
+        }
+    }
+    ASSERT_NE(first_bad, 0);
+    
+    HashDivergence d = find_divergence(a.hash_checkpoints(), b.hash_checkpoints());
+    ASSERT_TRUE(d.diverged);
+    EXPECT_LT(d.last_match_seq, first_bad);
+    EXPECT_GE(d.first_diff_seq, first_bad);
+    EXPECT_EQ(d.first_diff_seq - d.last_match_seq, 32);
+}
+
+TEST_F(EventHashTest, TimestampsCanBeExcluded) {
+    EventHashConfig hconfig;
+    MatchingEngine a(config(), std::make_shared<SimulatedTimeSource>(1000));
+    MatchingEngine b(config(), std::make_shared<SimulatedTimeSource>(5000));
+    a.enable_event_hash(hconfig);
+    b.enable_event_hash(hconfig);
+    run_flow(a, 100);
+    run_flow(b, 100);
+    EXPECT_NE(a.event_hash(), b.event_hash());
+    
+    hconfig.include_timestamps = false;
+    a.enable_event_hash(hconfig);
+    b.enable_event_hash(hconfig);
+    run_flow(a, 50);
+    run_flow(b, 50);
+    EXPECT_EQ(a.event_hash(), b.event_hash());
+}
+
+enum class TransportKind { Socket, SharedMemory, File };
+
+class ReplicationTest : public ::testing::TestWithParam<TransportKind> {
+protected:
+    void SetUp() override {
+        switch (GetParam()) {
+            case TransportKind::Socket: {
+                std::shared_ptr<UnixSocketTransport> a, b;
+                ASSERT_TRUE(UnixSocketTransport::make_pair(a, b));
+                sender = a;
+                receiver = b;
+                break;
+            }
+            case TransportKind::SharedMemory: {
+                auto a = std::make_shared<SharedMemoryTransport>();
+                auto b = std::make_shared<SharedMemoryTransport>();
+                const std::string name = ipc_name("lob_test_replication");
+                ASSERT_TRUE(a->create(name, 1 << 20));
+                ASSERT_TRUE(b->open(name));
+                sender = a;
+                receiver = b;
+                break;
+            }
+            case TransportKind::File: {
+                auto a = std::make_shared<FileTransport>();
+                auto b = std::make_shared<FileTransport>();
+                ASSERT_TRUE(a->create(file_path));
+                ASSERT_TRUE(b->open(file_path));
+                sender = a;
+                receiver = b;
+                break;
+            }
+        }
+    }
+    
+    void TearDown() override {
+        std::remove(file_path.c_str());
+    }
+    
+    // Mixed flow with the clock moving between (never within) commands
+    static void run_flow(MatchingEngine& engine, SimulatedTimeSource& clock, size_t orders) {
+        for (OrderId id = 1; id <= orders; ++id) {
+            clock.advance(1000 + id % 17);
+            Side side = id % 3 ? Side::Buy : Side::Sell;
+            (void)engine.submit(Order(id, side, Price(10000 + static_cast<int64_t>(id % 9) - 4),
+                                      10 + id % 7, id));
+            if (id % 10 == 0) {
+                clock.advance(500);
+                (void)engine.cancel(id - 3);
+            }
+            if (id % 15 == 0) {
+                clock.advance(700);
+                (void)engine.replace(id - 1, Price(10002), 9);
+            }
+        }
+    }
+    
+    std::string file_path = temp_path(".bin");
+    std::shared_ptr<ReplicationTransport> sender;
+    std::shared_ptr<ReplicationTransport> receiver;
+};
+
+TEST_P(ReplicationTest, ReplicaTracksPrimaryExactly) {
+    EngineConfig config(10000, 1 << 16, 0.01);
+    auto primary_clock = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine primary(config, std::make_shared<LatchedTimeSource>(primary_clock));
+    MatchingEngine replica(config, std::make_shared<SimulatedTimeSource>());
+    primary.enable_event_hash();
+    replica.enable_event_hash();
+    
+    ReplicationConfig rconfig;
+    rconfig.batch_bytes = 2048;
+    auto link = std::make_shared<ReplicationPrimary>(primary, sender, rconfig);
+    primary.set_replication(link);
+    ReplicationReplica follower(replica, receiver);
+    ASSERT_TRUE(follower.ok());
+    
+    run_flow(primary, *primary_clock, 300);
+    ASSERT_TRUE(link->flush());
+    PrimaryStats pstats = link->stats();
+    EXPECT_GT(pstats.frames, 1);
+    EXPECT_EQ(pstats.sent_seq, pstats.commands);
+    EXPECT_EQ(pstats.send_failures, 0);
+    
+    while (follower.stats().applied_seq < pstats.commands) {
+        ASSERT_GT(follower.poll(std::chrono::milliseconds(100)), 0);
+    }
+    ASSERT_TRUE(follower.ok());
+    
+    // Same events, timestamps included, and the last frame's checkpoint
+    // was verified on arrival
+    ReplicaStats rstats = follower.stats();
+    EXPECT_EQ(rstats.frames, pstats.frames);
+    EXPECT_EQ(replica.event_hash(), primary.event_hash());
+    EXPECT_EQ(rstats.verified_seq, primary.event_hash().seq);
+    EXPECT_EQ(rstats.hash_mismatches, 0);
+    EXPECT_EQ(rstats.applied_stamp, primary_clock->now_ns());
+    EXPECT_EQ(replica.hash_checkpoints(), primary.hash_checkpoints());
+    EXPECT_EQ(replica.book().total_orders(), primary.book().total_orders());
+    
+    // Takeover: the replica carries on as a normal engine
+    EXPECT_TRUE(replica.submit(Order(1000, Side::Buy, Price(9000), 1, 0)));
+    EXPECT_EQ(replica.book().total_orders(), primary.book().total_orders() + 1);
+}
+
+INSTANTIATE_TEST_SUITE_P(Transports, ReplicationTest,
+                         ::testing::Values(TransportKind::Socket, TransportKind::SharedMemory,
+                                           TransportKind::File));
+
+TEST(ReplicationBackpressureTest, FullRingDelaysFramesWithoutGaps) {
+    auto a = std::make_shared<SharedMemoryTransport>();
+    auto b = std::make_shared<SharedMemoryTransport>();
+    const std::string name = ipc_name("lob_test_replication_full");
+    ASSERT_TRUE(a->create(name, 4096));
+    ASSERT_TRUE(b->open(name));
+    
+    EngineConfig config(10000, 1 << 16, 0.01);
+    auto primary_clock = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine primary(config, std::make_shared<LatchedTimeSource>(primary_clock));
+    MatchingEngine replica(config, std::make_shared<SimulatedTimeSource>());
+    primary.enable_event_hash();
+    replica.enable_event_hash();
+    
+    ReplicationConfig rconfig;
+    rconfig.batch_bytes = 1024;
+    auto link = std::make_shared<ReplicationPrimary>(primary, a, rconfig);
+    primary.set_replication(link);
+    ReplicationReplica follower(replica, b);
+    
+    // A burst far larger than the 4KB ring, with nobody reading
+    for (OrderId id = 1; id <= 200; ++id) {
+        primary_clock->advance(1000);
+        ASSERT_TRUE(primary.submit(Order(id, id % 2 ? Side::Buy : Side::Sell,
+                                         Price(10000 + static_cast<int64_t>(id % 5) - 2), 10, id)));
+    }
+    EXPECT_FALSE(link->flush());
+    PrimaryStats pstats = link->stats();
+    EXPECT_GT(pstats.send_failures, 0);
+    EXPECT_GT(pstats.pending_frames, 0);
+    EXPECT_LT(pstats.sent_seq, pstats.commands);
+    
+    // As the replica drains the ring, held frames follow in order
+    while (follower.stats().applied_seq < pstats.commands) {
+        ASSERT_GT(follower.poll(std::chrono::milliseconds(100)), 0);
+        (void)link->maybe_flush();
+    }
+    ASSERT_TRUE(follower.ok());
+    EXPECT_TRUE(link->flush());
+    EXPECT_EQ(link->stats().pending_frames, 0);
+    EXPECT_EQ(link->stats().sent_seq, pstats.commands);
+    EXPECT_EQ(replica.event_hash(), primary.event_hash());
+    EXPECT_EQ(follower.stats().hash_mismatches, 0);
+}
+
+TEST(ReplicationBackpressureTest, BatchesShrinkToFitASmallRing) {
+    // The default 16KB batch would never fit a 4KB ring
+    auto a = std::make_shared<SharedMemoryTransport>();
+    auto b = std::make_shared<SharedMemoryTransport>();
+    const std::string name = ipc_name("lob_test_replication_small");
+    ASSERT_TRUE(a->create(name, 4096));
+    ASSERT_TRUE(b->open(name));
+    EXPECT_EQ(a->max_message_size(), 4096 - sizeof(uint32_t));
+    
+    EngineConfig config(10000, 1 << 16, 0.01);
+    auto primary_clock = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine primary(config, std::make_shared<LatchedTimeSource>(primary_clock));
+    MatchingEngine replica(config, std::make_shared<SimulatedTimeSource>());
+    auto link = std::make_shared<ReplicationPrimary>(primary, a);
+    primary.set_replication(link);
+    ReplicationReplica follower(replica, b);
+    
+    for (OrderId id = 1; id <= 500; ++id) {
+        primary_clock->advance(1000);
+        ASSERT_TRUE(primary.submit(Order(id, id % 2 ? Side::Buy : Side::Sell,
+                                         Price(10000 + static_cast<int64_t>(id % 5) - 2), 10, id)));
+    }
+    (void)link->flush();
+    const uint64_t commands = link->stats().commands;
+    while (follower.stats().applied_seq < commands) {
+        ASSERT_GT(follower.poll(std::chrono::milliseconds(100)), 0);
+        (void)link->maybe_flush();
+    }
+    ASSERT_TRUE(follower.ok());
+    EXPECT_EQ(link->stats().pending_frames, 0);
+    EXPECT_EQ(replica.book().total_orders(), primary.book().total_orders());
+}
+
+TEST(ReplicationBackpressureTest, StalledSocketReplicaDoesNotStallMatching) {
+    std::shared_ptr<UnixSocketTransport> a, b;
+    ASSERT_TRUE(UnixSocketTransport::make_pair(a, b));
+    
+    EngineConfig config(100000, 1 << 16, 0.01);
+    auto primary_clock = std::make_shared<SimulatedTimeSource>(1000000);
+    MatchingEngine primary(config, std::make_shared<LatchedTimeSource>(primary_clock));
+    MatchingEngine replica(config, std::make_shared<SimulatedTimeSource>());
+    primary.enable_event_hash();
+    replica.enable_event_hash();
+    auto link = std::make_shared<ReplicationPrimary>(primary, a);
+    primary.set_replication(link);
+    ReplicationReplica follower(replica, b);
+    
+    // Megabytes of flow with nobody reading: far past the socket buffer,
+    // which a blocking send would wait on forever
+    for (OrderId id = 1; id <= 30000; ++id) {
+        primary_clock->advance(1000);
+        ASSERT_TRUE(primary.submit(Order(id, id % 2 ? Side::Buy : Side::Sell,
+                                         Price(10000 + static_cast<int64_t>(id % 5) - 2), 10, id)));
+    }
+    EXPECT_FALSE(link->flush());
+    const PrimaryStats pstats = link->stats();
+    EXPECT_GT(pstats.send_failures, 0);
+    EXPECT_GT(pstats.pending_frames, 0);
+    
+    // Once the replica reads again, the partly written frame is finished
+    // and the rest follow in order
+    while (follower.stats().applied_seq < pstats.commands) {
+        (void)link->maybe_flush();
+        ASSERT_GT(follower.poll(std::chrono::milliseconds(100)), 0);
+    }
+    ASSERT_TRUE(follower.ok());
+    EXPECT_TRUE(link->flush());
+    EXPECT_EQ(replica.event_hash(), primary.event_hash());
+    EXPECT_EQ(follower.stats().hash_mismatches, 0);
+}
+
+TEST(ReplicationMismatchTest, DivergentReplicaIsFlagged) {
+    std::shared_ptr<UnixSocketTransport> a, b;
+    ASSERT_TRUE(UnixSocketTransport::make_pair(a, b));
+    EngineConfig config(1000, 1024, 0.01);
+    MatchingEngine primary(config, std::make_shared<SimulatedTimeSource>(1000));
+    MatchingEngine replica(config, std::make_shared<SimulatedTimeSource>());
+    
+    // Replica starts from a different book
+    ASSERT_TRUE(replica.submit(Order(99, Side::Buy, Price(9000), 5, 1)));
+    primary.enable_event_hash();
+    replica.enable_event_hash();
+    
+    auto link = std::make_shared<ReplicationPrimary>(primary, a);
+    primary.set_replication(link);
+    ReplicationReplica follower(replica, b);
+    ASSERT_TRUE(primary.submit(Order(1, Side::Sell, Price(10000), 10, 2)));
+    ASSERT_TRUE(link->flush());
+    EXPECT_EQ(follower.poll(std::chrono::milliseconds(100)), 1);
+    EXPECT_EQ(follower.stats().hash_mismatches, 1);
+    EXPECT_EQ(follower.stats().first_mismatch_seq, primary.event_hash().seq);
+    
+    // An engine without a simulated clock cannot follow
+    MatchingEngine live(config, std::make_shared<RealTimeSource>());
+    ReplicationReplica bad(live, b);
+    EXPECT_FALSE(bad.ok());
+}
+
+TEST(ReplicationMismatchTest, OversizedLengthPrefixFailsTheTransport) {
+    // A corrupt prefix claiming 4GB must not be trusted
+    const std::string path = temp_path(".bin");
+    {
+        std::ofstream file(path, std::ios::binary);
+        const uint32_t length = 0xFFFFFFF0u;
+        file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        file << "not a frame";
+    }
+    auto reader = std::make_shared<FileTransport>();
+    ASSERT_TRUE(reader->open(path));
+    
+    EngineConfig config(1000, 1024, 0.01);
+    MatchingEngine replica(config, std::make_shared<SimulatedTimeSource>());
+    ReplicationReplica follower(replica, reader);
+    ASSERT_TRUE(follower.ok());
+    EXPECT_EQ(follower.poll(std::chrono::milliseconds(10)), 0);
+    EXPECT_TRUE(reader->failed());
+    EXPECT_FALSE(follower.ok());
+    std::remove(path.c_str());
+    
+#if defined(__linux__)
+    const std::string sock = ipc_name("/tmp/lob_test_replication_prefix") + ".sock";
+    UnixSocketTransport server;
+    ASSERT_TRUE(server.listen(sock));
+    int raw = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(raw, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, sock.c_str(), sizeof(addr.sun_path) - 1);
+    ASSERT_EQ(::connect(raw, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    ASSERT_TRUE(server.accept(std::chrono::milliseconds(1000)));
+    const uint32_t length = static_cast<uint32_t>(REPLICATION_MAX_MESSAGE) + 1;
+    ASSERT_EQ(::write(raw, &length, sizeof(length)), static_cast<ssize_t>(sizeof(length)));
+    std::vector<char> out;
+    EXPECT_FALSE(server.receive(out, std::chrono::milliseconds(1000)));
+    EXPECT_TRUE(server.failed());
+    EXPECT_LT(out.capacity(), length);
+    ::close(raw);
+#endif
+}
+
+TEST(ReplicationMismatchTest, SocketPathConnectsAcrossThreads) {
+    const std::string path = ipc_name("/tmp/lob_test_replication") + ".sock";
+    auto server = std::make_shared<UnixSocketTransport>();
+    ASSERT_TRUE(server->listen(path));
+    std::thread client([&] {
+        UnixSocketTransport conn;
+        ASSERT_TRUE(conn.connect(path));
+        const char msg[] = "batch";
+        EXPECT_TRUE(conn.send(msg, sizeof(msg)));
+    });
+    ASSERT_TRUE(server->accept(std::chrono::milliseconds(1000)));
+    std::vector<char> out;
+    ASSERT_TRUE(server->receive(out, std::chrono::milliseconds(1000)));
+    EXPECT_STREQ(out.data(), "batch");
+    client.join();
+    
+    // Peer closed; nothing more arrives
+    EXPECT_FALSE(server->receive(out, std::chrono::milliseconds(10)));
+}
+
+TEST(SharedEventRingTest, ConsumerSeesEngineStream) {
+    auto ring = std::make_shared<SharedEventRing>();
+    const std::string name = ipc_name("lob_test_event_ring");
+    ASSERT_TRUE(ring->create(name, 1024));
+    SharedEventRing reader;
+    ASSERT_TRUE(reader.open(name));
+    EXPECT_EQ(reader.capacity(), 1024);
+    EXPECT_FALSE(reader.wait(std::chrono::microseconds(100)));
+    
+    EngineConfig config(1000, 1024, 0.01);
+    MatchingEngine engine(config, std::make_shared<SimulatedTimeSource>(1000));
+    engine.set_event_ring(ring);
+    ASSERT_TRUE(engine.submit(Order(1, Side::Sell, Price(10050), 100, 1)));
+    ASSERT_TRUE(engine.submit(Order(2, Side::Buy, Price(10050), 40, 2)));
+    ASSERT_TRUE(engine.cancel(1));
+    
+    std::vector<SequencedEvent> local, shared;
+    ASSERT_TRUE(engine.poll_sequenced(local));
+    ASSERT_TRUE(reader.wait(std::chrono::milliseconds(10)));
+    EXPECT_EQ(reader.size(), local.size());
+    EXPECT_EQ(reader.poll(shared), local.size());
+    for (size_t i = 0; i < local.size(); ++i) {
+        EXPECT_EQ(shared[i].seq, local[i].seq);
+        ASSERT_EQ(shared[i].event.index(), local[i].event.index());
+    }
+    const auto& trade = std::get<TradeEvent>(shared[3].event);
+    EXPECT_EQ(trade.maker_id, 1);
+    EXPECT_EQ(trade.taker_id, 2);
+    EXPECT_EQ(trade.qty, 40);
+    EXPECT_EQ(std::get<CancelEvent>(shared[5].event).remaining, 60);
+    EXPECT_TRUE(reader.empty());
+    EXPECT_EQ(reader.dropped(), 0);
+}
+
+TEST(SharedEventRingTest, FullRingDropsAndLeavesGap) {
+    SharedEventRing ring;
+    const std::string name = ipc_name("lob_test_event_ring_full");
+    ASSERT_TRUE(ring.create(name, 8));
+    SharedEventRing reader;
+    ASSERT_TRUE(reader.open(name));
+    
+    for (uint64_t seq = 1; seq <= 20; ++seq) {
+        (void)ring.push(SequencedEvent(seq, AcceptEvent(seq, seq * 10)));
+    }
+    EXPECT_EQ(reader.dropped(), 12);
+    std::vector<SequencedEvent> out;
+    EXPECT_EQ(reader.poll(out, 3), 3);
+    EXPECT_EQ(out.back().seq, 3);
+    EXPECT_EQ(reader.poll(out), 5);
+    EXPECT_EQ(out.back().seq, 8);
+    
+    // Zero-copy access to what comes next; the gap shows the drops
+    ASSERT_TRUE(ring.push(SequencedEvent(21, AcceptEvent(21, 210))));
+    const SharedEventSlot* slot = reader.front();
+    ASSERT_NE(slot, nullptr);
+    EXPECT_EQ(slot->seq, 21);
+    reader.release();
+    EXPECT_EQ(reader.front(), nullptr);
+}
+
+TEST(SharedEventRingTest, UndecodableSlotIsCountedAsAGap) {
+    SharedEventRing ring;
+    const std::string name = ipc_name("lob_test_event_ring_bad");
+    ASSERT_TRUE(ring.create(name, 8));
+    SharedEventRing reader;
+    ASSERT_TRUE(reader.open(name));
+    
+    for (uint64_t seq = 1; seq <= 4; ++seq) {
+        ASSERT_TRUE(ring.push(SequencedEvent(seq, AcceptEvent(seq, seq * 10))));
+    }
+    SequencedEvent event;
+    ASSERT_TRUE(reader.pop(event));
+    EXPECT_EQ(event.seq, 1);
+    
+    // Damage the next slot in place, as a faulty producer would
+    const_cast<SharedEventSlot*>(reader.front())->type = 200;
+    EXPECT_FALSE(reader.pop(event));
+    EXPECT_EQ(reader.undecodable(), 1);
+    EXPECT_EQ(reader.size(), 2);
+    
+    // Later records still arrive, after a visible gap
+    const_cast<SharedEventSlot*>(reader.front())->type = 201;
+    std::vector<SequencedEvent> out;
+    EXPECT_EQ(reader.poll(out), 1);
+    EXPECT_EQ(out[0].seq, 4);
+    EXPECT_EQ(reader.undecodable(), 2);
+    EXPECT_EQ(reader.dropped(), 0);
+}
+
+#if defined(__linux__)
+TEST(SharedEventRingTest, AnonymousRingCrossesFork) {
+    SharedEventRing ring;
+    ASSERT_TRUE(ring.create_anonymous(256));
+    ASSERT_GE(ring.fd(), 0);
+    
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        SharedEventRing reader;
+        if (!reader.attach(ring.fd())) _exit(2);
+        SequencedEvent event;
+        for (uint64_t expected = 1; expected <= 1000; ++expected) {
+            if (!reader.wait(std::chrono::seconds(5)) || !reader.pop(event)) _exit(3);
+            if (event.seq != expected) _exit(4);
+            if (std::get<AcceptEvent>(event.event).id != expected) _exit(5);
+        }
+        _exit(0);
+    }
+    
+    // Producer retries on full so the child sees an unbroken sequence
+    for (uint64_t seq = 1; seq <= 1000; ++seq) {
+        while (!ring.push(SequencedEvent(seq, AcceptEvent(seq, seq)))) {
+            std::this_thread::yield();
+        }
+    }
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    ASSERT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+#endif
+
+class LevelUpdateTest : public ::testing::Test {
+protected:
+    static EngineConfig config(uint64_t snapshot_interval = 0) {
+        EngineConfig c(10000, 1 << 16, 0.01);
+        c.level_updates = true;
+        c.snapshot_interval = snapshot_interval;
+        return c;
+    }
+    
+    static std::vector<LevelUpdate> level_updates(MatchingEngine& engine) {
+        std::vector<EngineEvent> events;
+        std::vector<LevelUpdate> out;
+        (void)engine.poll_events(events);
+        for (const auto& e : events) {
+            if (const auto* u = std::get_if<LevelUpdate>(&e)) {
+                out.push_back(*u);
+            }
+        }
+        return out;
+    }
+    
+    static void expect_same_depth(const MatchingEngine& engine, const L2Book& book) {
+        DepthSnapshot expected, actual;
+        engine.get_depth(expected, 1000);
+        book.get_depth(actual, 1000);
+        ASSERT_EQ(actual.bids.size(), expected.bids.size());
+        ASSERT_EQ(actual.asks.size(), expected.asks.size());
+        for (size_t i = 0; i < expected.bids.size(); ++i) {
+            EXPECT_EQ(actual.bids[i].price, expected.bids[i].price);
+            EXPECT_EQ(actual.bids[i].qty, expected.bids[i].qty);
+            EXPECT_EQ(actual.bids[i].order_count, expected.bids[i].order_count);
+        }
+        for (size_t i = 0; i < expected.asks.size(); ++i) {
+            EXPECT_EQ(actual.asks[i].price, expected.asks[i].price);
+            EXPECT_EQ(actual.asks[i].qty, expected.asks[i].qty);
+            EXPECT_EQ(actual.asks[i].order_count, expected.asks[i].order_count);
+        }
+    }
+    
+    static void run_flow(MatchingEngine& engine, OrderId first, OrderId last) {
+        for (OrderId id = first; id <= last; ++id) {
+            Side side = id % 2 ? Side::Buy : Side::Sell;
+            int64_t offset = static_cast<int64_t>(id * 7 % 11) - 5;
+            (void)engine.submit(Order(id, side, Price(10000 + offset), 5 + id % 13, id));
+            if (id % 9 == 0) (void)engine.cancel(id - 5);
+            if (id % 14 == 0) (void)engine.replace(id - 3, Price(10000 + offset / 2), 7);
+        }
+    }
+};
+
+TEST_F(LevelUpdateTest, DeltasOnlyCoverChangedLevels) {
+    MatchingEngine engine(config(), std::make_shared<SimulatedTimeSource>(1000));
+    ASSERT_TRUE(engine.submit(Order(1, Side::Sell, Price(10010), 10, 1)));
+    ASSERT_TRUE(engine.submit(Order(2, Side::Sell, Price(10020), 10, 2)));
+    ASSERT_TRUE(engine.submit(Order(3, Side::Sell, Price(10030), 10, 3)));
+    ASSERT_TRUE(engine.submit(Order(4, Side::Buy, Price(9990), 10, 4)));
+    std::vector<LevelUpdate> updates = level_updates(engine);
+    ASSERT_EQ(updates.size(), 4);
+    EXPECT_EQ(updates[3].side, Side::Buy);
+    EXPECT_EQ(updates[3].qty, 10);
+    EXPECT_EQ(updates[3].seq, 4);
+    
+    // Joining a level touches just that level
+    ASSERT_TRUE(engine.submit(Order(5, Side::Sell, Price(10030), 5, 5)));
+    updates = level_updates(engine);
+    ASSERT_EQ(updates.size(), 1);
+    EXPECT_EQ(updates[0].qty, 15);
+    EXPECT_EQ(updates[0].order_count, 2);
+    
+    // A sweep reports each level it consumed, and the remainder resting
+    ASSERT_TRUE(engine.submit(Order(6, Side::Buy, Price(10020), 25, 6)));
+    updates = level_updates(engine);
+    ASSERT_EQ(updates.size(), 3);
+    EXPECT_EQ(updates[0].price, Price(10010));
+    EXPECT_EQ(updates[0].qty, 0);
+    EXPECT_EQ(updates[1].price, Price(10020));
+    EXPECT_EQ(updates[1].qty, 0);
+    EXPECT_EQ(updates[2].side, Side::Buy);
+    EXPECT_EQ(updates[2].price, Price(10020));
+    EXPECT_EQ(updates[2].qty, 5);
+    
+    // Nothing changed, nothing sent
+    EXPECT_FALSE(engine.cancel(42));
+    EXPECT_TRUE(level_updates(engine).empty());
+}
+
+TEST_F(LevelUpdateTest, PartialFillReducesLevelQty) {
+    MatchingEngine engine(config(), std::make_shared<SimulatedTimeSource>(1000));
+    ASSERT_TRUE(engine.submit(Order(1, Side::Sell, Price(10010), 10, 1)));
+    ASSERT_TRUE(engine.submit(Order(2, Side::Sell, Price(10010), 5, 2)));
+    (void)level_updates(engine);
+    
+    // The maker keeps 6 of 10 at the front; the level shrinks from 15 to 11
+    ASSERT_TRUE(engine.submit(Order(3, Side::Buy, Price(10010), 4, 3)));
+    std::vector<LevelUpdate> updates = level_updates(engine);
+    ASSERT_EQ(updates.size(), 1);
+    EXPECT_EQ(updates[0].price, Price(10010));
+    EXPECT_EQ(updates[0].qty, 11);
+    EXPECT_EQ(updates[0].order_count, 2);
+    
+    BookTop top;
+    ASSERT_TRUE(engine.best_bid_ask(top));
+    EXPECT_EQ(top.ask_qty, 11);
+}
+
+TEST_F(LevelUpdateTest, SubscriberBookTracksEngine) {
+    MatchingEngine engine(config(), std::make_shared<SimulatedTimeSource>(1000));
+    L2Book book;
+    for (OrderId chunk = 0; chunk < 10; ++chunk) {
+        run_flow(engine, chunk * 50 + 1, chunk * 50 + 50);
+        for (const auto& update : level_updates(engine)) {
+            ASSERT_TRUE(book.apply(update));
+        }
+        expect_same_depth(engine, book);
+    }
+    EXPECT_TRUE(book.synced());
+}
+
+TEST_F(LevelUpdateTest, LateSubscriberSyncsAtSnapshot) {
+    MatchingEngine engine(config(40), std::make_shared<SimulatedTimeSource>(1000));
+    run_flow(engine, 1, 30);
+    (void)level_updates(engine);   // Missed by the subscriber
+    
+    L2Book book;
+    run_flow(engine, 31, 200);
+    std::vector<LevelUpdate> updates = level_updates(engine);
+    size_t snapshots = 0;
+    for (const auto& update : updates) {
+        (void)book.apply(update);
+        snapshots += update.kind == LevelUpdateKind::SnapshotStart;
+    }
+    EXPECT_GE(snapshots, 3);
+    EXPECT_TRUE(book.synced());
+    expect_same_depth(engine, book);
+    
+    // On-demand snapshot for a brand-new subscriber
+    L2Book fresh;
+    engine.emit_depth_snapshot();
+    updates = level_updates(engine);
+    ASSERT_FALSE(updates.empty());
+    EXPECT_EQ(updates[0].kind, LevelUpdateKind::SnapshotStart);
+    EXPECT_EQ(updates[0].order_count, updates.size() - 1);
+    for (const auto& update : updates) {
+        ASSERT_TRUE(fresh.apply(update));
+    }
+    expect_same_depth(engine, fresh);
+    
+    // A gap leaves the book stale until the next snapshot
+    LevelUpdate skipped = updates.back();
+    skipped.seq += 2;
+    skipped.kind = LevelUpdateKind::Delta;
+    EXPECT_FALSE(fresh.apply(skipped));
+    EXPECT_FALSE(fresh.synced());
+}
+
+class OrderUpdateTest : public ::testing::Test {
+protected:
+    static EngineConfig config() {
+        EngineConfig c(10000, 1 << 16, 0.01);
+        c.order_updates = true;
+        return c;
+    }
+    
+    static std::vector<OrderUpdate> poll(MatchingEngine& engine) {
+        std::vector<OrderUpdate> out;
+        (void)engine.poll_order_updates(out);
+        return out;
+    }
+    
+    static void expect_same_queues(const L3Book& a, const L3Book& b) {
+        ASSERT_EQ(a.order_count(), b.order_count());
+        ASSERT_EQ(a.bids().size(), b.bids().size());
+        ASSERT_EQ(a.asks().size(), b.asks().size());
+        auto same = [](const auto& x, const auto& y) {
+            for (auto i = x.begin(), j = y.begin(); i != x.end(); ++i, ++j) {
+                EXPECT_EQ(i->first, j->first);
+                ASSERT_EQ(i->second.size(), j->second.size());
+                for (size_t k = 0; k < i->second.size(); ++k) {
+                    EXPECT_EQ(i->second[k].id, j->second[k].id);
+                    EXPECT_EQ(i->second[k].qty, j->second[k].qty);
+                }
+            }
+        };
+        same(a.bids(), b.bids());
+        same(a.asks(), b.asks());
+    }
+};
+
+TEST_F(OrderUpdateTest, RecordsQueuePositionsAndFills) {
+    MatchingEngine engine(config(), std::make_shared<SimulatedTimeSource>(1000));
+    ASSERT_TRUE(engine.submit(Order(1, Side::Sell, Price(10010), 10, 1)));
+    ASSERT_TRUE(engine.submit(Order(2, Side::Sell, Price(10010), 5, 2)));
+    std::vector<OrderUpdate> updates = poll(engine);
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].kind, OrderUpdateKind::Add);
+    EXPECT_EQ(updates[1].kind, OrderUpdateKind::Add);
+    EXPECT_EQ(updates[1].id, 2);
+    EXPECT_EQ(updates[1].position, 1);
+    EXPECT_EQ(updates[1].seq, 2);
+    
+    // A replace that rests again is a single Modify, at the back of the queue
+    ASSERT_TRUE(engine.replace(1, Price(10020), 10));
+    updates = poll(engine);
+    ASSERT_EQ(updates.size(), 1);
+    EXPECT_EQ(updates[0].kind, OrderUpdateKind::Modify);
+    EXPECT_EQ(updates[0].price, Price(10020));
+    EXPECT_EQ(updates[0].position, 0);
+    
+    // Fills report the maker at the front of each level
+    ASSERT_TRUE(engine.submit(Order(3, Side::Buy, Price(10020), 8, 3)));
+    updates = poll(engine);
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].kind, OrderUpdateKind::Execute);
+    EXPECT_EQ(updates[0].id, 2);
+    EXPECT_EQ(updates[0].qty, 5);
+    EXPECT_EQ(updates[1].id, 1);
+    EXPECT_EQ(updates[1].qty, 3);
+    
+    ASSERT_TRUE(engine.cancel(1));
+    updates = poll(engine);
+    ASSERT_EQ(updates.size(), 1);
+    EXPECT_EQ(updates[0].kind, OrderUpdateKind::Delete);
+    EXPECT_EQ(updates[0].qty, 7);
+    EXPECT_EQ(updates[0].seq, 6);
+    
+    // A replace that trades goes out as Delete then the fills
+    ASSERT_TRUE(engine.submit(Order(4, Side::Sell, Price(10030), 5, 4)));
+    ASSERT_TRUE(engine.submit(Order(5, Side::Buy, Price(10000), 5, 5)));
+    (void)poll(engine);
+    ASSERT_TRUE(engine.replace(5, Price(10030), 5));
+    updates = poll(engine);
+    ASSERT_EQ(updates.size(), 2);
+    EXPECT_EQ(updates[0].kind, OrderUpdateKind::Delete);
+    EXPECT_EQ(updates[0].id, 5);
+    EXPECT_EQ(updates[1].kind, OrderUpdateKind::Execute);
+    EXPECT_EQ(updates[1].id, 4);
+}
+
+TEST_F(OrderUpdateTest, SubscriberBookTracksQueues) {
+    MatchingEngine engine(config(), std::make_shared<SimulatedTimeSource>(1000));
+    L3Book book;
+    for (OrderId id = 1; id <= 600; ++id) {
+        Side side = id % 2 ? Side::Buy : Side::Sell;
+        int64_t offset = static_cast<int64_t>(id * 7 % 11) - 5;
+        (void)engine.submit(Order(id, side, Price(10000 + offset), 5 + id % 13, id));
+        if (id % 9 == 0) (void)engine.cancel(id - 5);
+        if (id % 14 == 0) (void)engine.replace(id - 3, Price(10000 + offset / 2), 7);
+        for (const auto& update : poll(engine)) {
+            ASSERT_TRUE(book.apply(update)) << "seq " << update.seq;
+        }
+    }
+    EXPECT_TRUE(book.synced());
+    EXPECT_EQ(book.order_count(), engine.book().total_orders());
+    
+    DepthSnapshot expected, actual;
+    engine.get_depth(expected, 1000);
+    book.get_depth(actual, 1000);
+    ASSERT_EQ(actual.bids.size(), expected.bids.size());
+    ASSERT_EQ(actual.asks.size(), expected.asks.size());
+    for (size_t i = 0; i < expected.bids.size(); ++i) {
+        EXPECT_EQ(actual.bids[i].qty, expected.bids[i].qty);
+        EXPECT_EQ(actual.bids[i].order_count, expected.bids[i].order_count);
+    }
+    for (size_t i = 0; i < expected.asks.size(); ++i) {
+        EXPECT_EQ(actual.asks[i].qty, expected.asks[i].qty);
+        EXPECT_EQ(actual.asks[i].order_count, expected.asks[i].order_count);
+    }
+    
+    // A snapshot lists every order in queue order; a fresh subscriber built
+    // from it agrees with the incrementally maintained one
+    L3Book fresh;
+    engine.emit_order_snapshot();
+    std::vector<OrderUpdate> updates = poll(engine);
+    ASSERT_FALSE(updates.empty());
+    EXPECT_EQ(updates[0].kind, OrderUpdateKind::Clear);
+    EXPECT_EQ(updates[0].qty, updates.size() - 1);
+    for (const auto& update : updates) {
+        ASSERT_TRUE(fresh.apply(update));
+        (void)book.apply(update);
+    }
+    expect_same_queues(book, fresh);
+    
+    // A gap leaves the book stale until the next Clear
+    OrderUpdate skipped = updates.back();
+    skipped.seq += 2;
+    EXPECT_FALSE(fresh.apply(skipped));
+    EXPECT_FALSE(fresh.synced());
+}
+
+TEST(JsonWriterTest, EventBodies) {
+    JsonWriter w;
+    TradeEvent trade(7, 3, Price(10050), 25, 1000);
+    write_json(w, EngineEvent(trade), "AAPL");
+    EXPECT_EQ(w.view(), "{\"symbol\":\"AAPL\",\"taker_id\":7,\"maker_id\":3,"
+                        "\"price\":10050,\"qty\":25,\"ts\":1000}");
+    EXPECT_STREQ(json_type(EngineEvent(trade)), "trade");
+    
+    DepthSnapshot depth;
+    depth.bids.emplace_back(Price(100), 5, 1);
+    depth.bids.emplace_back(Price(99), 7, 2);
+    depth.ts = 42;
+    w.clear();
+    write_json(w, depth, "X");
+    EXPECT_EQ(w.view(), "{\"symbol\":\"X\",\"bids\":[{\"price\":100,\"qty\":5,\"orders\":1},"
+                        "{\"price\":99,\"qty\":7,\"orders\":2}],\"asks\":[],\"ts\":42}");
+}
+
+TEST(JsonWriterTest, DecimalPricesAndEscaping) {
+    JsonWriter w;
+    w.set_tick_size(0.01);
+    w.begin_array().value(Price(10050)).value(Price(7)).value(Price(-5)).value(INVALID_PRICE).end_array();
+    EXPECT_EQ(w.view(), "[100.50,0.07,-0.05,null]");
+    
+    w.clear();
+    w.set_tick_size(0.0025);
+    w.begin_array().value(Price(3)).value(Price(400)).end_array();
+    EXPECT_EQ(w.view(), "[0.0075,1.0000]");
+    
+    w.clear();
+    w.begin_object().field("s", std::string_view("a\"b\\c\n")).field("ok", true).end_object();
+    EXPECT_EQ(w.view(), "{\"s\":\"a\\\"b\\\\c\\u000a\",\"ok\":true}");
+}
+
+TEST(JsonWriterTest, ReusesItsBuffer) {
+    JsonWriter w(64);
+    DepthSnapshot depth;
+    for (int i = 0; i < 20; ++i) {
+        depth.asks.emplace_back(Price(100 + i), 1000000 + i, 3);
+    }
+    write_json(w, depth, "SYM");
+    const size_t grown = w.capacity();
+    EXPECT_GE(grown, w.size());
+    const std::string first(w.view());
+    for (int round = 0; round < 100; ++round) {
+        w.clear();
+        write_json(w, depth, "SYM");
+    }
+    EXPECT_EQ(w.capacity(), grown);
+    EXPECT_EQ(w.view(), first);
+}
+
+TEST(MpscRingTest, RefusesWhenFullAndSwapsItems) {
+    MpscRing<std::string> ring(4);
+    EXPECT_EQ(ring.capacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+        std::string item = "m" + std::to_string(i);
+        ASSERT_TRUE(ring.try_push(item));
+        EXPECT_TRUE(item.empty());   // Got the slot's previous (empty) value
+    }
+    std::string extra = "overflow";
+    EXPECT_FALSE(ring.try_push(extra));
+    EXPECT_EQ(extra, "overflow");
+    
+    std::string out = "recycled";
+    ASSERT_TRUE(ring.try_pop(out));
+    EXPECT_EQ(out, "m0");
+    ASSERT_TRUE(ring.try_push(extra));
+    std::string batch[8];
+    EXPECT_EQ(ring.pop_batch(batch, 8), 4);
+    EXPECT_EQ(batch[3], "overflow");
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(MpscRingTest, ProducersKeepTheirOwnOrder) {
+    constexpr uint64_t PRODUCERS = 4;
+    constexpr uint64_t PER_PRODUCER = 20000;
+    MpscRing<uint64_t> ring(256);
+    std::vector<std::thread> producers;
+    for (uint64_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&ring, p] {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                uint64_t item = p << 32 | i;
+                while (!ring.try_push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    std::vector<uint64_t> next(PRODUCERS, 0);
+    uint64_t received = 0;
+    uint64_t item = 0;
+    while (received < PRODUCERS * PER_PRODUCER) {
+        if (!ring.try_pop(item)) {
+            std::this_thread::yield();
+            continue;
+        }
+        uint64_t p = item >> 32;
+        ASSERT_LT(p, PRODUCERS);
+        ASSERT_EQ(item & 0xffffffff, next[p]);
+        ++next[p];
+        ++received;
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    EXPECT_TRUE(ring.empty());
+}
+
+namespace {
+
+class RecordingFeed : public WebSocketFeed {
+public:
+    explicit RecordingFeed(const WebSocketConfig& config) : WebSocketFeed(config) {
+        set_message_callback([this](const WebSocketMessage& msg) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            types_.push_back(msg.type);
+            received_.fetch_add(1, std::memory_order_release);
+        });
+    }
+    
+    bool wait_for(size_t count) {
+        for (int i = 0; i < 2000 && received_.load(std::memory_order_acquire) < count; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return received_.load(std::memory_order_acquire) >= count;
+    }
+    
+    std::vector<std::string> types() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return types_;
+    }
+    
+private:
+    std::mutex mutex_;
+    std::vector<std::string> types_;
+    std::atomic<size_t> received_{0};
+};
+
+} // namespace
+
+TEST(WebSocketFeedTest, BroadcastsPolledBatches) {
+    MatchingEngine engine(EngineConfig(1000, 1024, 0.01));
+    ASSERT_TRUE(engine.submit(Order(1, Side::Sell, Price(100), 10, 1)));
+    ASSERT_TRUE(engine.submit(Order(2, Side::Buy, Price(100), 4, 2)));
+    std::vector<EngineEvent> events;
+    ASSERT_TRUE(engine.poll_events(events));
+    
+    WebSocketConfig config;
+    config.batch_size = 2;
+    RecordingFeed feed(config);
+    ASSERT_TRUE(feed.start());
+    EXPECT_EQ(feed.broadcast_event(events, "SYM"), events.size());
+    ASSERT_TRUE(feed.wait_for(events.size()));
+    feed.stop();
+    
+    std::vector<std::string> types = feed.types();
+    ASSERT_EQ(types.size(), events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        EXPECT_EQ(types[i], json_type(events[i]));
+    }
+    EXPECT_EQ(feed.dropped(), 0);
+}
+
+TEST(WebSocketFeedTest, FullQueueDropsInsteadOfBlocking) {
+    WebSocketConfig config;
+    config.queue_capacity = 4;
+    RecordingFeed feed(config);     // Not started: nothing drains the queue
+    std::vector<EngineEvent> events(10, EngineEvent(AcceptEvent(1, 1)));
+    EXPECT_EQ(feed.broadcast_event(events), 4);
+    EXPECT_EQ(feed.dropped(), 6);
+    EXPECT_FALSE(feed.broadcast_depth(DepthSnapshot()));
+    EXPECT_EQ(feed.dropped(), 7);
+}
+
+TEST(WebSocketServerTest, AcceptKeyMatchesRfcExample) {
+    EXPECT_EQ(websocket_accept_key("dGhlIHNhbXBsZSBub25jZQ=="), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+#if defined(__linux__)
+namespace {
+
+// Blocking loopback client: connects, upgrades, then reads server frames
+int connect_client(uint16_t port, int rcvbuf = 0) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (rcvbuf > 0) {
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+    timeval timeout{5, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool read_exact(int fd, char* out, size_t n) {
+    while (n > 0) {
+        ssize_t got = ::recv(fd, out, n, 0);
+        if (got <= 0) {
+            return false;
+        }
+        out += got;
+        n -= static_cast<size_t>(got);
+    }
+    return true;
+}
+
+// Sends the upgrade request and returns the response headers
+std::string upgrade(int fd) {
+    const std::string request =
+        "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (::send(fd, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+        return "";
+    }
+    std::string response;
+    char c;
+    while (response.find("\r\n\r\n") == std::string::npos && read_exact(fd, &c, 1)) {
+        response.push_back(c);
+    }
+    return response;
+}
+
+// Next text frame's payload; false on a non-text frame or a read error
+bool read_frame(int fd, std::string& payload) {
+    unsigned char header[2];
+    if (!read_exact(fd, reinterpret_cast<char*>(header), 2) || header[0] != 0x81 || (header[1] & 0x80)) {
+        return false;
+    }
+    uint64_t length = header[1] & 0x7f;
+    if (length >= 126) {
+        unsigned char ext[8];
+        const size_t bytes = length == 126 ? 2 : 8;
+        if (!read_exact(fd, reinterpret_cast<char*>(ext), bytes)) {
+            return false;
+        }
+        length = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            length = length << 8 | ext[i];
+        }
+    }
+    payload.resize(length);
+    return read_exact(fd, payload.data(), length);
+}
+
+DepthSnapshot deep_book(size_t levels) {
+    DepthSnapshot depth;
+    for (size_t i = 0; i < levels; ++i) {
+        depth.bids.emplace_back(Price(10000 - int64_t(i)), 100 + i, 1);
+        depth.asks.emplace_back(Price(10001 + int64_t(i)), 100 + i, 1);
+    }
+    return depth;
+}
+
+bool wait_until(const std::function<bool()>& done) {
+    for (int i = 0; i < 5000 && !done(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return done();
+}
+
+} // namespace
+
+TEST(WebSocketServerTest, FansOutToManyLoopbackClients) {
+    MatchingEngine engine(EngineConfig(1000, 1024, 0.01));
+    for (uint64_t i = 1; i <= 20; ++i) {
+        ASSERT_TRUE(engine.submit(Order(i, i % 2 ? Side::Sell : Side::Buy, Price(100), 10, i)));
+    }
+    std::vector<EngineEvent> events;
+    ASSERT_TRUE(engine.poll_events(events));
+    
+    WebSocketConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.max_connections = 256;
+    WebSocketServer server(config);
+    ASSERT_TRUE(server.start());
+    ASSERT_NE(server.port(), 0);
+    
+    std::vector<int> clients;
+    for (int i = 0; i < 200; ++i) {
+        int fd = connect_client(server.port());
+        ASSERT_GE(fd, 0);
+        clients.push_back(fd);
+        std::string response = upgrade(fd);
+        ASSERT_EQ(response.rfind("HTTP/1.1 101", 0), 0u);
+        EXPECT_NE(response.find("s3pPLMBiTxaQ9kYGzzhZRbK+xOo="), std::string::npos);
+    }
+    ASSERT_TRUE(wait_until([&] { return server.stats().clients == 200; }));
+    
+    EXPECT_EQ(server.broadcast_event(events, "SYM"), events.size());
+    for (int fd : clients) {
+        std::string payload;
+        for (const EngineEvent& event : events) {
+            ASSERT_TRUE(read_frame(fd, payload));
+            std::string prefix = "{\"type\":\"" + std::string(json_type(event)) + "\",\"data\":{\"symbol\":\"SYM\"";
+            ASSERT_EQ(payload.rfind(prefix, 0), 0u) << payload;
+        }
+        ::close(fd);
+    }
+    
+    WebSocketServerStats stats = server.stats();
+    EXPECT_EQ(stats.frames, events.size());     // Encoded once, not per client
+    EXPECT_EQ(stats.accepted, 200u);
+    EXPECT_EQ(stats.slow_disconnects, 0u);
+    server.stop();
+    EXPECT_EQ(server.port(), 0);
+}
+
+TEST(WebSocketServerTest, DisconnectsSlowClient) {
+    WebSocketConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.max_client_backlog = 64 << 10;
+    WebSocketServer server(config);
+    ASSERT_TRUE(server.start());
+    
+    int fd = connect_client(server.port(), 4096);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(upgrade(fd).rfind("HTTP/1.1 101", 0), 0u);
+    ASSERT_TRUE(wait_until([&] { return server.stats().clients == 1; }));
+    
+    // The client never reads, so its backlog grows until it is dropped
+    DepthSnapshot depth = deep_book(50);
+    EXPECT_TRUE(wait_until([&] {
+        server.broadcast_depth(depth, "SYM");
+        return server.stats().slow_disconnects == 1;
+    }));
+    EXPECT_EQ(server.stats().clients, 0u);
+    ::close(fd);
+}
+
+TEST(WebSocketServerTest, ConflatesSlowClient) {
+    WebSocketConfig config;
+    config.host = "127.0.0.1";
+    config.port = 0;
+    config.max_client_backlog = 64 << 10;
+    config.slow_client = SlowClientPolicy::Conflate;
+    WebSocketServer server(config);
+    ASSERT_TRUE(server.start());
+    
+    int fd = connect_client(server.port(), 4096);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(upgrade(fd).rfind("HTTP/1.1 101", 0), 0u);
+    ASSERT_TRUE(wait_until([&] { return server.stats().clients == 1; }));
+    
+    DepthSnapshot depth = deep_book(50);
+    ASSERT_TRUE(wait_until([&] {
+        server.broadcast_depth(depth, "SYM");
+        return server.stats().conflated > 0;
+    }));
+    EXPECT_EQ(server.stats().clients, 1u);
+    
+    // Skipped batches are whole frames: the stream stays parseable up to the latest message
+    ASSERT_TRUE(server.broadcast(WebSocketMessage("end", "{}", 0)));
+    std::string payload;
+    do {
+        ASSERT_TRUE(read_frame(fd, payload));
+        ASSERT_EQ(payload.rfind("{\"type\":\"", 0), 0u);
+    } while (payload != "{\"type\":\"end\",\"data\":{}}");
+    EXPECT_EQ(server.stats().slow_disconnects, 0u);
+    ::close(fd);
+}
+#endif
+
+// Test fixture for CPU/NUMA placement
+class PlacementTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        time_source = std::make_shared<SimulatedTimeSource>(1000000);
+        config = EngineConfig(100000, 10000, 0.01);
+    }
+
+    std::shared_ptr<SimulatedTimeSource> time_source;
+    EngineConfig config;
+};
+
+TEST_F(PlacementTest, UnplacedEngineLeavesThreadsAlone) {
+    MatchingEngine engine(config, time_source);
+    EXPECT_EQ(engine.numa_node(), -1);
+    EXPECT_FALSE(engine.pin_thread(ThreadRole::Matcher));
+}
+
+TEST_F(PlacementTest, NumaNodeFollowsMatcherCpu) {
+    config.placement.matcher_cpu = 0;
+    MatchingEngine engine(config, time_source);
+    EXPECT_EQ(engine.numa_node(), numa_node_of_cpu(0));
+    
+    // Engine still works after placed construction
+    Order order(1, Side::Buy, Price::from_double(100.0, 0.01), 10, time_source->now_ns());
+    EXPECT_TRUE(engine.submit(order));
+}
+
+TEST_F(PlacementTest, PinMatcherThread) {
+    config.placement.matcher_cpu = 0;
+    MatchingEngine engine(config, time_source);
+    
+    bool pinned = false;
+    std::thread worker([&] { pinned = engine.pin_thread(ThreadRole::Matcher); });
+    worker.join();
+#ifdef __linux__
+    EXPECT_TRUE(pinned);
+#else
+    EXPECT_FALSE(pinned);
+#endif
+}
+
+TEST_F(PlacementTest, RequireIsolatedRejectsSharedCore) {
+    if (is_isolated_cpu(0)) {
+        GTEST_SKIP() << "cpu0 is isolated on this host";
+    }
+    config.placement.publisher_cpu = 0;
+    config.placement.require_isolated = true;
+    MatchingEngine engine(config, time_source);
+    EXPECT_FALSE(engine.pin_thread(ThreadRole::Publisher));
+}
+
+#ifdef __linux__
+TEST_F(PlacementTest, NumaScopeRestoresPreviousPolicy) {
+    // Stand in for a policy inherited from numactl --interleave
+    unsigned long node0 = 1;
+    if (syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, &node0, sizeof(node0) * 8) != 0) {
+        GTEST_SKIP() << "set_mempolicy unavailable";
+    }
+    {
+        ScopedNumaPolicy scope(0);
+        EXPECT_TRUE(scope.active());
+    }
+    int mode = -1;
+    unsigned long nodes[16] = {};
+    ASSERT_EQ(syscall(SYS_get_mempolicy, &mode, nodes, sizeof(nodes) * 8, nullptr, 0), 0);
+    EXPECT_EQ(mode, MPOL_INTERLEAVE);
+    EXPECT_EQ(nodes[0], 1UL);
+    (void)syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0);
+}
+#endif
+
+TEST_F(PlacementTest, PerSymbolPlacement) {
+    MultiSymbolEngine multi_engine(config, time_source);
+    ThreadPlacement placement;
+    placement.matcher_cpu = 0;
+    placement.numa_node = 0;
+    
+    EXPECT_TRUE(multi_engine.add_symbol("AAPL", placement));
+    EXPECT_TRUE(multi_engine.add_symbol("MSFT"));
+    
+    ASSERT_TRUE(multi_engine.placement("AAPL").has_value());
+    EXPECT_EQ(multi_engine.placement("AAPL")->matcher_cpu, 0);
+    EXPECT_EQ(multi_engine.placement("MSFT")->matcher_cpu, -1);
+    EXPECT_FALSE(multi_engine.placement("GOOG").has_value());
+    
+    // The copy outlives the engine it came from
+    const std::optional<ThreadPlacement> kept = multi_engine.placement("AAPL");
+    ASSERT_TRUE(multi_engine.remove_symbol("AAPL"));
+    ASSERT_TRUE(kept.has_value());
+    EXPECT_EQ(kept->matcher_cpu, 0);
+    EXPECT_FALSE(multi_engine.placement("AAPL").has_value());
+}
+
+// Test fixture for seqlock-published book state
+class PublishedBookTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        time_source = std::make_shared<SimulatedTimeSource>(1000000);
+        config = EngineConfig(100000, 1024, 0.01);
+        config.published_depth = 5;
+        engine = std::make_unique<MatchingEngine>(config, time_source);
+    }
+
+    std::shared_ptr<SimulatedTimeSource> time_source;
+    EngineConfig config;
+    std::unique_ptr<MatchingEngine> engine;
+};
+
+TEST_F(PublishedBookTest, SnapshotMatchesLiveBook) {
+    BookTop top;
+    engine->snapshot_top(top);
+    EXPECT_EQ(top.best_bid, INVALID_PRICE);
+    EXPECT_EQ(engine->snapshot_version(), 0);
+    
+    Order buy(1, Side::Buy, Price::from_double(100.0, 0.01), 50, time_source->now_ns());
+    Order sell(2, Side::Sell, Price::from_double(100.5, 0.01), 60, time_source->now_ns());
+    EXPECT_TRUE(engine->submit(buy));
+    EXPECT_TRUE(engine->submit(sell));
+    
+    engine->snapshot_top(top);
+    EXPECT_EQ(top.best_bid.to_double(0.01), 100.0);
+    EXPECT_EQ(top.bid_qty, 50);
+    EXPECT_EQ(top.best_ask.to_double(0.01), 100.5);
+    EXPECT_EQ(engine->snapshot_version(), 2);
+    
+    FixedDepth depth;
+    engine->snapshot_depth(depth);
+    ASSERT_EQ(depth.bid_levels, 1);
+    ASSERT_EQ(depth.ask_levels, 1);
+    EXPECT_EQ(depth.asks[0].qty, 60);
+    
+    EXPECT_TRUE(engine->cancel(1));
+    engine->snapshot_top(top);
+    EXPECT_EQ(top.best_bid, INVALID_PRICE);
+    engine->snapshot_depth(depth);
+    EXPECT_EQ(depth.bid_levels, 0);
+}
+
+TEST_F(PublishedBookTest, ConcurrentReadersNeverTear) {
+    // Every order's quantity equals its price in ticks, so any consistent
+    // snapshot satisfies bid_qty == best_bid.ticks
+    constexpr int kOrders = 20000;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; r++) {
+        readers.emplace_back([&] {
+            BookTop top;
+            FixedDepth depth;
+            while (!done.load(std::memory_order_relaxed)) {
+                engine->snapshot_top(top);
+                if (top.best_bid != INVALID_PRICE &&
+                    top.bid_qty != static_cast<uint64_t>(top.best_bid.ticks)) {
+                    torn.fetch_add(1);
+                }
+                engine->snapshot_depth(depth);
+                for (uint32_t i = 0; i < depth.bid_levels; i++) {
+                    if (depth.bids[i].qty != static_cast<uint64_t>(depth.bids[i].price.ticks)) {
+                        torn.fetch_add(1);
+                    }
+                }
+            }
+        });
+    }
+    
+    for (int i = 1; i <= kOrders; i++) {
+        int64_t ticks = 10000 + (i % 100);
+        Order buy(i, Side::Buy, Price(ticks), static_cast<uint64_t>(ticks), time_source->now_ns());
+        EXPECT_TRUE(engine->submit(buy));
+        EXPECT_TRUE(engine->cancel(i));
+    }
+    
+    done.store(true);
+    for (auto& t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(torn.load(), 0);
+}
+
+// Test fixture for parallel multi-symbol replay
+class ParallelReplayTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        time_source = std::make_shared<SimulatedTimeSource>(1000000);
+        config = EngineConfig(100000, 10000, 0.01);
+        
+        test_file = temp_path(".csv");
+        std::ofstream file(test_file);
+        file << "timestamp,symbol,action,order_id,side,price,qty,order_type\n";
+        const char* symbols[] = {"AAPL", "MSFT", "GOOG", "AMZN", "TSLA"};
+        uint64_t ts = 1000000;
+        for (int i = 0; i < 200; i++) {
+            const char* sym = symbols[i % 5];
+            int id = i + 1;
+            const char* side = (i / 5) % 2 == 0 ? "BUY" : "SELL";
+            file << ts++ << "," << sym << ",ADD," << id << "," << side << ","
+                 << (100.0 + (i % 7) * 0.01) << "," << (10 + i % 13) << ",LIMIT\n";
+            if (i % 11 == 0) {
+                file << ts++ << "," << sym << ",CANCEL," << id << "," << side << ",0,0,LIMIT\n";
+            }
+        }
+    }
+    
+    void TearDown() override {
+        std::remove(test_file.c_str());
+    }
+    
+    std::vector<ReplayEvent> run(size_t threads, MultiSymbolEngine& multi_engine, size_t& processed) {
+        ParallelReplay replay(multi_engine, threads);
+        EXPECT_TRUE(replay.load_from_csv(test_file, 0.01));
+        std::vector<ReplayEvent> events;
+        processed = replay.replay_all(&events);
+        return events;
+    }
+
+    std::shared_ptr<SimulatedTimeSource> time_source;
+    EngineConfig config;
+    std::string test_file;
+};
+
+TEST_F(ParallelReplayTest, PartitionsBySymbol) {
+    MultiSymbolEngine multi_engine(config, time_source);
+    ParallelReplay replay(multi_engine, 4);
+    ASSERT_TRUE(replay.load_from_csv(test_file, 0.01));
+    
+    EXPECT_EQ(replay.symbol_count(), 5);
+    EXPECT_EQ(replay.message_count(), 219);
+    EXPECT_EQ(replay.symbols().front(), "AAPL");
+    EXPECT_EQ(replay.symbols().back(), "TSLA");
+}
+
+TEST_F(ParallelReplayTest, OutputIsIndependentOfThreadCount) {
+    MultiSymbolEngine serial_engine(config, time_source);
+    MultiSymbolEngine parallel_engine(config, time_source);
+    size_t serial_processed = 0;
+    size_t parallel_processed = 0;
+    
+    auto serial = run(1, serial_engine, serial_processed);
+    auto parallel = run(4, parallel_engine, parallel_processed);
+    
+    EXPECT_GT(serial_processed, 200);
+    EXPECT_EQ(parallel_processed, serial_processed);
+    ASSERT_EQ(parallel.size(), serial.size());
+    for (size_t i = 0; i < serial.size(); i++) {
+        EXPECT_EQ(parallel[i].timestamp, serial[i].timestamp);
+        EXPECT_EQ(parallel[i].symbol_index, serial[i].symbol_index);
+        EXPECT_EQ(parallel[i].event.index(), serial[i].event.index());
+    }
+    
+    // Merged output is ordered by originating timestamp
+    for (size_t i = 1; i < parallel.size(); i++) {
+        EXPECT_LE(parallel[i - 1].timestamp, parallel[i].timestamp);
+    }
+    
+    for (const auto& symbol : serial_engine.get_symbols()) {
+        BookTop a, b;
+        const bool has_top = serial_engine.get_engine(symbol)->best_bid_ask(a);
+        EXPECT_EQ(parallel_engine.get_engine(symbol)->best_bid_ask(b), has_top) << symbol;
+        EXPECT_EQ(a.best_bid, b.best_bid);
+        EXPECT_EQ(a.bid_qty, b.bid_qty);
+        EXPECT_EQ(a.best_ask, b.best_ask);
+        EXPECT_EQ(a.ask_qty, b.ask_qty);
+    }
+}
+
+TEST_F(ParallelReplayTest, MatchesSequentialPerSymbolReplay) {
+    MultiSymbolEngine multi_engine(config, time_source);
+    size_t processed = 0;
+    run(3, multi_engine, processed);
+    
+    // Replaying AAPL alone through the sequential driver gives the same book
+    MatchingEngine single(config, time_source);
+    std::ifstream in(test_file);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.find(",AAPL,") == std::string::npos) continue;
+        std::string plain = line.substr(0, line.find(',')) + line.substr(line.find(",AAPL,") + 5);
+        auto msg = MarketDataReplay::parse_csv_line(plain, 0.01);
+        ASSERT_TRUE(msg.has_value());
+        MarketDataReplay::apply(single, *msg);
+    }
+    
+    BookTop expected, actual;
+    ASSERT_TRUE(single.best_bid_ask(expected));
+    ASSERT_TRUE(multi_engine.get_engine("AAPL")->best_bid_ask(actual));
+    EXPECT_EQ(actual.best_bid, expected.best_bid);
+    EXPECT_EQ(actual.best_ask, expected.best_ask);
+    EXPECT_EQ(multi_engine.get_engine("AAPL")->book().total_orders(), single.book().total_orders());
+}
+
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce) {
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int>> hits(100);
+    std::vector<WorkStealingPool::Task> tasks;
+    for (size_t i = 0; i < hits.size(); i++) {
+        tasks.emplace_back([&hits, i] {
+            // Uneven task sizes give idle workers something to steal
+            if (i % 4 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            hits[i].fetch_add(1);
+        });
+    }
+    pool.run(tasks);
+    for (const auto& h : hits) {
+        EXPECT_EQ(h.load(), 1);
+    }
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -11,6 +11,7 @@ Creates CSV files with realistic order patterns including:
 
 import random
 import argparse
+import sys
 import csv
 from pathlib import Path
 
@@ -238,6 +239,21 @@ class OrderFlowGenerator:
         print(f"Saved {len(orders)} orders to {filename}")
 
 
+def compress_capture(src, dst):
+    """Write a block-compressed copy that the C++ loaders read directly"""
+    sys.path.insert(0, str(Path(__file__).resolve().parent.parent / 'bindings' / 'python'))
+    try:
+        import lobsim
+    except ImportError:
+        print("Error: --compress needs the lobsim module; build the project first")
+        return
+    if lobsim.compress_file(src, dst):
+        print(f"Saved compressed capture to {dst} "
+              f"({Path(dst).stat().st_size} of {Path(src).stat().st_size} bytes)")
+    else:
+        print(f"Error: failed to compress {src}")
+
+
 def main():
     parser = argparse.ArgumentParser(description='Generate synthetic order flow')
     parser.add_argument('-n', '--num-orders', type=int, default=10000,
@@ -258,6 +274,8 @@ def main():
                        help='Percentage of cancels (default: 20.0)')
     parser.add_argument('--replace-pct', type=float, default=5.0,
                        help='Percentage of replaces (default: 5.0)')
+    parser.add_argument('--compress', action='store_true',
+                       help='Also write a block-compressed copy (<output>.lobz); needs lobsim')
     
     args = parser.parse_args()
     
@@ -282,6 +300,9 @@ def main():
     )
     
     generator.save_to_csv(orders, args.output)
+    
+    if args.compress:
+        compress_capture(args.output, args.output + '.lobz')
     print(f"\nGeneration complete!")
 
 